@@ -8,12 +8,20 @@
 #include <iostream>
 #include <fstream>
 #include <iomanip>
+#include <unordered_set>
 
 #include "Constants.hpp"
 #include "Bank.hpp"
 #include "UI.hpp"
 #include "Session.hpp"
 #include "Transaction.hpp"
+#include "TransactionJournal.hpp"
+#include "GroupCommitWriter.hpp"
+#include "TransactionExporter.hpp"
+#include "TransactionHistoryStore.hpp"
+#include "TransactionAggregates.hpp"
+#include "CashCassettes.hpp"
+#include "CashDispenser.hpp"
 
 namespace ATMSystem
 {
@@ -25,25 +33,51 @@ namespace ATMSystem
         LanguageSupport languageSupport;
         std::shared_ptr<Bank> primaryBank;
         std::vector<std::shared_ptr<Bank>> connectedBanks;
-        std::map<int, int> cashInventory; // denomination -> count
+        std::unordered_set<const Bank *> connectedBankSet;
+        CashCassettes cassettes;
+        CashDispenser dispenser;
+        DispensePolicy dispensePolicy = DispensePolicy::MINIMIZE_BILLS;
         std::shared_ptr<Session> currentSession;
-        std::vector<Transaction> transactionHistory;
+        TransactionJournal journal;
+        GroupCommitWriter journalWriter; // after journal: stops before it closes
+        std::shared_ptr<TransactionHistoryStore> historyStore; // shared by every ATM
+        TransactionAggregates aggregates;
         const std::string ADMIN_CARD = "999999999999";
 
-        bool isValidCheck(double amount) const
+        bool isValidCheck(Money amount) const
         {
-            return amount >= MIN_CHECK_AMOUNT;
+            return amount >= Money(MIN_CHECK_AMOUNT);
         }
         UI ui;
 
+        void printHistoryHeader() const;
+        void printHistoryRow(const Transaction &transaction) const;
+        void printAggregates(const std::string &scope, const TransactionAggregates &source) const;
+        // Adds the session record id to the recent history of the accounts it touched
+        void recordInAccounts(TransactionId id, Account &account, Account *counterparty = nullptr) const;
+
     public:
-        ATM(const std::string &serial, BankType type, LanguageSupport lang, std::shared_ptr<Bank> primary);
+        // An account reachable from this ATM, with the primary-bank flag that
+        // drives fee selection.
+        struct ResolvedAccount
+        {
+            std::shared_ptr<Account> account;
+            Bank *bank = nullptr;
+            bool isPrimary = false;
+
+            explicit operator bool() const { return account != nullptr; }
+        };
+
+        ATM(const std::string &serial, BankType type, LanguageSupport lang, std::shared_ptr<Bank> primary,
+            GroupCommitConfig commitConfig = {});
         void addConnectedBank(std::shared_ptr<Bank> bank);
+        void setHistoryStore(std::shared_ptr<TransactionHistoryStore> store) { historyStore = std::move(store); }
+        ResolvedAccount resolveAccount(const std::string &accountNumber) const;
         bool insertCard(const std::string &cardNumber);
         bool validatePin(const std::string &accountNumber, const std::string &pin, int &attempts);
-        bool deposit(const std::string &accountNumber, double amount, bool isCash, int &depositedAmount, int &fee);
-        bool withdraw(const std::string &accountNumber, double amount, int &withdrawnAmount, int &fee, std::map<int, int> &bills);
-        bool transfer(const std::string &fromAccount, const std::string &toAccount, double amount, bool isCashTransfer, int &transferredAmount, int &fee);
+        bool deposit(const std::string &accountNumber, Money amount, bool isCash, Money &depositedAmount, Money &fee);
+        bool withdraw(const std::string &accountNumber, Money amount, Money &withdrawnAmount, Money &fee, std::map<int, int> &bills);
+        bool transfer(const std::string &fromAccount, const std::string &toAccount, Money amount, bool isCashTransfer, Money &transferredAmount, Money &fee);
         void endSession();
 
         void startSession(const std::string &cardNumber, std::shared_ptr<Account> account);
@@ -52,9 +86,15 @@ namespace ATMSystem
         std::shared_ptr<Session> getCurrentSession() const { return currentSession; }
 
         bool addCash(const std::map<int, int> &cash);
-        bool hasSufficientCash(int amount) const;
-        std::map<int, int> getCashBreakdown(int amount) const;
-        void updateCashInventory(double amount);
+        // Restores the cassette counts last recorded in this ATM's journal
+        bool restoreCash();
+        bool hasSufficientCash(Money amount) const;
+        // Exact plan for amount under the dispense policy; empty when none exists
+        std::map<int, int> getCashBreakdown(Money amount) const;
+        // Takes exactly the planned bills out of the cassettes; false if they ran short
+        bool dispenseCash(const std::map<int, int> &bills);
+        void updateCashInventory(Money amount);
+        void setDispensePolicy(DispensePolicy policy) { dispensePolicy = policy; }
         void setLanguage(bool korean)
         {
             ui.setLanguage(korean);
@@ -63,35 +103,47 @@ namespace ATMSystem
         static const int MAX_PIN_ATTEMPTS;
 
         bool isValidCard(const std::string &cardNumber, const std::shared_ptr<Bank> &issuingBank) const;
-        int getTransactionFee(const std::shared_ptr<Bank> &sourceBank,
-                              const std::shared_ptr<Bank> &destBank,
-                              TransactionType type) const;
+        Money getTransactionFee(const std::shared_ptr<Bank> &sourceBank,
+                               const std::shared_ptr<Bank> &destBank,
+                               TransactionType type) const;
 
         std::string getSerialNumber() const { return serialNumber; }
         BankType getBankType() const { return bankType; }
         LanguageSupport getLanguageSupport() const { return languageSupport; }
         std::shared_ptr<Bank> getPrimaryBank() const { return primaryBank; }
+        const std::vector<std::shared_ptr<Bank>> &getConnectedBanks() const { return connectedBanks; }
 
-        bool processCashDeposit(const std::string &accountNumber, int amount,
+        bool processCashDeposit(const std::string &accountNumber, Money amount,
                                 const std::map<int, int> &cashInput,
                                 const std::map<int, int> &feeInput,
-                                int &depositedAmount);
-        bool processCheckDeposit(const std::string &accountNumber, int amount,
+                                Money &depositedAmount);
+        bool processCheckDeposit(const std::string &accountNumber, Money amount,
                                  const std::map<int, int> &feeInput,
-                                 int &depositedAmount);
+                                 Money &depositedAmount);
 
         bool isAdminCard(const std::string &cardNumber) const;
 
-        void addToHistory(const Transaction &transaction)
-        {
-            transactionHistory.push_back(transaction);
-        }
+        // false when the record could not be made durable
+        bool addToHistory(const Transaction &transaction);
+        const TransactionAggregates &getAggregates() const { return aggregates; }
+        const TransactionJournal &getJournal() const { return journal; }
+        GroupCommitWriter::Stats getCommitStats() const { return journalWriter.getStats(); }
 
         void displayAdminMenu(UI &ui);
         void printTransactionHistory() const;
+        // Mini-statement from the account's in-memory ring, oldest first
+        void printRecentTransactions(const Account &account) const;
+        // Prints the network-wide history matching query from the shared store
+        void printHistoryQuery(const HistoryQuery &query) const;
+        // Prints the running totals of this ATM and of the banks it serves
+        void printActivitySummary() const;
         void exportTransactionHistory(const std::string &filename) const;
+        // Streams the journal through a TransactionExporter; rows gets the count written
+        bool exportTransactions(const ExportOptions &options, std::uint64_t &rows) const;
 
-        const std::map<int, int> &getCashInventory() const { return cashInventory; }
+        // denomination -> count as of this call
+        std::map<int, int> getCashInventory() const { return cassettes.toMap(); }
+        const CashCassettes &getCassettes() const { return cassettes; }
     };
 }
 
@@ -2,9 +2,14 @@
 #define ACCOUNT_HPP
 
 #include <string>
-#include <vector>
 #include <memory>
+#include <atomic>
+#include <mutex>
 #include "Transaction.hpp"
+#include "Money.hpp"
+#include "AccountNumber.hpp"
+#include "Constants.hpp"
+#include "TransactionRing.hpp"
 
 namespace ATMSystem
 {
@@ -12,26 +17,60 @@ namespace ATMSystem
 
     class Account
     {
+        friend class Bank;
+
+    public:
+        using HistoryRing = TransactionRing<ACCOUNT_HISTORY_CAPACITY>;
+
+        // Read-only view of the account's recent transactions, oldest first.
+        // It holds the account's history lock; keep it short-lived.
+        class RecentHistory
+        {
+        public:
+            RecentHistory(std::unique_lock<std::mutex> lock, const HistoryRing *ring)
+                : lock(std::move(lock)), ring(ring) {}
+
+            HistoryRing::const_iterator begin() const { return ring ? ring->begin() : HistoryRing::const_iterator(nullptr, 0); }
+            HistoryRing::const_iterator end() const { return ring ? ring->end() : HistoryRing::const_iterator(nullptr, 0); }
+            size_t size() const { return ring ? ring->size() : 0; }
+            bool empty() const { return size() == 0; }
+
+        private:
+            std::unique_lock<std::mutex> lock;
+            const HistoryRing *ring;
+        };
+
     private:
         std::shared_ptr<Bank> bank;
         std::string userName;
         std::string accountNumber;
+        AccountKey key;
         std::string pin;
-        double balance;
-        std::vector<Transaction> transactionHistory;
+        std::atomic<Money> balance; // updated only through compare-and-swap
+        std::mutex transferMutex;   // serializes Bank::transfer only; taken in address order
+        mutable std::mutex historyMutex;
+        std::unique_ptr<HistoryRing> recentTransactions; // allocated on the first record
 
     public:
         Account(std::shared_ptr<Bank> bank, const std::string &user, const std::string &accNum, const std::string &pin);
 
         std::string getPin() const { return pin; }
-        bool deposit(double amount);
-        bool withdraw(double amount);
-        bool transfer(const std::string &toAccount, double amount);
-        double getBalance() const;
-        std::vector<Transaction> getTransactionHistory() const;
+        // Credits and debits are single atomic steps, so concurrent sessions
+        // on different ATMs can never overdraw the account.
+        bool deposit(Money amount);
+        bool withdraw(Money amount);
+        bool transfer(const std::string &toAccount, Money amount);
+        // Takes back a credit (positive) or debit (negative) whose journal
+        // record could not be written. There is no funds check: the credit
+        // may already have been spent by another session.
+        bool undo(Money applied);
+        Money getBalance() const;
+        void recordTransaction(const Transaction &transaction);
+        RecentHistory getRecentTransactions() const;
         std::shared_ptr<Bank> getBank() const { return bank; }
         std::string getUserName() const { return userName; }
         std::string getAccountNumber() const { return accountNumber; }
+        AccountKey getKey() const { return key; }
     };
 }
 
@@ -0,0 +1,60 @@
+#ifndef ACCOUNT_DIRECTORY_HPP
+#define ACCOUNT_DIRECTORY_HPP
+
+#include <string_view>
+#include <memory>
+#include <array>
+#include <shared_mutex>
+#include <unordered_map>
+#include <functional>
+#include "AccountNumber.hpp"
+
+namespace ATMSystem
+{
+    class Bank;
+    class Account;
+
+    // Network-wide index from account number to the account and the bank that
+    // owns it. Banks register accounts as they are created, so resolving a
+    // card or destination account is a single probe however many banks exist.
+    // Entries are sharded by key and never change once registered; the
+    // returned pointers stay valid because map nodes are never moved.
+    class AccountDirectory
+    {
+    public:
+        struct Entry
+        {
+            Bank *bank = nullptr;
+            std::shared_ptr<Account> account;
+        };
+
+        static constexpr size_t SHARD_COUNT = 16;
+
+    private:
+        struct Shard
+        {
+            mutable std::shared_mutex mutex;
+            std::unordered_map<AccountKey, Entry> entries;
+        };
+
+        std::array<Shard, SHARD_COUNT> shards;
+        std::function<bool(AccountKey)> loader;
+
+        Shard &shardFor(AccountKey key) { return shards[accountShardOf<SHARD_COUNT>(key)]; }
+        const Shard &shardFor(AccountKey key) const { return shards[accountShardOf<SHARD_COUNT>(key)]; }
+        const Entry *probe(AccountKey key) const;
+
+    public:
+        bool registerAccount(AccountKey key, Bank *bank, std::shared_ptr<Account> account);
+        const Entry *find(AccountKey key) const;
+        const Entry *find(std::string_view accountNumber) const;
+        size_t size() const;
+        void reserve(size_t count);
+        // Called on a miss to load an account that exists but is not indexed
+        // yet; it returns true once the account has been registered. Set it
+        // before lookups start.
+        void setLoader(std::function<bool(AccountKey)> accountLoader) { loader = std::move(accountLoader); }
+    };
+}
+
+#endif
@@ -0,0 +1,82 @@
+#ifndef ACCOUNT_NUMBER_HPP
+#define ACCOUNT_NUMBER_HPP
+
+#include <string>
+#include <string_view>
+#include <optional>
+#include <cstdint>
+
+namespace ATMSystem
+{
+    // 12-digit account numbers packed into an integer key
+    using AccountKey = std::uint64_t;
+
+    constexpr size_t ACCOUNT_NUMBER_LENGTH = 12;
+    constexpr AccountKey MAX_ACCOUNT_KEY = 999999999999ULL;
+    constexpr AccountKey NO_ACCOUNT_KEY = ~AccountKey(0);
+
+    constexpr std::optional<AccountKey> parseAccountNumber(std::string_view accountNumber)
+    {
+        if (accountNumber.size() != ACCOUNT_NUMBER_LENGTH)
+        {
+            return std::nullopt;
+        }
+        AccountKey key = 0;
+        for (char digit : accountNumber)
+        {
+            if (digit < '0' || digit > '9')
+            {
+                return std::nullopt;
+            }
+            key = key * 10 + static_cast<AccountKey>(digit - '0');
+        }
+        return key;
+    }
+
+    // splitmix64 finalizer; account numbers are not uniformly spread
+    constexpr std::uint64_t mixAccountKey(AccountKey key)
+    {
+        key ^= key >> 30;
+        key *= 0xbf58476d1ce4e5b9ULL;
+        key ^= key >> 27;
+        key *= 0x94d049bb133111ebULL;
+        key ^= key >> 31;
+        return key;
+    }
+
+    // Shard selection uses the top bits of the mixed key; hash tables inside
+    // a shard index with the low bits, so the two stay independent.
+    template <size_t ShardCount>
+    constexpr size_t accountShardOf(AccountKey key)
+    {
+        static_assert(ShardCount > 0 && (ShardCount & (ShardCount - 1)) == 0, "shard count must be a power of two");
+        if constexpr (ShardCount == 1)
+        {
+            return 0;
+        }
+        else
+        {
+            constexpr int SHIFT = 64 - __builtin_ctzll(ShardCount);
+            return static_cast<size_t>(mixAccountKey(key) >> SHIFT);
+        }
+    }
+
+    // Writes the zero-padded digits of key into out[0..12)
+    inline void writeAccountNumber(AccountKey key, char *out)
+    {
+        for (size_t i = ACCOUNT_NUMBER_LENGTH; i > 0; i--)
+        {
+            out[i - 1] = static_cast<char>('0' + key % 10);
+            key /= 10;
+        }
+    }
+
+    inline std::string formatAccountNumber(AccountKey key)
+    {
+        std::string accountNumber(ACCOUNT_NUMBER_LENGTH, '0');
+        writeAccountNumber(key, accountNumber.data());
+        return accountNumber;
+    }
+}
+
+#endif
@@ -0,0 +1,50 @@
+#ifndef ACCOUNT_TABLE_HPP
+#define ACCOUNT_TABLE_HPP
+
+#include <vector>
+#include <memory>
+#include <cstdint>
+#include "AccountNumber.hpp"
+
+namespace ATMSystem
+{
+    class Account;
+
+    // Open-addressing hash table from packed account keys to accounts.
+    // Accounts are kept densely in creation order; the probe array only holds
+    // (key, index) pairs, so a lookup touches one or two cache lines.
+    class AccountTable
+    {
+    private:
+        struct Slot
+        {
+            AccountKey key;
+            std::uint32_t index;
+        };
+
+        static constexpr AccountKey EMPTY_KEY = ~AccountKey(0);
+
+        std::vector<Slot> slots; // power-of-two size, linear probing
+        std::vector<std::shared_ptr<Account>> accounts;
+
+        static size_t hash(AccountKey key)
+        {
+            return static_cast<size_t>(mixAccountKey(key));
+        }
+
+        void rehash(size_t slotCount);
+
+    public:
+        AccountTable() = default;
+
+        void reserve(size_t count);
+        bool insert(AccountKey key, std::shared_ptr<Account> account);
+        const std::shared_ptr<Account> *find(AccountKey key) const;
+
+        size_t size() const { return accounts.size(); }
+        bool empty() const { return accounts.empty(); }
+        const std::vector<std::shared_ptr<Account>> &values() const { return accounts; }
+    };
+}
+
+#endif
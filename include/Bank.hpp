@@ -2,40 +2,187 @@
 #define BANK_HPP
 
 #include <string>
+#include <string_view>
 #include <vector>
 #include <memory>
 #include <map>
+#include <unordered_map>
+#include <array>
+#include <mutex>
+#include <shared_mutex>
+#include <atomic>
+#include <cstdint>
 #include "Account.hpp"
+#include "AccountDirectory.hpp"
+#include "AccountNumber.hpp"
+#include "AccountTable.hpp"
+#include "TransactionAggregates.hpp"
+#include "SystemImage.hpp"
 
 namespace ATMSystem
 {
+    enum class TransferStatus
+    {
+        SUCCESS,
+        INSUFFICIENT_FUNDS,
+        INVALID_AMOUNT,
+        CREDIT_REJECTED,
+        // the credit was rejected and the debit could not be given back
+        COMPENSATION_FAILED
+    };
+
+    enum class ReplayStatus
+    {
+        APPLIED,
+        NOT_OWNED,     // neither account belongs to this bank
+        INVALID_RECORD // amounts or a resulting balance out of range
+    };
+
+    // One account of a bulk load
+    struct AccountSpec
+    {
+        std::string userName;
+        std::string accountNumber;
+        std::string pin;
+        Money openingBalance;
+    };
+
     class Bank : public std::enable_shared_from_this<Bank>
     {
+    public:
+        static constexpr size_t ACCOUNT_SHARD_COUNT = 16;
+
     private:
+        // Accounts are split across shards by key; readers take a shard's
+        // lock shared, so lookups only wait while that shard is being written.
+        struct AccountShard
+        {
+            mutable std::shared_mutex mutex;
+            AccountTable accounts;
+        };
+
         std::string name;
-        std::map<std::string, std::shared_ptr<Account>> accounts;
-        std::map<std::string, std::vector<std::string>> userAccounts;
+        std::uint32_t id; // compact bank reference for transaction records
+        // accounts of an attached image are created on first lookup, which
+        // may come through a const accessor
+        mutable std::array<AccountShard, ACCOUNT_SHARD_COUNT> shards;
+        mutable std::mutex userAccountsMutex;
+        mutable std::unordered_map<std::string, std::vector<std::string>> userAccounts;
+        std::shared_ptr<AccountDirectory> directory;
+        TransactionAggregates aggregates; // activity of this bank's cards
+
+        std::shared_ptr<const SystemImage> image;
+        std::uint32_t imageBank = 0;
+        mutable std::atomic<bool> imageLoaded{true}; // every image account materialized
+        mutable std::mutex imageMutex;
+
+        AccountShard &shardFor(AccountKey key) { return shards[accountShardOf<ACCOUNT_SHARD_COUNT>(key)]; }
+        const AccountShard &shardFor(AccountKey key) const { return shards[accountShardOf<ACCOUNT_SHARD_COUNT>(key)]; }
+
+        // False, leaving the balance alone, when it would overflow
+        static bool adjustBalance(Account &account, Money delta);
+
+        bool inImage(AccountKey key) const;
+        bool numberInUse(AccountKey key) const;
+        std::shared_ptr<Account> loadFromImage(const SystemImage::AccountRecord &record) const;
+        std::shared_ptr<Account> materialize(AccountKey key) const;
+        void materializeAll() const;
+        void ensureMaterialized() const
+        {
+            if (!imageLoaded.load(std::memory_order_acquire))
+            {
+                materializeAll();
+            }
+        }
 
     public:
-        explicit Bank(const std::string &bankName);
+        explicit Bank(const std::string &bankName, std::shared_ptr<AccountDirectory> accountDirectory = nullptr);
 
         // Account management
         bool createAccount(const std::string &userName, const std::string &accountNumber,
                            const std::string &pin);
-        std::shared_ptr<Account> getAccount(const std::string &accountNumber);
+        // Creates a batch of accounts taking each shard lock once. Returns
+        // how many were created; invalid or duplicate entries are skipped.
+        size_t createAccounts(const std::vector<AccountSpec> &batch);
+        // Serves this bank's accounts from slice index of a system image;
+        // each is materialized when first looked up or enumerated
+        void attachImage(std::shared_ptr<const SystemImage> systemImage, std::uint32_t index);
+        std::shared_ptr<Account> getAccount(std::string_view accountNumber) const;
+        std::shared_ptr<Account> getAccount(AccountKey key) const;
+        void reserveAccounts(size_t count);
+        size_t getAccountCount() const;
         std::vector<std::string> getUserAccounts(const std::string &userName);
 
+        // Moves funds between two accounts of any banks: debit is taken from
+        // source, then credit given to destination. Transfers touching either
+        // account are serialized by locking both in address order, so
+        // opposing transfers cannot deadlock. Deposits, withdrawals and
+        // balance reads do not take these locks; they may see the debit
+        // before the credit, or a rejected credit's debit before it is
+        // given back.
+        static TransferStatus transfer(Account &source, Account &destination, Money debit, Money credit);
+
+        // Recovery: balances are set or adjusted directly, without the funds
+        // check, since the journal already holds the outcome. replayTransaction
+        // applies only the side of a record that belongs to this bank, so
+        // different banks can replay the same journal in parallel.
+        bool restoreBalance(AccountKey key, Money balance);
+        ReplayStatus replayTransaction(const Transaction &transaction);
+
         // Getters
         std::string getName() const { return name; }
-        bool verifyPIN(const std::string &accountNumber, const std::string &pin);
-        std::vector<std::shared_ptr<Account>> getAllAccounts() const
+        std::uint32_t getId() const { return id; }
+        TransactionAggregates &getAggregates() { return aggregates; }
+        const TransactionAggregates &getAggregates() const { return aggregates; }
+        const std::shared_ptr<AccountDirectory> &getAccountDirectory() const { return directory; }
+        bool verifyPIN(std::string_view accountNumber, const std::string &pin) const;
+        std::vector<std::shared_ptr<Account>> getAllAccounts() const;
+
+        // Position in the shard-by-shard account order. Shards only append,
+        // so a cursor stays valid while accounts are being created.
+        struct AccountCursor
+        {
+            size_t shard = 0;
+            size_t index = 0;
+        };
+
+        // Visits accounts from cursor on, holding one shard's read lock at a
+        // time. Stops before the first account fn returns false for and leaves
+        // cursor on it; returns true once every account has been visited.
+        template <typename Fn>
+        bool visitAccounts(AccountCursor &cursor, Fn &&fn) const
+        {
+            ensureMaterialized();
+            for (; cursor.shard < ACCOUNT_SHARD_COUNT; cursor.shard++, cursor.index = 0)
+            {
+                const auto &shard = shards[cursor.shard];
+                std::shared_lock<std::shared_mutex> lock(shard.mutex);
+                const auto &accounts = shard.accounts.values();
+                for (; cursor.index < accounts.size(); cursor.index++)
+                {
+                    if (!fn(accounts[cursor.index]))
+                    {
+                        return false;
+                    }
+                }
+            }
+            return true;
+        }
+
+        // Visits every account shard by shard while holding that shard's
+        // read lock; fn must not create accounts in this bank.
+        template <typename Fn>
+        void forEachAccount(Fn &&fn) const
         {
-            std::vector<std::shared_ptr<Account>> allAccounts;
-            for (const auto &[_, account] : accounts)
+            ensureMaterialized();
+            for (const auto &shard : shards)
             {
-                allAccounts.push_back(account);
+                std::shared_lock<std::shared_mutex> lock(shard.mutex);
+                for (const auto &account : shard.accounts.values())
+                {
+                    fn(account);
+                }
             }
-            return allAccounts;
         }
     };
 }
@@ -0,0 +1,58 @@
+#ifndef CASH_CASSETTES_HPP
+#define CASH_CASSETTES_HPP
+
+#include <array>
+#include <atomic>
+#include <map>
+#include <optional>
+#include <cstdint>
+#include "Constants.hpp"
+#include "Money.hpp"
+
+namespace ATMSystem
+{
+    // An ATM's bill cassettes: one atomic counter per CASH_DENOMINATIONS slot
+    // and a running total in won. Availability checks read the total, and
+    // adding or taking bills touches only the slots involved, so snapshot
+    // readers never wait on the dispensing path. Readers may briefly see the
+    // total and the slots one update apart.
+    class CashCassettes
+    {
+    public:
+        static constexpr size_t SLOT_COUNT = CASH_DENOMINATIONS.size();
+        using Counts = std::array<int, SLOT_COUNT>;
+
+        static constexpr std::optional<size_t> slotOf(int denomination)
+        {
+            for (size_t slot = 0; slot < SLOT_COUNT; slot++)
+            {
+                if (CASH_DENOMINATIONS[slot] == denomination)
+                {
+                    return slot;
+                }
+            }
+            return std::nullopt;
+        }
+
+        // Adds every bill, or none when a denomination or count is invalid
+        bool add(const std::map<int, int> &bills);
+        // Takes every bill, or none when a cassette runs short
+        bool take(const std::map<int, int> &bills);
+        // Replaces the contents, e.g. with counts recovered from a journal
+        bool restore(const std::map<int, int> &bills);
+
+        Money getTotal() const { return Money(totalWon.load(std::memory_order_acquire)); }
+        int getCount(size_t slot) const { return counts[slot].load(std::memory_order_acquire); }
+        Counts getCounts() const;
+        // denomination -> count for reports and the journal header
+        std::map<int, int> toMap() const;
+
+    private:
+        std::array<std::atomic<int>, SLOT_COUNT> counts{};
+        std::atomic<std::int64_t> totalWon{0};
+
+        static bool isValid(const std::map<int, int> &bills);
+    };
+}
+
+#endif
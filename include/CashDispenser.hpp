@@ -0,0 +1,70 @@
+#ifndef CASH_DISPENSER_HPP
+#define CASH_DISPENSER_HPP
+
+#include <map>
+#include <mutex>
+#include <vector>
+#include <cstdint>
+#include "CashCassettes.hpp"
+#include "Money.hpp"
+
+namespace ATMSystem
+{
+    enum class DispensePolicy : std::uint8_t
+    {
+        MINIMIZE_BILLS,  // fewest bills overall
+        PRESERVE_SCARCE, // draw on the fullest cassettes, sparing low ones
+    };
+
+    // Plans withdrawals as exact bounded change-making over the cassette
+    // counts. Each denomination's available bills are split into power-of-two
+    // lots and a 0/1 knapsack (in units of the smallest common bill) finds the
+    // cheapest exact combination under the policy, so a plan is found
+    // whenever one exists. The knapsack table covers every amount up to the
+    // per-transaction withdrawal limit and is built once per cassette state
+    // and policy; a plan for an unchanged state only walks it back.
+    class CashDispenser
+    {
+    public:
+        // amounts up to this are answered from the precomputed table
+        static constexpr std::int64_t TABLE_LIMIT_WON = MAX_WITHDRAWAL_PER_TRANSACTION;
+
+        CashDispenser();
+
+        // Bills to hand out for amount from the given cassette counts, or an
+        // empty map when they cannot make it exactly
+        std::map<int, int> plan(Money amount, const CashCassettes::Counts &counts, DispensePolicy policy) const;
+
+        std::int64_t getUnit() const { return unit; }
+
+    private:
+        // a run of bills of one denomination taken together in the knapsack
+        struct Lot
+        {
+            int denomination;
+            int bills;
+            std::int64_t units;
+            std::int64_t cost;
+        };
+
+        struct Table
+        {
+            bool built = false;
+            CashCassettes::Counts counts{};
+            DispensePolicy policy = DispensePolicy::MINIMIZE_BILLS;
+            std::int64_t capacity = 0; // largest amount covered, in units
+            std::vector<Lot> lots;
+            std::vector<std::int64_t> best;
+            std::vector<std::uint8_t> taken; // lots.size() rows of capacity + 1
+        };
+
+        std::int64_t unit = 1; // greatest common divisor of CASH_DENOMINATIONS
+        mutable std::mutex tableMutex;
+        mutable Table table;
+
+        void build(Table &target, const CashCassettes::Counts &counts, DispensePolicy policy, std::int64_t capacity) const;
+        static std::map<int, int> walkBack(const Table &source, std::int64_t amount);
+    };
+}
+
+#endif
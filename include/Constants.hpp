@@ -1,12 +1,17 @@
 #ifndef CONSTANTS_HPP
 #define CONSTANTS_HPP
 
+#include <array>
 #include <string>
 #include <map>
+#include <cstdint>
+#include "Money.hpp"
 
 namespace ATMSystem
 {
     const std::string ADMIN_CARD = "999999999999";
+    // ATM serial numbers are fixed-width decimal strings
+    constexpr size_t ATM_SERIAL_LENGTH = 6;
     enum class BankType
     {
         SINGLE_BANK,
@@ -19,7 +24,7 @@ namespace ATMSystem
         BILINGUAL
     };
 
-    enum class TransactionType
+    enum class TransactionType : std::uint8_t
     {
         DEPOSIT,
         WITHDRAWAL,
@@ -27,25 +32,36 @@ namespace ATMSystem
         TRANSFER_ACCOUNT
     };
 
+    // how the funds entered or left the ATM
+    enum class TransactionChannel : std::uint8_t
+    {
+        CASH,
+        CHECK,
+        ACCOUNT
+    };
+
     struct TransactionFees
     {
         // Deposit fees
-        static const int DEPOSIT_PRIMARY = 1000;     // Primary bank deposit
-        static const int DEPOSIT_NON_PRIMARY = 2000; // Non-primary bank deposit
+        static constexpr Money DEPOSIT_PRIMARY{1000};     // Primary bank deposit
+        static constexpr Money DEPOSIT_NON_PRIMARY{2000}; // Non-primary bank deposit
 
         // Withdrawal fees
-        static const int WITHDRAWAL_PRIMARY = 1000;     // Primary bank withdrawal
-        static const int WITHDRAWAL_NON_PRIMARY = 2000; // Non-primary bank withdrawal
+        static constexpr Money WITHDRAWAL_PRIMARY{1000};     // Primary bank withdrawal
+        static constexpr Money WITHDRAWAL_NON_PRIMARY{2000}; // Non-primary bank withdrawal
 
         // Account transfer fees
-        static const int TRANSFER_PRIMARY = 2000;     // Between primary bank accounts
-        static const int TRANSFER_MIXED = 3000;       // Between primary and non-primary
-        static const int TRANSFER_NON_PRIMARY = 4000; // Between non-primary banks
+        static constexpr Money TRANSFER_PRIMARY{2000};     // Between primary bank accounts
+        static constexpr Money TRANSFER_MIXED{3000};       // Between primary and non-primary
+        static constexpr Money TRANSFER_NON_PRIMARY{4000}; // Between non-primary banks
 
         // Cash transfer fee
-        static const int TRANSFER_CASH = 1000; // Cash transfer to any bank
+        static constexpr Money TRANSFER_CASH{1000}; // Cash transfer to any bank
     };
 
+    // one cassette slot per bill, ascending; matches VALID_DENOMINATIONS
+    constexpr std::array<int, 4> CASH_DENOMINATIONS = {1000, 5000, 10000, 50000};
+
     const std::map<int, int> VALID_DENOMINATIONS = {
         {1000, 0},
         {5000, 0},
@@ -57,6 +73,11 @@ namespace ATMSystem
     const int MAX_CHECK_INSERT = 50;
     const int MAX_WITHDRAWAL_PER_TRANSACTION = 500000;
     const int MAX_WITHDRAWALS_PER_SESSION = 3;
+    // transactions each account keeps for mini-statements; older ones stay in the journals
+    constexpr size_t ACCOUNT_HISTORY_CAPACITY = 10;
+
+    // where each ATM keeps its transaction journal segments
+    const std::string JOURNAL_DIRECTORY = "journal";
 }
 
 #endif
\ No newline at end of file
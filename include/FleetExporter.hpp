@@ -0,0 +1,37 @@
+#ifndef FLEET_EXPORTER_HPP
+#define FLEET_EXPORTER_HPP
+
+#include <memory>
+#include <vector>
+#include <cstdint>
+#include "ATM.hpp"
+#include "TransactionExporter.hpp"
+
+namespace ATMSystem
+{
+    // Exports the history of every ATM as one file ordered by timestamp.
+    // One producer thread per ATM reads that ATM's journal segments and
+    // hands records over in fixed-size chunks; the calling thread merges the
+    // streams with a k-way heap merge and feeds a TransactionExporter.
+    // A journal is in commit order, which can trail timestamp order a
+    // little, so each producer sorts its records through a window of
+    // REORDER_WINDOW records. A record further out of place fails the export
+    // rather than leaving the file unordered.
+    class FleetExporter
+    {
+    public:
+        static constexpr size_t CHUNK_RECORDS = 4096;
+        static constexpr size_t CHUNKS_PER_PRODUCER = 4; // bounds memory per ATM
+        static constexpr size_t REORDER_WINDOW = 1024;
+
+        explicit FleetExporter(const std::vector<std::shared_ptr<ATM>> &atms)
+            : atms(atms) {}
+
+        bool exportHistory(const ExportOptions &options, std::uint64_t &rows) const;
+
+    private:
+        const std::vector<std::shared_ptr<ATM>> &atms;
+    };
+}
+
+#endif
@@ -0,0 +1,117 @@
+#ifndef GROUP_COMMIT_WRITER_HPP
+#define GROUP_COMMIT_WRITER_HPP
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "Transaction.hpp"
+#include "TransactionJournal.hpp"
+
+namespace ATMSystem
+{
+    struct GroupCommitConfig
+    {
+        size_t maxBatch = 64;                     // records per fdatasync
+        std::chrono::microseconds maxLinger{200}; // wait for a submit under way
+    };
+
+    // Makes journal appends durable with group commit. Sessions push records
+    // into a bounded lock-free queue and wait on their ticket; one writer
+    // thread drains up to maxBatch records, appends them to the journal and
+    // flushes them with a single fdatasync, then wakes every waiter of the
+    // batch. Records queued during one fdatasync form the next batch. The
+    // writer lingers, up to maxLinger, only for a submit already under way,
+    // so a lone session pays no delay on top of its fdatasync.
+    class GroupCommitWriter
+    {
+    public:
+        using Config = GroupCommitConfig;
+
+        struct Stats
+        {
+            std::uint64_t commits = 0;
+            std::uint64_t batches = 0;
+            double commitsPerSecond = 0.0;
+        };
+
+        explicit GroupCommitWriter(TransactionJournal &journal, Config config = {});
+        ~GroupCommitWriter();
+
+        GroupCommitWriter(const GroupCommitWriter &) = delete;
+        GroupCommitWriter &operator=(const GroupCommitWriter &) = delete;
+
+        // Queues a record and returns its ticket; blocks only while the
+        // queue is full.
+        std::uint64_t submit(const Transaction &transaction);
+        // Blocks until the batch holding ticket has been written; false if
+        // writing that batch failed. position, if given, receives where the
+        // record went. Each ticket must be waited on exactly once, since
+        // that frees its queue cell.
+        bool waitDurable(std::uint64_t ticket, JournalPosition *position = nullptr);
+        bool commit(const Transaction &transaction, JournalPosition *position = nullptr)
+        {
+            return waitDurable(submit(transaction), position);
+        }
+
+        Stats getStats() const;
+        const Config &getConfig() const { return config; }
+
+    private:
+        static constexpr size_t QUEUE_CAPACITY = 1024; // power of two
+
+        // bounded MPSC ring; a cell's sequence says whose turn it is. The
+        // writer leaves a cell's record position for its waiter, who then
+        // hands the cell back to producers.
+        struct Cell
+        {
+            std::atomic<std::uint64_t> sequence;
+            Transaction transaction;
+            JournalPosition position;
+        };
+
+        TransactionJournal &journal;
+        Config config;
+
+        std::array<Cell, QUEUE_CAPACITY> cells;
+        alignas(64) std::atomic<std::uint64_t> enqueuePos{0};
+        alignas(64) std::uint64_t dequeuePos = 0; // writer thread only
+
+        // tickets [first, last] of a batch whose write failed; dropped once
+        // every waiter of the batch has been told
+        struct FailedBatch
+        {
+            std::uint64_t firstTicket;
+            std::uint64_t lastTicket;
+            size_t unanswered;
+        };
+
+        // tickets are enqueue positions + 1
+        std::atomic<std::uint64_t> durableTicket{0};
+        std::vector<FailedBatch> failedBatches; // guarded by durableMutex
+        std::atomic<bool> hasFailedBatches{false};
+
+        std::atomic<bool> stopping{false};
+        std::atomic<bool> writerIdle{false};
+        std::mutex wakeMutex;
+        std::condition_variable writerWake;
+        std::mutex durableMutex;
+        std::condition_variable durableWake;
+
+        std::atomic<std::uint64_t> commitCount{0};
+        std::atomic<std::uint64_t> batchCount{0};
+        std::chrono::steady_clock::time_point startTime;
+
+        std::thread writer;
+
+        bool recordReady() const;
+        bool tryDequeue(Transaction &out);
+        void run();
+    };
+}
+
+#endif
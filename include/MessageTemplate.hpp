@@ -0,0 +1,106 @@
+#ifndef MESSAGE_TEMPLATE_HPP
+#define MESSAGE_TEMPLATE_HPP
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <charconv>
+#include <type_traits>
+#include <cstddef>
+
+namespace ATMSystem
+{
+    // A localized message split once into the literal text around its "{}"
+    // placeholders. Rendering appends the literals and arguments straight into
+    // a caller-owned buffer, so a reused buffer renders without allocating.
+    class MessageTemplate
+    {
+    private:
+        // literals.size() == placeholder count + 1; views point into the catalog
+        std::vector<std::string_view> literals;
+
+        static constexpr std::string_view PLACEHOLDER = "{}";
+
+        template <typename T>
+        static void appendArgument(std::string &out, const T &value)
+        {
+            if constexpr (std::is_invocable_v<const T &, std::string &>)
+            {
+                // nested renderer, e.g. a cash inventory inside an ATM line
+                value(out);
+            }
+            else if constexpr (std::is_same_v<T, bool>)
+            {
+                out.append(value ? "true" : "false");
+            }
+            else if constexpr (std::is_integral_v<T> || std::is_floating_point_v<T>)
+            {
+                char buffer[64];
+                std::to_chars_result result;
+                if constexpr (std::is_floating_point_v<T>)
+                {
+                    // same digits as std::to_string
+                    result = std::to_chars(buffer, buffer + sizeof(buffer), value, std::chars_format::fixed, 6);
+                }
+                else
+                {
+                    result = std::to_chars(buffer, buffer + sizeof(buffer), value);
+                }
+                out.append(buffer, result.ptr);
+            }
+            else
+            {
+                out.append(std::string_view(value));
+            }
+        }
+
+    public:
+        explicit MessageTemplate(std::string_view text)
+        {
+            size_t start = 0;
+            size_t pos;
+            while ((pos = text.find(PLACEHOLDER, start)) != std::string_view::npos)
+            {
+                literals.push_back(text.substr(start, pos - start));
+                start = pos + PLACEHOLDER.size();
+            }
+            literals.push_back(text.substr(start));
+        }
+
+        size_t getPlaceholderCount() const { return literals.size() - 1; }
+
+        // Appends the rendered message to out. Missing arguments leave their
+        // "{}" in place; extra arguments are ignored.
+        template <typename... Args>
+        void appendTo(std::string &out, const Args &...args) const
+        {
+            out.append(literals[0]);
+            size_t index = 1;
+            auto renderNext = [&](const auto &arg)
+            {
+                if (index < literals.size())
+                {
+                    appendArgument(out, arg);
+                    out.append(literals[index]);
+                    index++;
+                }
+            };
+            (renderNext(args), ...);
+            for (; index < literals.size(); index++)
+            {
+                out.append(PLACEHOLDER);
+                out.append(literals[index]);
+            }
+        }
+
+        template <typename... Args>
+        std::string format(const Args &...args) const
+        {
+            std::string out;
+            appendTo(out, args...);
+            return out;
+        }
+    };
+}
+
+#endif
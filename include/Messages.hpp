@@ -0,0 +1,510 @@
+#ifndef MESSAGES_HPP
+#define MESSAGES_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+
+namespace ATMSystem
+{
+    // Every localized message the system can display. The enumerator order
+    // must match MESSAGE_CATALOG below, so a lookup is a plain array index.
+    enum class MessageId : std::uint16_t
+    {
+        // Basic UI messages
+        WELCOME,
+        SELECT_LANGUAGE,
+        INSERT_CARD,
+        ENTER_PIN,
+        INVALID_CARD,
+        WRONG_PIN,
+        SELECT_SERVICE,
+        AMOUNT,
+        FEE_LABEL,
+        NEW_BALANCE_LABEL,
+
+        // Cash handling messages
+        ENTER_BILLS,
+        BILL_PROMPT,
+        BILLS_BREAKDOWN,
+        CASH_INSUFFICIENT,
+        MAX_DEPOSIT_EXCEEDED,
+        MAX_CHECK_DEPOSIT_EXCEEDED,
+        SELECT_DEPOSIT_TYPE,
+        ENTER_CASH_DEPOSIT,
+
+        // Withdrawal messages
+        WITHDRAWAL_AMOUNT,
+        WITHDRAWAL_SUCCESS,
+        MAX_WITHDRAWAL_EXCEEDED,
+        WITHDRAWAL_MAX_REACHED,
+
+        // Transfer messages
+        TRANSFER_TYPE,
+        TRANSFER_ACCOUNT,
+        SOURCE_ACCOUNT,
+        TRANSFER_AMOUNT,
+        TRANSFER_SUCCESS,
+        TRANSFER_NOT_REVERSED,
+
+        // Account and balance messages
+        INVALID_ACCOUNT,
+        INSUFFICIENT_FUNDS,
+        ACCOUNT_NOT_FOUND,
+        FINAL_BALANCE,
+
+        // Transaction messages
+        TRANSACTION_COMPLETE,
+        TRANSACTION_CANCELLED,
+        TRANSACTION_SUMMARY,
+        THANK_YOU,
+        DEPOSITED,
+        DEPOSIT_SUCCESS,
+        PROCESSING,
+
+        // Fee related messages
+        INSERT_FEE,
+        ENTER_FEE_CASH,
+        INSUFFICIENT_FEE,
+
+        // Receipt and confirmation messages
+        WANT_RECEIPT,
+        CONFIRM_AMOUNT,
+        TAKE_CHANGE,
+
+        // Session messages
+        SESSION_TIMEOUT,
+        SESSION_END,
+        SESSION_SUMMARY_HEADER,
+        SESSION_ID,
+        SESSION_DURATION,
+
+        // Admin messages
+        ADMIN_MENU,
+        ADMIN_DETECTED,
+        EXPORT_SUCCESS,
+        EXPORT_FORMAT_PROMPT,
+        EXPORT_PATH_PROMPT,
+        EXPORT_FROM_PROMPT,
+        EXPORT_TO_PROMPT,
+        EXPORT_COMPLETE,
+        FLEET_EXPORT_COMPLETE,
+        COMMIT_STATS,
+        HISTORY_CARD_PROMPT,
+        HISTORY_TYPE_PROMPT,
+        HISTORY_QUERY_RESULT,
+        RECENT_TRANSACTIONS_NOTE,
+        ACTIVITY_SCOPE,
+        ACTIVITY_ROW,
+        ACTIVITY_CASH,
+
+        // Card related messages
+        CARD_RETAINED,
+        MAX_ATTEMPTS_EXCEEDED,
+
+        // System initialization messages
+        SYSTEM_INIT,
+        ENTER_NUM_BANKS,
+        BANK_NAME_PROMPT,
+        ENTER_VALID_NUMBER,
+        SYSTEM_INIT_COMPLETE,
+        PROVISION_COMPLETE,
+        PROVISION_FAILED,
+        IMAGE_RESTORED,
+        IMAGE_SAVE_FAILED,
+        RECOVERY_COMPLETE,
+        RECOVERY_INVALID_RECORD,
+        CHECKPOINT_FAILED,
+        JOURNAL_NOT_RECOVERED,
+
+        // ATM setup messages
+        ENTER_NUM_ATMS,
+        ATM_TYPE_PROMPT,
+        AVAILABLE_BANKS,
+        SELECT_PRIMARY_BANK,
+        INIT_CASH,
+        ATM_CREATED,
+
+        // Account setup messages
+        ENTER_NUM_USERS,
+        USER_NAME_PROMPT,
+        NUM_ACCOUNTS_PROMPT,
+        ENTER_PIN_FOR_ACCOUNT,
+        ACCOUNT_CREATED,
+        INVALID_PIN_FORMAT,
+
+        // ATM selection messages
+        AVAILABLE_ATMS,
+        ATM_LIST_ENTRY,
+        SELECT_ATM,
+        QUIT_PROMPT,
+        GOODBYE,
+
+        // Transaction history messages
+        TRANSACTION_HISTORY_HEADER,
+        TRANSACTION_ID_HEADER,
+        CARD_NUMBER_HEADER,
+        TYPE_HEADER,
+        AMOUNT_HEADER,
+        FEE_HEADER,
+        TIMESTAMP_HEADER,
+        DETAILS_HEADER,
+        TRANSACTION_HEADER,
+
+        // System snapshot messages
+        SYSTEM_SNAPSHOT,
+        ATM_SNAPSHOT,
+        ACCOUNT_SNAPSHOT,
+        ATM_INFO,
+        ACCOUNT_INFO,
+
+        // General messages
+        INVALID_CHOICE,
+        INVALID_AMOUNT,
+        PLEASE_WAIT,
+
+        // Bank-specific messages
+        SINGLE_BANK_ONLY,
+        PRIMARY_BANK,
+        NON_PRIMARY_BANK,
+
+        // Additional transaction details
+        CHECK_MIN_AMOUNT,
+        INVALID_CHECK_AMOUNT,
+        CHANGE_AMOUNT,
+
+        // Error messages
+        ERROR_INSUFFICIENT_CASH,
+        ERROR_SYSTEM,
+        ERROR_INVALID_OPERATION,
+        CANCEL_TRANSACTION,
+
+        // For check deposit
+        CHECK_PROMPT,
+        INVALID_CHECK_INPUT,
+
+        // For transaction status
+        TRANSACTION_FEE,
+        DEPOSIT_FEE_REQUIRED,
+        CASH_TRANSFER_SUCCESS,
+        ACCOUNT_TRANSFER_SUCCESS,
+        CHECK_DEPOSIT_SUCCESS,
+
+        // For session summary
+        CARD_NUMBER_LABEL,
+        BANK_LABEL,
+
+        // additional
+        AMOUNT_DEPOSITED,
+        AMOUNT_TRANSFERRED,
+        CASH_DEPOSIT_TYPE,
+        CHECK_DEPOSIT_TYPE,
+        WITHDRAWAL_TYPE,
+        CASH_TRANSFER_TYPE,
+        ACCOUNT_TRANSFER_TYPE,
+        TO,
+        ATTEMPTS_REMAINING,
+        FROM,
+        SYSTEM_BORDER,
+        BILL_FORMAT,
+        SYSTEM_INIT_HEADER,
+        ATM_CREATION_PROMPT,
+        ENTER_VALID_POSITIVE,
+        INVALID_TYPE_CHOICE,
+        LANG_SUPPORT_PROMPT,
+        INVALID_BANK_CHOICE,
+        INIT_CASH_INVENTORY,
+        ENTER_BILLS_COUNT,
+        ENTER_NON_NEGATIVE,
+        ATM_CREATION_SUCCESS,
+        ENTER_USER_COUNT,
+        ACCOUNT_COUNT_PROMPT,
+        PIN_PROMPT,
+        ACCOUNT_CREATION_SUCCESS,
+        ACCOUNT_CREATION_FAILED,
+        MESSAGE_NOT_FOUND,
+        SYSTEM_ERROR_LOG,
+        MAX_PIN_EXCEEDED,
+        INSUFFICIENT_CASH_ERROR,
+        CARD_ERROR,
+        SYSTEM_ERROR,
+        CASH_INVENTORY_START,
+        CASH_INVENTORY_END,
+        CASH_INVENTORY_SEPARATOR,
+        CASH_INVENTORY_FORMAT,
+        ATM_INFO_FORMAT,
+        ACCOUNT_INFO_FORMAT,
+        SNAPSHOT_MORE,
+        SNAPSHOT_FILTER_USAGE,
+        TRANSACTION_TYPE_DEPOSIT,
+        TRANSACTION_TYPE_WITHDRAWAL,
+        TRANSACTION_TYPE_CASH_TRANSFER,
+        TRANSACTION_TYPE_ACCOUNT_TRANSFER,
+        TRANSACTION_TYPE_UNKNOWN,
+        TIMESTAMP_FORMAT,
+
+        COUNT
+    };
+
+    struct MessageEntry
+    {
+        MessageId id;
+        std::string_view key;
+        std::string_view english;
+        std::string_view korean;
+    };
+
+    inline constexpr MessageEntry MESSAGE_CATALOG[] = {
+        // Basic UI messages
+        {MessageId::WELCOME, "WELCOME", "Welcome to ATM Service", "ATM 서비스에 오신 것을 환영합니다"},
+        {MessageId::SELECT_LANGUAGE, "SELECT_LANGUAGE", "Select Language (1: English, 2: Korean)", "언어 선택 (1: 영어, 2: 한국어)"},
+        {MessageId::INSERT_CARD, "INSERT_CARD", "Please insert your card (Enter card number):", "카드를 넣어주세요 (카드 번호 입력):"},
+        {MessageId::ENTER_PIN, "ENTER_PIN", "Enter your PIN:", "비밀번호를 입력하세요:"},
+        {MessageId::INVALID_CARD, "INVALID_CARD", "Invalid card number length. Please enter a 12-digit account number.", "잘못된 카드 번호입니다. 12자리 계좌번호를 입력해주세요."},
+        {MessageId::WRONG_PIN, "WRONG_PIN", "Wrong PIN.", "잘못된 비밀번호입니다."},
+        {MessageId::SELECT_SERVICE, "SELECT_SERVICE", "Select Service:\n1. Deposit\n2. Withdraw\n3. Transfer\n4. Recent Transactions\n5. Exit", "서비스 선택:\n1. 입금\n2. 출금\n3. 이체\n4. 최근 거래내역\n5. 종료"},
+        {MessageId::AMOUNT, "AMOUNT", "Amount:", "금액:"},
+        {MessageId::FEE_LABEL, "FEE_LABEL", "Fee:", "수수료:"},
+        {MessageId::NEW_BALANCE_LABEL, "NEW_BALANCE_LABEL", "New balance:", "새로운 잔액:"},
+
+        // Cash handling messages
+        {MessageId::ENTER_BILLS, "ENTER_BILLS", "Enter number of bills for each denomination:", "권종별 지폐 수량을 입력하세요:"},
+        {MessageId::BILL_PROMPT, "BILL_PROMPT", "KRW {} bills: ", "{} 원권 지폐 수:"},
+        {MessageId::BILLS_BREAKDOWN, "BILLS_BREAKDOWN", "Bills breakdown:", "지폐 내역:"},
+        {MessageId::CASH_INSUFFICIENT, "CASH_INSUFFICIENT", "ATM does not have sufficient cash.", "ATM에 현금이 부족합니다."},
+        {MessageId::MAX_DEPOSIT_EXCEEDED, "MAX_DEPOSIT_EXCEEDED", "Maximum number of bills (50) exceeded for this deposit.", "이번 입금의 지폐 수가 최대 한도(50)를 초과했습니다."},
+        {MessageId::MAX_CHECK_DEPOSIT_EXCEEDED, "MAX_CHECK_DEPOSIT_EXCEEDED", "Maximum number of checks (50) per session reached.", "세션당 수표 입금 한도(50)에 도달했습니다."},
+        {MessageId::SELECT_DEPOSIT_TYPE, "SELECT_DEPOSIT_TYPE", "Select deposit type:\n1. Cash\n2. Check", "입금 유형 선택:\n1. 현금\n2. 수표"},
+        {MessageId::ENTER_CASH_DEPOSIT, "ENTER_CASH_DEPOSIT", "Enter cash to deposit:", "입금할 현금을 넣어주세요:"},
+
+        // Withdrawal messages
+        {MessageId::WITHDRAWAL_AMOUNT, "WITHDRAWAL_AMOUNT", "Enter amount to withdraw:", "출금하실 금액을 입력하세요:"},
+        {MessageId::WITHDRAWAL_SUCCESS, "WITHDRAWAL_SUCCESS", "Withdrawal successful!", "출금이 완료되었습니다!"},
+        {MessageId::MAX_WITHDRAWAL_EXCEEDED, "MAX_WITHDRAWAL_EXCEEDED", "Amount exceeds maximum withdrawal limit of KRW 500,000", "출금 한도 500,000원을 초과하였습니다"},
+        {MessageId::WITHDRAWAL_MAX_REACHED, "WITHDRAWAL_MAX_REACHED", "Maximum withdrawals per session ({}) reached.", "세션당 최대 출금 횟수({})에 도달했습니다."},
+
+        // Transfer messages
+        {MessageId::TRANSFER_TYPE, "TRANSFER_TYPE", "Select transfer type:\n1. Cash Transfer\n2. Account Transfer", "이체 유형 선택:\n1. 현금 이체\n2. 계좌 이체"},
+        {MessageId::TRANSFER_ACCOUNT, "TRANSFER_ACCOUNT", "Enter destination account (12 digits):", "이체할 계좌번호 (12자리)를 입력하세요:"},
+        {MessageId::SOURCE_ACCOUNT, "SOURCE_ACCOUNT", "Enter source account (12 digits):", "출금할 계좌번호 (12자리)를 입력하세요:"},
+        {MessageId::TRANSFER_AMOUNT, "TRANSFER_AMOUNT", "Enter amount to transfer:", "이체할 금액을 입력하세요:"},
+        {MessageId::TRANSFER_SUCCESS, "TRANSFER_SUCCESS", "Transfer successful!", "이체가 완료되었습니다!"},
+        {MessageId::TRANSFER_NOT_REVERSED, "TRANSFER_NOT_REVERSED", "Transfer failed, and {} could not be returned to account {}. Please contact the bank.", "이체에 실패했으며 {}을(를) 계좌 {}에 돌려놓지 못했습니다. 은행에 문의하십시오."},
+
+        // Account and balance messages
+        {MessageId::INVALID_ACCOUNT, "INVALID_ACCOUNT", "Invalid account number. Please enter a 12-digit number.", "잘못된 계좌번호입니다. 12자리 번호를 입력해주세요."},
+        {MessageId::INSUFFICIENT_FUNDS, "INSUFFICIENT_FUNDS", "Insufficient funds!", "잔액이 부족합니다!"},
+        {MessageId::ACCOUNT_NOT_FOUND, "ACCOUNT_NOT_FOUND", "Account not found.", "계좌를 찾을 수 없습니다."},
+        {MessageId::FINAL_BALANCE, "FINAL_BALANCE", "Final Balance: {}", "최종 잔액: {}"},
+
+        // Transaction messages
+        {MessageId::TRANSACTION_COMPLETE, "TRANSACTION_COMPLETE", "Transaction complete!", "거래가 완료되었습니다!"},
+        {MessageId::TRANSACTION_CANCELLED, "TRANSACTION_CANCELLED", "Transaction cancelled.", "거래가 취소되었습니다."},
+        {MessageId::TRANSACTION_SUMMARY, "TRANSACTION_SUMMARY", "Transaction Summary", "거래내역 요약"},
+        {MessageId::THANK_YOU, "THANK_YOU", "Thank you for using our ATM!", "이용해 주셔서 감사합니다!"},
+        {MessageId::DEPOSITED, "DEPOSITED", "Deposited:", "입금 내역:"},
+        {MessageId::DEPOSIT_SUCCESS, "DEPOSIT_SUCCESS", "Deposit successful!", "입금이 완료되었습니다!"},
+        {MessageId::PROCESSING, "PROCESSING", "Processing transaction...", "거래를 처리중입니다..."},
+
+        // Fee related messages
+        {MessageId::INSERT_FEE, "INSERT_FEE", "Please insert transaction fee:", "거래 수수료를 넣어주세요:"},
+        {MessageId::ENTER_FEE_CASH, "ENTER_FEE_CASH", "Please insert cash for transaction fee:", "거래 수수료를 넣어주세요:"},
+        {MessageId::INSUFFICIENT_FEE, "INSUFFICIENT_FEE", "Insufficient fee amount. Transaction cancelled.", "수수료가 부족합니다. 거래가 취소되었습니다."},
+
+        // Receipt and confirmation messages
+        {MessageId::WANT_RECEIPT, "WANT_RECEIPT", "Would you like a receipt? (Y/N):", "영수증이 필요하십니까? (Y/N):"},
+        {MessageId::CONFIRM_AMOUNT, "CONFIRM_AMOUNT", "Confirm amount (Y/N):", "금액이 맞습니까? (Y/N):"},
+        {MessageId::TAKE_CHANGE, "TAKE_CHANGE", "Press 'y' to take change:", "거스름돈을 받으시려면 'y'를 누르세요:"},
+
+        // Session messages
+        {MessageId::SESSION_TIMEOUT, "SESSION_TIMEOUT", "Session timed out. Please try again.", "세션이 만료되었습니다. 다시 시도해주세요."},
+        {MessageId::SESSION_END, "SESSION_END", "Ending session...", "세션을 종료합니다..."},
+        {MessageId::SESSION_SUMMARY_HEADER, "SESSION_SUMMARY_HEADER", "=== Session Summary ===", "=== 세션 요약 ==="},
+        {MessageId::SESSION_ID, "SESSION_ID", "Session ID: {}", "세션 ID: {}"},
+        {MessageId::SESSION_DURATION, "SESSION_DURATION", "Session Duration: {} minutes", "세션 지속 시간: {}분"},
+
+        // Admin messages
+        {MessageId::ADMIN_MENU, "ADMIN_MENU", "Admin Menu:\n1. View Transaction History\n2. Export Transaction History\n3. Search Transaction History\n4. Activity Summary\n5. Exit", "관리자 메뉴:\n1. 거래내역 조회\n2. 거래내역 내보내기\n3. 거래내역 검색\n4. 거래 현황\n5. 종료"},
+        {MessageId::ADMIN_DETECTED, "ADMIN_DETECTED", "Admin card detected. Accessing admin menu...", "관리자 카드가 감지되었습니다. 관리자 메뉴에 접속중..."},
+        {MessageId::EXPORT_SUCCESS, "EXPORT_SUCCESS", "Transaction history has been exported to: ", "거래 내역이 다음 파일로 내보내졌습니다: "},
+        {MessageId::EXPORT_FORMAT_PROMPT, "EXPORT_FORMAT_PROMPT", "Export format (1: CSV, 2: JSON Lines, 3: Binary): ", "내보내기 형식 (1: CSV, 2: JSON Lines, 3: 바이너리): "},
+        {MessageId::EXPORT_PATH_PROMPT, "EXPORT_PATH_PROMPT", "Output file path: ", "출력 파일 경로: "},
+        {MessageId::EXPORT_FROM_PROMPT, "EXPORT_FROM_PROMPT", "From date (YYYY-MM-DD, empty for all): ", "시작 날짜 (YYYY-MM-DD, 전체는 빈칸): "},
+        {MessageId::EXPORT_TO_PROMPT, "EXPORT_TO_PROMPT", "To date (YYYY-MM-DD, empty for all): ", "종료 날짜 (YYYY-MM-DD, 전체는 빈칸): "},
+        {MessageId::EXPORT_COMPLETE, "EXPORT_COMPLETE", "Exported {} transactions to {}", "{}건의 거래를 {}(으)로 내보냈습니다"},
+        {MessageId::FLEET_EXPORT_COMPLETE, "FLEET_EXPORT_COMPLETE", "Exported {} transactions from {} ATMs to {}", "거래 {}건(ATM {}대)을 {}(으)로 내보냈습니다"},
+        {MessageId::COMMIT_STATS, "COMMIT_STATS", "Durable commits: {} in {} batches ({} commits/s)", "영구 기록: {}건, {}회 일괄 처리 (초당 {}건)"},
+        {MessageId::HISTORY_CARD_PROMPT, "HISTORY_CARD_PROMPT", "Card number (empty for all): ", "카드 번호 (전체는 빈칸): "},
+        {MessageId::HISTORY_TYPE_PROMPT, "HISTORY_TYPE_PROMPT", "Type (1: Deposit, 2: Withdrawal, 3: Cash Transfer, 4: Account Transfer, empty for all): ", "유형 (1: 입금, 2: 출금, 3: 현금 송금, 4: 계좌 송금, 전체는 빈칸): "},
+        {MessageId::HISTORY_QUERY_RESULT, "HISTORY_QUERY_RESULT", "{} matching transactions", "일치하는 거래 {}건"},
+        {MessageId::RECENT_TRANSACTIONS_NOTE, "RECENT_TRANSACTIONS_NOTE", "Last {} transactions of this account; older ones are in the transaction history.", "이 계좌의 최근 거래 {}건입니다. 이전 거래는 거래내역에서 확인하세요."},
+        {MessageId::ACTIVITY_SCOPE, "ACTIVITY_SCOPE", "=== Activity: {} ===", "=== 거래 현황: {} ==="},
+        {MessageId::ACTIVITY_ROW, "ACTIVITY_ROW", "{}: {} transactions, {} won, fees {} won (last hour: {})", "{}: {}건, {}원, 수수료 {}원 (최근 1시간: {}건)"},
+        {MessageId::ACTIVITY_CASH, "ACTIVITY_CASH", "Cash in: {} won, cash out: {} won", "현금 입금: {}원, 현금 출금: {}원"},
+
+        // Card related messages
+        {MessageId::CARD_RETAINED, "CARD_RETAINED", "Your card has been retained. Please contact your bank.", "카드가 회수되었습니다. 은행에 문의하세요."},
+        {MessageId::MAX_ATTEMPTS_EXCEEDED, "MAX_ATTEMPTS_EXCEEDED", "Maximum PIN attempts exceeded. Card retained.", "비밀번호 입력 횟수 초과. 카드가 회수되었습니다."},
+
+        // System initialization messages
+        {MessageId::SYSTEM_INIT, "SYSTEM_INIT", "=== ATM System Initialization ===", "=== ATM 시스템 초기화 ==="},
+        {MessageId::ENTER_NUM_BANKS, "ENTER_NUM_BANKS", "Enter number of banks to create: ", "생성할 은행 수를 입력하세요: "},
+        {MessageId::BANK_NAME_PROMPT, "BANK_NAME_PROMPT", "Bank {} name: ", "{}번 은행 이름: "},
+        {MessageId::ENTER_VALID_NUMBER, "ENTER_VALID_NUMBER", "Please enter a valid number greater than 0: ", "0보다 큰 올바른 숫자를 입력하세요: "},
+        {MessageId::SYSTEM_INIT_COMPLETE, "SYSTEM_INIT_COMPLETE", "System initialization completed!", "시스템 초기화가 완료되었습니다!"},
+        {MessageId::PROVISION_COMPLETE, "PROVISION_COMPLETE", "Provisioned {} banks, {} accounts and {} ATMs ({} account lines skipped).", "은행 {}개, 계좌 {}개, ATM {}대를 설정했습니다 (계좌 {}줄 건너뜀)."},
+        {MessageId::PROVISION_FAILED, "PROVISION_FAILED", "Could not provision from {} (line {}).", "{} 파일로 설정하지 못했습니다 ({}번째 줄)."},
+        {MessageId::IMAGE_RESTORED, "IMAGE_RESTORED", "Restored {} banks, {} accounts and {} ATMs from {}.", "은행 {}개, 계좌 {}개, ATM {}대를 {}에서 복원했습니다."},
+        {MessageId::IMAGE_SAVE_FAILED, "IMAGE_SAVE_FAILED", "Failed to save system image to {}.", "시스템 이미지를 {}에 저장하지 못했습니다."},
+        {MessageId::RECOVERY_COMPLETE, "RECOVERY_COMPLETE", "Recovery complete: {} balances from checkpoint, {} journal records replayed.", "복구 완료: 체크포인트 잔액 {}건, 저널 기록 {}건 재적용."},
+        {MessageId::RECOVERY_INVALID_RECORD, "RECOVERY_INVALID_RECORD", "Journal record {} was not replayed: amount or balance out of range.", "저널 기록 {}은(는) 금액 또는 잔액 범위를 벗어나 재적용하지 않았습니다."},
+        {MessageId::CHECKPOINT_FAILED, "CHECKPOINT_FAILED", "Failed to write recovery checkpoint.", "복구 체크포인트 저장에 실패했습니다."},
+        {MessageId::JOURNAL_NOT_RECOVERED, "JOURNAL_NOT_RECOVERED", "The journals hold transactions this state has not applied. Restart with --recover, or move the journal directory away to start fresh.", "저널에 현재 상태에 반영되지 않은 거래가 있습니다. --recover로 다시 시작하거나, 새로 시작하려면 저널 디렉터리를 옮기십시오."},
+
+        // ATM setup messages
+        {MessageId::ENTER_NUM_ATMS, "ENTER_NUM_ATMS", "Enter number of ATMs to create: ", "생성할 ATM 수를 입력하세요: "},
+        {MessageId::ATM_TYPE_PROMPT, "ATM_TYPE_PROMPT", "ATM {} type (1: Single Bank, 2: Multi-Bank): ", "ATM {} 유형 (1: 단일 은행, 2: 다중 은행): "},
+        {MessageId::AVAILABLE_BANKS, "AVAILABLE_BANKS", "Available banks:", "사용 가능한 은행:"},
+        {MessageId::SELECT_PRIMARY_BANK, "SELECT_PRIMARY_BANK", "Select primary bank (1-{}): ", "주 은행을 선택하세요 (1-{}): "},
+        {MessageId::INIT_CASH, "INIT_CASH", "Initialize cash inventory for ATM {}:", "ATM {}의 현금 재고 초기화:"},
+        {MessageId::ATM_CREATED, "ATM_CREATED", "ATM {} created successfully!", "ATM {} 가 성공적으로 생성되었습니다!"},
+
+        // Account setup messages
+        {MessageId::ENTER_NUM_USERS, "ENTER_NUM_USERS", "Enter number of users for {}: ", "{}의 사용자 수를 입력하세요: "},
+        {MessageId::USER_NAME_PROMPT, "USER_NAME_PROMPT", "User {} name: ", "{}번 사용자 이름: "},
+        {MessageId::NUM_ACCOUNTS_PROMPT, "NUM_ACCOUNTS_PROMPT", "Number of accounts for {}: ", "{}의 계좌 수: "},
+        {MessageId::ENTER_PIN_FOR_ACCOUNT, "ENTER_PIN_FOR_ACCOUNT", "Enter 4-digit PIN for account {}: ", "계좌 {}의 4자리 PIN을 입력하세요: "},
+        {MessageId::ACCOUNT_CREATED, "ACCOUNT_CREATED", "Created account {} for {}", "{}의 계좌 {} 가 생성되었습니다"},
+        {MessageId::INVALID_PIN_FORMAT, "INVALID_PIN_FORMAT", "Invalid PIN format. PIN must be 4 digits.", "잘못된 PIN 형식입니다. PIN은 4자리 숫자여야 합니다."},
+
+        // ATM selection messages
+        {MessageId::AVAILABLE_ATMS, "AVAILABLE_ATMS", "Available ATMs:", "사용 가능한 ATM:"},
+        {MessageId::ATM_LIST_ENTRY, "ATM_LIST_ENTRY", "{}. ATM {} ({}-Bank, Primary: {})", "{}. ATM {} ({} 은행, 주 은행: {})"},
+        {MessageId::SELECT_ATM, "SELECT_ATM", "Select ATM (1-{}) or 'q' to quit: ", "ATM을 선택하세요 (1-{}) 또는 종료하려면 'q': "},
+        {MessageId::QUIT_PROMPT, "QUIT_PROMPT", "Enter 'q' to quit the program or 'x' to export the history of all ATMs", "프로그램을 종료하려면 'q', 전체 ATM 거래내역을 내보내려면 'x'를 입력하세요"},
+        {MessageId::GOODBYE, "GOODBYE", "Thank you for using our ATM system. Goodbye!", "ATM 시스템을 이용해 주셔서 감사합니다. 안녕히 가세요!"},
+
+        // Transaction history messages
+        {MessageId::TRANSACTION_HISTORY_HEADER, "TRANSACTION_HISTORY_HEADER", "=== Transaction History ===", "=== 거래 내역 ==="},
+        {MessageId::TRANSACTION_ID_HEADER, "TRANSACTION_ID_HEADER", "Transaction ID", "거래 ID"},
+        {MessageId::CARD_NUMBER_HEADER, "CARD_NUMBER_HEADER", "Card Number", "카드 번호"},
+        {MessageId::TYPE_HEADER, "TYPE_HEADER", "Type", "유형"},
+        {MessageId::AMOUNT_HEADER, "AMOUNT_HEADER", "Amount", "금액"},
+        {MessageId::FEE_HEADER, "FEE_HEADER", "Fee", "수수료"},
+        {MessageId::TIMESTAMP_HEADER, "TIMESTAMP_HEADER", "Timestamp", "시간"},
+        {MessageId::DETAILS_HEADER, "DETAILS_HEADER", "Details", "상세 내용"},
+        {MessageId::TRANSACTION_HEADER, "TRANSACTION_HEADER", "Transaction History", "거래 내역"},
+
+        // System snapshot messages
+        {MessageId::SYSTEM_SNAPSHOT, "SYSTEM_SNAPSHOT", "=== System Snapshot ===", "=== 시스템 스냅샷 ==="},
+        {MessageId::ATM_SNAPSHOT, "ATM_SNAPSHOT", "=== ATM Snapshot ===", "=== ATM 스냅샷 ==="},
+        {MessageId::ACCOUNT_SNAPSHOT, "ACCOUNT_SNAPSHOT", "=== Account Snapshot ===", "=== 계좌 스냅샷 ==="},
+        {MessageId::ATM_INFO, "ATM_INFO", "ATM [SN: {}] remaining cash: {}", "ATM [일련번호: {}] 남은 현금: {}"},
+        {MessageId::ACCOUNT_INFO, "ACCOUNT_INFO", "Account [Bank: {}, No: {}, Owner: {}] balance: {}", "계좌 [은행: {}, 번호: {}, 소유자: {}] 잔액: {}"},
+
+        // General messages
+        {MessageId::INVALID_CHOICE, "INVALID_CHOICE", "Invalid choice. Please try again.", "잘못된 선택입니다. 다시 시도해주세요."},
+        {MessageId::INVALID_AMOUNT, "INVALID_AMOUNT", "Please enter a valid amount.", "올바른 금액을 입력해주세요."},
+        {MessageId::PLEASE_WAIT, "PLEASE_WAIT", "Please wait...", "잠시만 기다려주세요..."},
+
+        // Bank-specific messages
+        {MessageId::SINGLE_BANK_ONLY, "SINGLE_BANK_ONLY", "This ATM only accepts cards from {}", "이 ATM은 {} 은행의 카드만 사용 가능합니다"},
+        {MessageId::PRIMARY_BANK, "PRIMARY_BANK", "Primary Bank", "주 거래 은행"},
+        {MessageId::NON_PRIMARY_BANK, "NON_PRIMARY_BANK", "Non-Primary Bank", "비주거래 은행"},
+
+        // Additional transaction details
+        {MessageId::CHECK_MIN_AMOUNT, "CHECK_MIN_AMOUNT", "Enter check amount (minimum {} KRW): ", "수표 금액을 입력하세요 (최소 {} 원): "},
+        {MessageId::INVALID_CHECK_AMOUNT, "INVALID_CHECK_AMOUNT", "Invalid check amount. Minimum is {} KRW", "잘못된 수표 금액입니다. 최소 금액은 {} 원입니다"},
+        {MessageId::CHANGE_AMOUNT, "CHANGE_AMOUNT", "Change amount: {} KRW", "거스름돈: {} 원"},
+
+        // Error messages
+        {MessageId::ERROR_INSUFFICIENT_CASH, "ERROR_INSUFFICIENT_CASH", "Error: ATM has insufficient cash", "오류: ATM에 현금이 부족합니다"},
+        {MessageId::ERROR_SYSTEM, "ERROR_SYSTEM", "System Error: {}", "시스템 오류: {}"},
+        {MessageId::ERROR_INVALID_OPERATION, "ERROR_INVALID_OPERATION", "Invalid operation", "잘못된 작업"},
+        {MessageId::CANCEL_TRANSACTION, "CANCEL_TRANSACTION", "Transaction cancelled.", "거래가 취소되었습니다."},
+
+        // For check deposit
+        {MessageId::CHECK_PROMPT, "CHECK_PROMPT", "Enter check amount (minimum KRW {}):", "수표 금액을 입력하세요 (최소 {} 원):"},
+        {MessageId::INVALID_CHECK_INPUT, "INVALID_CHECK_INPUT", "Invalid input.", "잘못된 입력입니다."},
+
+        // For transaction status
+        {MessageId::TRANSACTION_FEE, "TRANSACTION_FEE", "Transaction fee: KRW {}", "거래 수수료: {} 원"},
+        {MessageId::DEPOSIT_FEE_REQUIRED, "DEPOSIT_FEE_REQUIRED", "Deposit fee required: KRW {}", "입금 수수료가 필요합니다: {} 원"},
+        {MessageId::CASH_TRANSFER_SUCCESS, "CASH_TRANSFER_SUCCESS", "Cash transfer successful!", "현금 이체가 완료되었습니다!"},
+        {MessageId::ACCOUNT_TRANSFER_SUCCESS, "ACCOUNT_TRANSFER_SUCCESS", "Account transfer successful!", "계좌 이체가 완료되었습니다!"},
+        {MessageId::CHECK_DEPOSIT_SUCCESS, "CHECK_DEPOSIT_SUCCESS", "Check deposit successful!", "수표 입금이 완료되었습니다!"},
+
+        // For session summary
+        {MessageId::CARD_NUMBER_LABEL, "CARD_NUMBER_LABEL", "Card Number:", "카드 번호:"},
+        {MessageId::BANK_LABEL, "BANK_LABEL", "Bank:", "은행:"},
+
+        // additional
+        {MessageId::AMOUNT_DEPOSITED, "AMOUNT_DEPOSITED", "Amount deposited:", "입금액:"},
+        {MessageId::AMOUNT_TRANSFERRED, "AMOUNT_TRANSFERRED", "Amount transferred:", "이체액:"},
+        {MessageId::CASH_DEPOSIT_TYPE, "CASH_DEPOSIT_TYPE", "Cash Deposit", "현금 입금"},
+        {MessageId::CHECK_DEPOSIT_TYPE, "CHECK_DEPOSIT_TYPE", "Check Deposit", "수표 입금"},
+        {MessageId::WITHDRAWAL_TYPE, "WITHDRAWAL_TYPE", "Withdrawal", "출금"},
+        {MessageId::CASH_TRANSFER_TYPE, "CASH_TRANSFER_TYPE", "Cash Transfer", "현금 이체"},
+        {MessageId::ACCOUNT_TRANSFER_TYPE, "ACCOUNT_TRANSFER_TYPE", "Account Transfer", "계좌 이체"},
+        {MessageId::TO, "TO", "to", "to"},
+        {MessageId::ATTEMPTS_REMAINING, "ATTEMPTS_REMAINING", "Attempts remaining: {}", "남은 시도 횟수: {}"},
+        {MessageId::FROM, "FROM", "From", "보낸 사람"},
+        {MessageId::SYSTEM_BORDER, "SYSTEM_BORDER", "----------------------------------------", "----------------------------------------"},
+        {MessageId::BILL_FORMAT, "BILL_FORMAT", "{} × KRW {}", "{} × {} 원"},
+        {MessageId::SYSTEM_INIT_HEADER, "SYSTEM_INIT_HEADER", "=== ATM System Initialization ===", "=== ATM 시스템 초기화 ==="},
+        {MessageId::ATM_CREATION_PROMPT, "ATM_CREATION_PROMPT", "Enter number of ATMs to create:", "생성할 ATM 수를 입력하세요:"},
+        {MessageId::ENTER_VALID_POSITIVE, "ENTER_VALID_POSITIVE", "Please enter a valid number greater than 0:", "0보다 큰 올바른 숫자를 입력하세요:"},
+        {MessageId::INVALID_TYPE_CHOICE, "INVALID_TYPE_CHOICE", "Invalid choice. Please enter 1 or 2.", "잘못된 선택입니다. 1 또는 2를 입력하세요."},
+        {MessageId::LANG_SUPPORT_PROMPT, "LANG_SUPPORT_PROMPT", "Language support (1: Unilingual, 2: Bilingual):", "언어 지원 (1: 단일 언어, 2: 이중 언어):"},
+        {MessageId::INVALID_BANK_CHOICE, "INVALID_BANK_CHOICE", "Invalid choice. Please select a number between 1 and {}", "잘못된 선택입니다. 1과 {} 사이의 숫자를 선택하세요."},
+        {MessageId::INIT_CASH_INVENTORY, "INIT_CASH_INVENTORY", "Initialize cash inventory for ATM {}:", "ATM {}의 현금 재고 초기화:"},
+        {MessageId::ENTER_BILLS_COUNT, "ENTER_BILLS_COUNT", "Enter number of {} KRW bills:", "{} 원권 지폐 수를 입력하세요:"},
+        {MessageId::ENTER_NON_NEGATIVE, "ENTER_NON_NEGATIVE", "Please enter a non-negative number.", "0 이상의 숫자를 입력하세요."},
+        {MessageId::ATM_CREATION_SUCCESS, "ATM_CREATION_SUCCESS", "ATM {} created successfully!", "ATM {}가 성공적으로 생성되었습니다!"},
+        {MessageId::ENTER_USER_COUNT, "ENTER_USER_COUNT", "Enter number of users for {}:", "{}의 사용자 수를 입력하세요:"},
+        {MessageId::ACCOUNT_COUNT_PROMPT, "ACCOUNT_COUNT_PROMPT", "Number of accounts for {}:", "{}의 계좌 수:"},
+        {MessageId::PIN_PROMPT, "PIN_PROMPT", "Enter 4-digit PIN for account {}:", "계좌 {}의 4자리 PIN을 입력하세요:"},
+        {MessageId::ACCOUNT_CREATION_SUCCESS, "ACCOUNT_CREATION_SUCCESS", "Created account {} for {}", "{}의 계좌 {}가 생성되었습니다"},
+        {MessageId::ACCOUNT_CREATION_FAILED, "ACCOUNT_CREATION_FAILED", "Failed to create account. Please try again.", "계좌 생성에 실패했습니다. 다시 시도해주세요."},
+        {MessageId::MESSAGE_NOT_FOUND, "MESSAGE_NOT_FOUND", "Message not found", "메시지를 찾을 수 없습니다"},
+        {MessageId::SYSTEM_ERROR_LOG, "SYSTEM_ERROR_LOG", "Session ended: {}", "세션 종료됨: {}"},
+        {MessageId::MAX_PIN_EXCEEDED, "MAX_PIN_EXCEEDED", "Maximum PIN attempts exceeded", "최대 PIN 시도 횟수 초과"},
+        {MessageId::INSUFFICIENT_CASH_ERROR, "INSUFFICIENT_CASH_ERROR", "insufficient cash", "현금 부족"},
+        {MessageId::CARD_ERROR, "CARD_ERROR", "card error", "카드 오류"},
+        {MessageId::SYSTEM_ERROR, "SYSTEM_ERROR", "system error", "시스템 오류"},
+        {MessageId::CASH_INVENTORY_START, "CASH_INVENTORY_START", "{", "{"},
+        {MessageId::CASH_INVENTORY_END, "CASH_INVENTORY_END", "}", "}"},
+        {MessageId::CASH_INVENTORY_SEPARATOR, "CASH_INVENTORY_SEPARATOR", ", ", ", "},
+        {MessageId::CASH_INVENTORY_FORMAT, "CASH_INVENTORY_FORMAT", "KRW {} : {}", "{}원 : {}"},
+        {MessageId::ATM_INFO_FORMAT, "ATM_INFO_FORMAT", "ATM [SN: {}] remaining cash: {}", "ATM [일련번호: {}] 남은 현금: {}"},
+        {MessageId::ACCOUNT_INFO_FORMAT, "ACCOUNT_INFO_FORMAT", "Account [Bank: {}, No: {}, Owner: {}] balance: {}", "계좌 [은행: {}, 계좌번호: {}, 소유자: {}] 잔액: {}"},
+        {MessageId::SNAPSHOT_MORE, "SNAPSHOT_MORE", "-- {} shown; Enter for more, 'q' to stop -- ", "-- {}건 표시됨; 계속하려면 Enter, 중단하려면 'q' -- "},
+        {MessageId::SNAPSHOT_FILTER_USAGE, "SNAPSHOT_FILTER_USAGE", "Usage: / [bank=NAME] [prefix=DIGITS] [min=WON] [max=WON] [cash=WON] [top=N] [page=N, 0 = unpaged]", "사용법: / [bank=은행] [prefix=계좌번호앞자리] [min=원] [max=원] [cash=원] [top=N] [page=N, 0 = 전체]"},
+        {MessageId::TRANSACTION_TYPE_DEPOSIT, "TRANSACTION_TYPE_DEPOSIT", "Deposit", "입금"},
+        {MessageId::TRANSACTION_TYPE_WITHDRAWAL, "TRANSACTION_TYPE_WITHDRAWAL", "Withdrawal", "출금"},
+        {MessageId::TRANSACTION_TYPE_CASH_TRANSFER, "TRANSACTION_TYPE_CASH_TRANSFER", "Cash Transfer", "현금 이체"},
+        {MessageId::TRANSACTION_TYPE_ACCOUNT_TRANSFER, "TRANSACTION_TYPE_ACCOUNT_TRANSFER", "Account Transfer", "계좌 이체"},
+        {MessageId::TRANSACTION_TYPE_UNKNOWN, "TRANSACTION_TYPE_UNKNOWN", "Unknown", "알 수 없음"},
+        {MessageId::TIMESTAMP_FORMAT, "TIMESTAMP_FORMAT", "%Y-%m-%d %H:%M:%S", "%Y년 %m월 %d일 %H시 %M분 %S초"},
+    };
+
+    constexpr std::size_t MESSAGE_COUNT = static_cast<std::size_t>(MessageId::COUNT);
+
+    constexpr bool isMessageCatalogOrdered()
+    {
+        for (std::size_t i = 0; i < MESSAGE_COUNT; i++)
+        {
+            if (static_cast<std::size_t>(MESSAGE_CATALOG[i].id) != i)
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    static_assert(sizeof(MESSAGE_CATALOG) / sizeof(MESSAGE_CATALOG[0]) == MESSAGE_COUNT,
+                  "MESSAGE_CATALOG must have one entry per MessageId");
+    static_assert(isMessageCatalogOrdered(), "MESSAGE_CATALOG must be in MessageId order");
+}
+
+#endif
@@ -0,0 +1,93 @@
+#ifndef MONEY_HPP
+#define MONEY_HPP
+
+#include <cstdint>
+#include <optional>
+#include <ostream>
+#include <stdexcept>
+
+namespace ATMSystem
+{
+    // Fixed-point KRW amount. The won has no minor unit in circulation, so
+    // the raw value counts whole won. Arithmetic is overflow-checked: the
+    // try* helpers report overflow, the operators throw std::overflow_error.
+    class Money
+    {
+    private:
+        std::int64_t won = 0;
+
+    public:
+        constexpr Money() = default;
+        constexpr explicit Money(std::int64_t amount) : won(amount) {}
+
+        static constexpr Money fromWon(std::int64_t amount) { return Money(amount); }
+        constexpr std::int64_t toWon() const { return won; }
+
+        constexpr bool isZero() const { return won == 0; }
+        constexpr bool isPositive() const { return won > 0; }
+        constexpr bool isNegative() const { return won < 0; }
+
+        std::optional<Money> tryAdd(Money other) const
+        {
+            std::int64_t result;
+            if (__builtin_add_overflow(won, other.won, &result))
+                return std::nullopt;
+            return Money(result);
+        }
+
+        std::optional<Money> trySubtract(Money other) const
+        {
+            std::int64_t result;
+            if (__builtin_sub_overflow(won, other.won, &result))
+                return std::nullopt;
+            return Money(result);
+        }
+
+        std::optional<Money> tryMultiply(std::int64_t factor) const
+        {
+            std::int64_t result;
+            if (__builtin_mul_overflow(won, factor, &result))
+                return std::nullopt;
+            return Money(result);
+        }
+
+        Money operator+(Money other) const
+        {
+            if (auto result = tryAdd(other))
+                return *result;
+            throw std::overflow_error("Money addition overflow");
+        }
+
+        Money operator-(Money other) const
+        {
+            if (auto result = trySubtract(other))
+                return *result;
+            throw std::overflow_error("Money subtraction overflow");
+        }
+
+        Money operator*(std::int64_t factor) const
+        {
+            if (auto result = tryMultiply(factor))
+                return *result;
+            throw std::overflow_error("Money multiplication overflow");
+        }
+
+        Money operator-() const { return Money() - *this; }
+        Money &operator+=(Money other) { return *this = *this + other; }
+        Money &operator-=(Money other) { return *this = *this - other; }
+
+        constexpr bool operator==(Money other) const { return won == other.won; }
+        constexpr bool operator!=(Money other) const { return won != other.won; }
+        constexpr bool operator<(Money other) const { return won < other.won; }
+        constexpr bool operator<=(Money other) const { return won <= other.won; }
+        constexpr bool operator>(Money other) const { return won > other.won; }
+        constexpr bool operator>=(Money other) const { return won >= other.won; }
+    };
+
+    inline std::ostream &operator<<(std::ostream &os, Money amount)
+    {
+        return os << amount.toWon();
+    }
+}
+
+#endif
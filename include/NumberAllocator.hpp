@@ -0,0 +1,55 @@
+#ifndef NUMBER_ALLOCATOR_HPP
+#define NUMBER_ALLOCATOR_HPP
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <optional>
+#include <string>
+
+namespace ATMSystem
+{
+    // Hands out unique, scattered numbers from a fixed-width decimal space
+    // (12-digit accounts, 6-digit serials) without a lookup set or retries.
+    // The n-th allocation is a keyed permutation of n: a Feistel network
+    // over the two halves of the digits, so every index maps to a distinct
+    // number and the whole space is used before allocation fails.
+    class NumberAllocator
+    {
+    private:
+        static constexpr int ROUNDS = 6;
+
+        int digits;
+        std::uint64_t radix;    // 10^(digits / 2); one Feistel half
+        std::uint64_t capacity; // radix * radix == 10^digits
+        std::array<std::uint64_t, ROUNDS> roundKeys;
+        std::atomic<std::uint64_t> nextIndex{0};
+
+    public:
+        static std::uint64_t randomKey();
+
+        // digits must be even and at most 18; a fixed key repeats the sequence
+        explicit NumberAllocator(int digits, std::uint64_t key = randomKey());
+
+        NumberAllocator(const NumberAllocator &) = delete;
+        NumberAllocator &operator=(const NumberAllocator &) = delete;
+
+        // Thread-safe; nullopt once all 10^digits numbers are handed out
+        std::optional<std::uint64_t> allocate();
+        // Zero-padded to the full width; nullopt once exhausted
+        std::optional<std::string> allocateString();
+        // Claims count consecutive indices in one step so a worker can turn
+        // them into numbers with permute() without touching the counter.
+        // nullopt, claiming nothing, when fewer than count remain.
+        std::optional<std::uint64_t> allocateRange(std::uint64_t count);
+
+        // The permutation itself: distinct indices give distinct numbers
+        std::uint64_t permute(std::uint64_t index) const;
+
+        std::string format(std::uint64_t number) const;
+        int getDigits() const { return digits; }
+        std::uint64_t getCapacity() const { return capacity; }
+    };
+}
+
+#endif
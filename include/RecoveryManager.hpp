@@ -0,0 +1,99 @@
+#ifndef RECOVERY_MANAGER_HPP
+#define RECOVERY_MANAGER_HPP
+
+#include <string>
+#include <vector>
+#include <memory>
+#include <unordered_map>
+#include <cstdint>
+#include "Bank.hpp"
+#include "ATM.hpp"
+#include "TransactionJournal.hpp"
+#include "TransactionId.hpp"
+
+namespace ATMSystem
+{
+    // Rebuilds balances, cash cassettes and the transaction id sequence from
+    // the ATM journals after a restart. A checkpoint file stores every
+    // balance together with the journal positions it covers, so replay only
+    // reads the records written after it. Balances are stored per bank name;
+    // a checkpoint whose banks do not match the running ones is ignored and
+    // the journals are replayed from the start.
+    class RecoveryManager
+    {
+    public:
+        // journal records between automatic checkpoints
+        static constexpr std::uint64_t CHECKPOINT_INTERVAL = 1024;
+        // journal records routed to banks before they are replayed
+        static constexpr size_t REPLAY_BATCH = 65536;
+
+        struct Result
+        {
+            size_t restoredBalances = 0;
+            std::uint64_t replayedRecords = 0;
+            size_t restoredATMs = 0;
+            // records skipped because an amount or balance was out of range
+            std::vector<TransactionId> invalidRecords;
+        };
+
+        RecoveryManager(const std::string &directory,
+                        const std::vector<std::shared_ptr<Bank>> &banks,
+                        const std::vector<std::shared_ptr<ATM>> &atms);
+
+        // Loads the checkpoint and replays newer journal records. The journals
+        // are read once; each bank replays its own records on a worker pool.
+        // Must run before any new transaction is recorded.
+        Result recover();
+
+        // True when the journals hold records the running state has not
+        // applied: any record at all, or only records past the checkpoint
+        // when the state was restored together with it. Checkpointing such
+        // a state would make a later recover() skip those records.
+        bool hasUnappliedRecords(bool stateMatchesCheckpoint) const;
+
+        // Writes balances and journal positions. Must be taken while no
+        // transaction is in progress; the file is replaced atomically.
+        bool writeCheckpoint();
+        // Writes a checkpoint once CHECKPOINT_INTERVAL records were appended
+        bool maybeCheckpoint();
+
+    private:
+        struct CheckpointHeader
+        {
+            char magic[8];
+            std::uint32_t version;
+            std::uint32_t journalCount;
+            std::uint32_t bankCount;
+            std::uint32_t reserved;
+        };
+
+        struct JournalMark
+        {
+            char serial[24]; // zero-padded
+            JournalPosition position;
+        };
+
+        struct BalanceEntry
+        {
+            AccountKey key;
+            std::int64_t won;
+        };
+
+        static constexpr char MAGIC[8] = {'A', 'T', 'M', 'C', 'K', 'P', 'T', '\0'};
+        static constexpr std::uint32_t VERSION = 2;
+
+        std::string directory;
+        const std::vector<std::shared_ptr<Bank>> &banks;
+        const std::vector<std::shared_ptr<ATM>> &atms;
+        std::uint64_t appendsAtCheckpoint = 0;
+
+        // Reads the header and journal marks; false if the file is not a
+        // checkpoint of this version
+        static bool readMarks(const char *&cursor, const char *end, CheckpointHeader &header,
+                              std::unordered_map<std::string, JournalPosition> &marks);
+        std::string checkpointPath() const { return directory + "/checkpoint.bin"; }
+        std::uint64_t totalAppends() const;
+    };
+}
+
+#endif
@@ -17,9 +17,8 @@ namespace ATMSystem
     class Session
     {
     private:
-        static std::atomic<uint64_t> nextTransactionId;
         std::string sessionId;
-        std::string cardNumber;
+        AccountKey cardNumber;
         std::shared_ptr<Account> account;
         std::vector<Transaction> transactions;
         std::chrono::system_clock::time_point startTime;
@@ -40,15 +39,18 @@ namespace ATMSystem
                               cardError(false), systemError(false) {}
         } status;
 
-        std::string generateTransactionId();
-
     public:
         Session(const std::string &card, std::shared_ptr<Account> acc, std::shared_ptr<ATM> atmPtr);
         virtual ~Session() = default;
 
         // Transaction management
-        std::string addTransaction(TransactionType type, double amount,
-                                   double fee = 0, const std::string &details = "");
+        // Journals an operation that has already been applied and returns its
+        // id, or 0 when nothing was recorded (session over or the journal
+        // write failed); the caller must then undo the operation
+        TransactionId addTransaction(TransactionType type, Money amount, Money fee,
+                                     TransactionChannel channel,
+                                     AccountKey counterparty = NO_ACCOUNT_KEY,
+                                     std::uint32_t counterpartyBank = 0);
 
         // Session control
         void endSession(const std::string &reason = "");
@@ -0,0 +1,126 @@
+#ifndef SYSTEM_IMAGE_HPP
+#define SYSTEM_IMAGE_HPP
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <memory>
+#include <cstdint>
+#include "AccountNumber.hpp"
+
+namespace ATMSystem
+{
+    class Bank;
+    class ATM;
+    class AccountDirectory;
+    class TransactionHistoryStore;
+
+    // Binary image of the whole network: banks, accounts with balances, PINs
+    // and owners, and ATMs with their connected banks and cassettes. The file
+    // is written to a temporary name and renamed into place. Loading maps it
+    // read-only and creates only the banks and ATMs; each bank keeps a slice
+    // of key-sorted account records and materializes an account the first
+    // time it is looked up, so startup cost does not grow with the accounts.
+    class SystemImage : public std::enable_shared_from_this<SystemImage>
+    {
+    public:
+        struct AccountRecord
+        {
+            AccountKey key;
+            std::int64_t balance;
+            std::uint64_t userOffset; // into the string pool
+            std::uint32_t userLength;
+            char pin[4];
+        };
+
+        // Writes every bank, account and ATM to path. Fails rather than
+        // truncate a PIN that does not fit the record.
+        static bool save(const std::string &path,
+                         const std::vector<std::shared_ptr<Bank>> &banks,
+                         const std::vector<std::shared_ptr<ATM>> &atms);
+        // Maps path; nullptr when it is missing or not a compatible image
+        static std::shared_ptr<SystemImage> open(const std::string &path);
+
+        ~SystemImage();
+        SystemImage(const SystemImage &) = delete;
+        SystemImage &operator=(const SystemImage &) = delete;
+
+        // Creates the banks, backed by this image, and the ATMs. The directory
+        // resolves not yet materialized accounts through the image.
+        void restore(const std::shared_ptr<AccountDirectory> &directory,
+                     const std::shared_ptr<TransactionHistoryStore> &historyStore,
+                     std::vector<std::shared_ptr<Bank>> &banks,
+                     std::vector<std::shared_ptr<ATM>> &atms) const;
+
+        // Record of key in bank, by binary search; nullptr when absent
+        const AccountRecord *findAccount(std::uint32_t bank, AccountKey key) const;
+        const AccountRecord *accountsBegin(std::uint32_t bank) const;
+        const AccountRecord *accountsEnd(std::uint32_t bank) const;
+        std::string_view getUserName(const AccountRecord &record) const;
+
+        std::uint32_t getBankCount() const { return header().bankCount; }
+        std::uint64_t getAccountCount() const { return header().accountCount; }
+
+    private:
+        struct Header
+        {
+            char magic[8];
+            std::uint32_t version;
+            std::uint32_t bankCount;
+            std::uint32_t atmCount;
+            std::uint32_t connectionCount;
+            std::uint64_t accountCount;
+            std::uint64_t stringBytes;
+        };
+
+        struct BankRecord
+        {
+            std::uint64_t firstAccount;
+            std::uint64_t accountCount;
+            std::uint64_t nameOffset;
+            std::uint32_t nameLength;
+            std::uint32_t reserved;
+        };
+
+        struct ATMRecord
+        {
+            char serial[24]; // zero-padded
+            std::uint32_t primaryBank;
+            std::uint32_t firstConnection;
+            std::uint32_t connectionCount;
+            std::uint8_t type;
+            std::uint8_t language;
+            std::uint16_t reserved;
+            std::int32_t cash[4]; // CASH_DENOMINATIONS order
+        };
+
+        static constexpr char MAGIC[8] = {'A', 'T', 'M', 'I', 'M', 'A', 'G', '\0'};
+        static constexpr std::uint32_t VERSION = 1;
+
+        // section start offsets, all 8-byte aligned
+        struct Layout
+        {
+            size_t banks;
+            size_t atms;
+            size_t connections;
+            size_t accounts;
+            size_t strings;
+            size_t end;
+        };
+
+        const char *data = nullptr;
+        size_t size = 0;
+        Layout layout{};
+
+        SystemImage() = default;
+
+        static Layout layoutFor(const Header &header);
+
+        const Header &header() const { return *reinterpret_cast<const Header *>(data); }
+        const BankRecord &bankRecord(std::uint32_t bank) const;
+        const ATMRecord &atmRecord(std::uint32_t atm) const;
+        std::string_view text(std::uint64_t offset, std::uint32_t length) const;
+    };
+}
+
+#endif
@@ -6,6 +6,8 @@
 #include "ATM.hpp"
 #include "Bank.hpp"
 #include "Account.hpp"
+#include "TransactionHistoryStore.hpp"
+#include "NumberAllocator.hpp"
 
 namespace ATMSystem
 {
@@ -15,8 +17,13 @@ namespace ATMSystem
         UI &ui;
         std::vector<std::shared_ptr<ATM>> atms;
         std::vector<std::shared_ptr<Bank>> banks;
+        std::shared_ptr<AccountDirectory> accountDirectory;
+        std::shared_ptr<TransactionHistoryStore> historyStore;
+        NumberAllocator accountNumbers;
+        NumberAllocator serialNumbers;
 
         // Private helper methods
+        std::string generateAccountNumber();
         std::string generateSerialNumber();
         void initializeBanks();
         void initializeATMs();
@@ -24,12 +31,25 @@ namespace ATMSystem
 
     public:
         void initializeSystem();
+        // Non-interactive setup from a provisioning file; see SystemProvisioner
+        bool provisionFromFile(const std::string &path);
+        // Restores the network from a SystemImage; false when path holds none
+        bool restoreFromImage(const std::string &path);
+        bool saveImage(const std::string &path) const;
 
-        explicit SystemInitializer(UI &ui) : ui(ui) {}
+        // A fixed numberSeed repeats the generated account and serial numbers
+        explicit SystemInitializer(UI &ui, std::uint64_t numberSeed = NumberAllocator::randomKey())
+            : ui(ui),
+              accountDirectory(std::make_shared<AccountDirectory>()),
+              historyStore(std::make_shared<TransactionHistoryStore>()),
+              accountNumbers(static_cast<int>(ACCOUNT_NUMBER_LENGTH), numberSeed),
+              serialNumbers(static_cast<int>(ATM_SERIAL_LENGTH), numberSeed) {}
 
         // Getters
         const std::vector<std::shared_ptr<ATM>> &getATMs() const;
         const std::vector<std::shared_ptr<Bank>> &getBanks() const;
+        const std::shared_ptr<AccountDirectory> &getAccountDirectory() const { return accountDirectory; }
+        const std::shared_ptr<TransactionHistoryStore> &getHistoryStore() const { return historyStore; }
     };
 }
 
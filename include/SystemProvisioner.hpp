@@ -0,0 +1,110 @@
+#ifndef SYSTEM_PROVISIONER_HPP
+#define SYSTEM_PROVISIONER_HPP
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <memory>
+#include <unordered_map>
+#include <atomic>
+#include "ATM.hpp"
+#include "Bank.hpp"
+#include "AccountDirectory.hpp"
+#include "TransactionHistoryStore.hpp"
+#include "NumberAllocator.hpp"
+#include "WorkerPool.hpp"
+
+namespace ATMSystem
+{
+    // Builds a network from a provisioning file instead of prompts. The file
+    // is mapped and read line by line; fields are separated by spaces or tabs
+    // and '#' starts a comment line:
+    //
+    //   bank <name> [expected-accounts]
+    //   account <bank> <user> <account-number> <pin> [opening-balance]
+    //   accounts <bank> <count> <pin> [opening-balance]
+    //   atm <serial> <single|multi> <uni|bi> <primary-bank> <1000s> <5000s> <10000s> <50000s>
+    //
+    // "accounts" generates count accounts named <bank>-1, <bank>-2, ... with
+    // numbers from the account NumberAllocator. Accounts are built in batches
+    // on a worker pool while the file is still being read: listed accounts
+    // are batched per bank, generated ones are split into index ranges that
+    // each worker turns into numbers on its own. Batches of one bank may land
+    // in any order, so when a number is listed twice either line may win.
+    // Banks are reserved up front when a size is given. ATMs are created once
+    // every batch is in; an "atm" line names only its primary bank, and a
+    // multi-bank ATM connects to every bank in the file.
+    class SystemProvisioner
+    {
+    public:
+        static constexpr size_t ACCOUNT_BATCH_SIZE = 65536;
+
+        struct Counts
+        {
+            size_t banks = 0;
+            size_t accounts = 0;
+            size_t atms = 0;
+            size_t skippedAccounts = 0; // invalid or duplicate account lines
+        };
+
+        SystemProvisioner(std::vector<std::shared_ptr<Bank>> &banks,
+                          std::vector<std::shared_ptr<ATM>> &atms,
+                          std::shared_ptr<AccountDirectory> accountDirectory,
+                          std::shared_ptr<TransactionHistoryStore> historyStore,
+                          NumberAllocator &accountNumbers);
+
+        // false on an unreadable file or a malformed line; see getErrorLine
+        bool load(const std::string &path);
+
+        const Counts &getCounts() const { return counts; }
+        size_t getErrorLine() const { return errorLine; }
+
+    private:
+        struct BankEntry
+        {
+            std::shared_ptr<Bank> bank;
+            std::vector<AccountSpec> pending;
+            size_t generated = 0; // ordinal of the last generated account
+        };
+
+        struct ATMSpec
+        {
+            std::string serial;
+            BankType type;
+            LanguageSupport language;
+            size_t primaryBank;
+            std::map<int, int> cash;
+        };
+
+        std::vector<std::shared_ptr<Bank>> &banks;
+        std::vector<std::shared_ptr<ATM>> &atms;
+        std::shared_ptr<AccountDirectory> accountDirectory;
+        std::shared_ptr<TransactionHistoryStore> historyStore;
+        NumberAllocator &accountNumbers;
+
+        std::unique_ptr<WorkerPool> pool; // alive while load() runs
+        std::atomic<size_t> createdAccounts{0};
+        std::atomic<size_t> skippedAccounts{0};
+
+        std::vector<BankEntry> entries;
+        std::unordered_map<std::string, size_t> bankIndex;
+        std::vector<ATMSpec> atmSpecs;
+        Counts counts;
+        size_t expectedAccounts = 0; // sum of the bank size hints
+        size_t errorLine = 0;
+        std::vector<std::string_view> fields; // current line, reused across lines
+
+        bool parseLine(std::string_view line);
+        bool addBank(const std::vector<std::string_view> &fields);
+        bool addAccount(const std::vector<std::string_view> &fields);
+        bool addGeneratedAccounts(const std::vector<std::string_view> &fields);
+        bool addATM(const std::vector<std::string_view> &fields);
+        void flushAccounts(BankEntry &entry);
+        void createAccounts(Bank &bank, const std::vector<AccountSpec> &batch, size_t alreadySkipped);
+        void generateAccounts(const std::shared_ptr<Bank> &bank, std::uint64_t firstIndex, size_t count,
+                              size_t firstOrdinal, const std::string &pin, Money balance);
+        void createATMs();
+    };
+}
+
+#endif
@@ -4,31 +4,63 @@
 #include <memory>
 #include <vector>
 #include <string>
+#include <string_view>
+#include <optional>
 #include "ATM.hpp"
 #include "Bank.hpp"
 
 namespace ATMSystem
 {
+    // Which part of the network a snapshot shows; unset fields match everything
+    struct SnapshotFilter
+    {
+        static constexpr size_t DEFAULT_PAGE_SIZE = 20;
+
+        std::string bank;          // accounts of this bank, ATMs it is primary for
+        std::string accountPrefix; // leading account number digits
+        std::optional<Money> minBalance;
+        std::optional<Money> maxBalance;
+        std::optional<Money> cashBelow; // ATMs holding less cash than this
+        size_t top = 0;                 // only the N largest balances, highest first
+        size_t pageSize = DEFAULT_PAGE_SIZE; // 0 prints without pausing
 
+        bool matches(const Account &account) const;
+        bool matches(const ATM &atm) const;
+
+        // Parses "key=value" words as typed after the '/' command, e.g.
+        // "bank=Kakao min=10000 top=5"; false on an unknown key or bad value
+        static bool parse(std::string_view arguments, SnapshotFilter &filter);
+    };
+
+    // Prints ATMs and accounts matching a filter straight from bank storage.
+    // Accounts are streamed through a cursor and shown a page at a time, so
+    // large networks are neither copied nor dumped in one go.
     class SystemSnapshot
     {
     private:
         const std::vector<std::shared_ptr<ATM>> &atms;
         const std::vector<std::shared_ptr<Bank>> &banks;
 
-        // Helper methods
-        std::string formatATMInfo(const std::shared_ptr<ATM> &atm) const;
-        std::string formatCashInventory(const std::map<int, int> &inventory) const;
-        std::string formatAccountInfo(const std::shared_ptr<Account> &account, const std::string &bankName) const;
+        UI ui;
+
+        // Helper methods; each appends to a caller-owned line buffer
+        void appendATMInfo(std::string &out, const std::shared_ptr<ATM> &atm) const;
+        void appendCashInventory(std::string &out, const std::map<int, int> &inventory) const;
+        void appendAccountInfo(std::string &out, const std::shared_ptr<Account> &account, const std::string &bankName) const;
+
+        // false when the admin stops paging
+        bool continuePaging(size_t shown) const;
+        void displayAccounts(const SnapshotFilter &filter) const;
+        void displayTopAccounts(const SnapshotFilter &filter) const;
 
     public:
         SystemSnapshot(const std::vector<std::shared_ptr<ATM>> &atms,
                        const std::vector<std::shared_ptr<Bank>> &banks)
-            : atms(atms), banks(banks) {}
+            : atms(atms), banks(banks), ui(false) {}
 
-        void displaySnapshot() const;
+        void displaySnapshot(const SnapshotFilter &filter = {}) const;
     };
 
 }
 
-#endif
\ No newline at end of file
+#endif
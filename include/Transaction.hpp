@@ -3,38 +3,65 @@
 
 #include <string>
 #include <chrono>
+#include <cstdint>
+#include <type_traits>
 #include "Constants.hpp"
+#include "Money.hpp"
+#include "AccountNumber.hpp"
+#include "TransactionId.hpp"
 
 namespace ATMSystem
 {
+    class UI;
+
+    // Fixed-size, trivially copyable transaction record. Identifiers are kept
+    // numerically; the readable ID and details text are rendered on demand.
     class Transaction
     {
     private:
-        std::string transactionId;
-        std::string cardNumber;
-        TransactionType type;
-        double amount;
-        double fee;
+        TransactionId transactionId;
+        AccountKey cardNumber;
+        AccountKey counterpartyAccount; // NO_ACCOUNT_KEY when there is none
         std::chrono::system_clock::time_point timestamp;
-        std::string details;
+        Money amount;
+        Money fee;
+        std::uint32_t counterpartyBank;
+        TransactionType type;
+        TransactionChannel channel;
+        std::uint16_t reserved; // fills the tail so journaled bytes are all defined
 
     public:
-        Transaction(const std::string &id, const std::string &card,
-                    TransactionType transType, double amt,
-                    double transactionFee = 0, const std::string &transDetails = "");
+        // leaves the fields uninitialised, like any POD; used for buffers
+        Transaction() = default;
+        Transaction(TransactionId id, AccountKey card,
+                    TransactionType transType, Money amt,
+                    Money transactionFee = Money(),
+                    TransactionChannel transChannel = TransactionChannel::CASH,
+                    AccountKey counterparty = NO_ACCOUNT_KEY,
+                    std::uint32_t counterpartyBankId = 0);
 
         // Getters
-        std::string getTransactionId() const { return transactionId; }
-        std::string getCardNumber() const { return cardNumber; }
+        TransactionId getTransactionId() const { return transactionId; }
+        AccountKey getCardNumber() const { return cardNumber; }
+        AccountKey getCounterpartyAccount() const { return counterpartyAccount; }
+        std::uint32_t getCounterpartyBank() const { return counterpartyBank; }
         TransactionType getType() const { return type; }
-        double getAmount() const { return amount; }
-        double getFee() const { return fee; }
-        std::string getDetails() const { return details; }
+        TransactionChannel getChannel() const { return channel; }
+        Money getAmount() const { return amount; }
+        Money getFee() const { return fee; }
         std::chrono::system_clock::time_point getTimestamp() const { return timestamp; }
 
+        // Rendering helpers
+        std::string formatTransactionId() const { return ATMSystem::formatTransactionId(transactionId); }
+        std::string formatCardNumber() const { return formatAccountNumber(cardNumber); }
+        std::string getDetails(const UI &ui) const;
         std::string getTypeString() const;
         std::string getFormattedTimestamp() const;
     };
+
+    static_assert(std::is_trivially_copyable_v<Transaction>, "Transaction must stay a flat record");
+    static_assert(std::has_unique_object_representations_v<Transaction>,
+                  "Transaction must have no padding; its bytes are written to the journal");
 }
 
-#endif
\ No newline at end of file
+#endif
@@ -0,0 +1,76 @@
+#ifndef TRANSACTION_AGGREGATES_HPP
+#define TRANSACTION_AGGREGATES_HPP
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <mutex>
+#include "Transaction.hpp"
+#include "Money.hpp"
+
+namespace ATMSystem
+{
+    struct AggregateTotals
+    {
+        std::uint64_t count = 0;
+        Money amount;
+        Money fee;
+    };
+
+    struct AggregateSnapshot
+    {
+        std::array<AggregateTotals, 4> byType; // indexed by TransactionType
+        Money cashIn;                           // cash deposits and cash transfers
+        Money cashOut;                          // withdrawals
+
+        const AggregateTotals &operator[](TransactionType type) const { return byType[static_cast<size_t>(type)]; }
+    };
+
+    // Running totals of the transactions recorded at one ATM or bank, kept
+    // for the whole run and per hour over the last day. Every counter is an
+    // atomic updated in place, so recording never waits for a reader and a
+    // reader costs a fixed number of loads however long the history is.
+    class TransactionAggregates
+    {
+    public:
+        static constexpr std::chrono::hours BUCKET_SPAN{1};
+        static constexpr size_t BUCKET_COUNT = 24;
+
+        void record(const Transaction &transaction);
+
+        AggregateSnapshot getTotals() const;
+        // Totals of the buckets that started within the last window, up to BUCKET_COUNT
+        AggregateSnapshot getRecent(std::chrono::hours window) const;
+
+    private:
+        static constexpr size_t TYPE_COUNT = 4;
+
+        struct Counters
+        {
+            std::array<std::atomic<std::uint64_t>, TYPE_COUNT> count{};
+            std::array<std::atomic<std::int64_t>, TYPE_COUNT> amount{};
+            std::array<std::atomic<std::int64_t>, TYPE_COUNT> fee{};
+            std::atomic<std::int64_t> cashIn{0};
+            std::atomic<std::int64_t> cashOut{0};
+
+            void add(const Transaction &transaction);
+            void reset();
+            void addTo(AggregateSnapshot &snapshot) const;
+        };
+
+        struct Bucket
+        {
+            std::atomic<std::int64_t> hour{-1}; // hours since the epoch held here
+            Counters counters;
+        };
+
+        Counters totals;
+        std::array<Bucket, BUCKET_COUNT> buckets;
+        std::mutex rolloverMutex; // only taken when a bucket starts a new hour
+
+        static std::int64_t hourOf(std::chrono::system_clock::time_point time);
+    };
+}
+
+#endif
@@ -0,0 +1,86 @@
+#ifndef TRANSACTION_EXPORTER_HPP
+#define TRANSACTION_EXPORTER_HPP
+
+#include <string>
+#include <string_view>
+#include <optional>
+#include <chrono>
+#include <cstdint>
+#include "Transaction.hpp"
+
+namespace ATMSystem
+{
+    enum class ExportFormat : std::uint8_t
+    {
+        CSV,
+        JSON_LINES,
+        BINARY
+    };
+
+    struct ExportOptions
+    {
+        ExportFormat format = ExportFormat::CSV;
+        std::string path;
+        // half-open range [from, to) on the transaction timestamp
+        std::chrono::system_clock::time_point from = std::chrono::system_clock::time_point::min();
+        std::chrono::system_clock::time_point to = std::chrono::system_clock::time_point::max();
+    };
+
+    // Streams transactions to a file. Rows are formatted straight into one
+    // large reusable buffer, which goes out with a single write() whenever it
+    // fills, so output speed is bound by the disk. Timestamps are UTC ISO
+    // 8601; machine formats use stable type codes rather than localized text.
+    // The binary format is a 16-byte header followed by raw Transaction
+    // records, as stored in the journal.
+    class TransactionExporter
+    {
+    public:
+        static constexpr size_t BUFFER_SIZE = 1 << 20;
+
+        explicit TransactionExporter(ExportOptions options);
+        ~TransactionExporter();
+
+        TransactionExporter(const TransactionExporter &) = delete;
+        TransactionExporter &operator=(const TransactionExporter &) = delete;
+
+        bool open();
+        // Adds the row if it falls inside the time range
+        bool write(const Transaction &transaction);
+        // Flushes and closes the file; false if any write failed
+        bool finish();
+
+        bool inRange(const Transaction &transaction) const
+        {
+            return transaction.getTimestamp() >= options.from && transaction.getTimestamp() < options.to;
+        }
+        std::uint64_t getRowCount() const { return rowCount; }
+        const ExportOptions &getOptions() const { return options; }
+
+        // "YYYY-MM-DD" in local time; endOfDay gives the following midnight
+        static std::optional<std::chrono::system_clock::time_point> parseDate(std::string_view text, bool endOfDay);
+
+    private:
+        static constexpr char BINARY_MAGIC[8] = {'A', 'T', 'M', 'X', 'P', 'R', 'T', '\0'};
+
+        ExportOptions options;
+        int fd = -1;
+        bool failed = false;
+        std::uint64_t rowCount = 0;
+        std::string buffer;
+
+        // UTC timestamp of the last row, reused while the second is unchanged
+        std::int64_t cachedSecond = -1;
+        char cachedTimestamp[19]; // without the trailing Z
+        // same for the local-time "YYYYMMDD-HHMMSS-" prefix of transaction ids
+        std::int64_t cachedIdSecond = -1;
+        std::string cachedIdPrefix;
+
+        bool flush();
+        void appendTimestamp(const Transaction &transaction);
+        void appendId(const Transaction &transaction);
+        void appendCsv(const Transaction &transaction);
+        void appendJson(const Transaction &transaction);
+    };
+}
+
+#endif
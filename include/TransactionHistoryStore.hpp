@@ -0,0 +1,159 @@
+#ifndef TRANSACTION_HISTORY_STORE_HPP
+#define TRANSACTION_HISTORY_STORE_HPP
+
+#include <array>
+#include <vector>
+#include <string>
+#include <optional>
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
+#include <unordered_map>
+#include <iterator>
+#include <limits>
+#include <cstdint>
+#include "Transaction.hpp"
+#include "TransactionJournal.hpp"
+
+namespace ATMSystem
+{
+    struct HistoryQuery
+    {
+        std::optional<AccountKey> card;
+        std::optional<TransactionType> type;
+        // half-open range [from, to) on the transaction timestamp
+        std::chrono::system_clock::time_point from = std::chrono::system_clock::time_point::min();
+        std::chrono::system_clock::time_point to = std::chrono::system_clock::time_point::max();
+    };
+
+    // Queryable history of every ATM. The records themselves stay in the ATM
+    // journals; the store keeps only where each one is and its timestamp,
+    // with posting lists over every record, by card, by type and by card and
+    // type, plus the first posting of each hourly time bucket. Concurrent
+    // ATMs commit slightly out of timestamp order, so every posting list is
+    // kept sorted by timestamp as records arrive. A query picks the narrowest
+    // list and binary-searches the time range inside it, so its cost follows
+    // the result size rather than the history size.
+    class TransactionHistoryStore
+    {
+    public:
+        static constexpr std::chrono::hours BUCKET_SPAN{1};
+        static constexpr size_t TYPE_COUNT = 4;
+        // positions are 32-bit; records past this are not indexed
+        static constexpr size_t MAX_RECORDS = std::numeric_limits<std::uint32_t>::max();
+
+        // Read-only window onto query results. It holds the store's read
+        // lock, so new records wait until the view is gone; keep it short-lived.
+        // Records are read from the journals as the view is iterated.
+        class View
+        {
+        public:
+            class iterator
+            {
+            public:
+                using iterator_category = std::input_iterator_tag;
+                using value_type = Transaction;
+                using difference_type = std::ptrdiff_t;
+                using pointer = const Transaction *;
+                using reference = Transaction;
+
+                iterator(const TransactionHistoryStore *store, const std::uint32_t *position)
+                    : store(store), position(position) {}
+
+                Transaction operator*() const { return store->readRecord(*position); }
+                iterator &operator++()
+                {
+                    ++position;
+                    return *this;
+                }
+                bool operator==(const iterator &other) const { return position == other.position; }
+                bool operator!=(const iterator &other) const { return position != other.position; }
+
+            private:
+                const TransactionHistoryStore *store;
+                const std::uint32_t *position;
+            };
+
+            iterator begin() const { return iterator(store, first); }
+            iterator end() const { return iterator(store, last); }
+            size_t size() const { return static_cast<size_t>(last - first); }
+            bool empty() const { return first == last; }
+
+        private:
+            friend class TransactionHistoryStore;
+
+            std::shared_lock<std::shared_mutex> lock;
+            const TransactionHistoryStore *store = nullptr;
+            const std::uint32_t *first = nullptr;
+            const std::uint32_t *last = nullptr;
+        };
+
+        // Indexes a record committed to journal at position, as reported by
+        // GroupCommitWriter::commit. False when the store is full.
+        bool add(const Transaction &transaction, const TransactionJournal &journal, JournalPosition position);
+        // Indexes every record found in the journals of directory
+        void loadJournals(const std::string &directory);
+
+        View query(const HistoryQuery &query) const;
+        size_t size() const;
+
+    private:
+        static constexpr size_t MAX_MAPPED_SEGMENTS = 16;
+
+        // one indexed record: its timestamp and where its bytes are
+        struct Entry
+        {
+            std::int64_t ticks;
+            std::uint32_t journal;
+            std::uint32_t segment;
+            std::uint32_t record;
+        };
+
+        struct Bucket
+        {
+            std::int64_t start; // bucket number since the epoch
+            std::uint32_t first; // index into everything
+        };
+
+        struct MappedSegment
+        {
+            std::uint64_t key; // journal << 32 | segment
+            std::unique_ptr<TransactionJournal::SegmentMap> map;
+        };
+
+        using Postings = std::vector<std::uint32_t>;
+
+        mutable std::shared_mutex mutex;
+        std::vector<Entry> entries; // arrival order; positions index this
+        Postings everything;        // every position in timestamp order
+        std::unordered_map<AccountKey, Postings> byCard;
+        std::unordered_map<std::uint64_t, Postings> byCardAndType;
+        std::array<Postings, TYPE_COUNT> byType;
+        std::vector<Bucket> buckets;
+
+        // journals by "directory/serial"; entries refer to them by index
+        std::vector<std::pair<std::string, std::string>> journals;
+        std::unordered_map<std::string, std::uint32_t> journalIndex;
+
+        // a few recently read segments stay mapped
+        mutable std::mutex segmentMutex;
+        mutable std::vector<MappedSegment> mappedSegments;
+        mutable size_t nextEviction = 0;
+
+        static std::int64_t bucketOf(std::int64_t ticks);
+        static std::uint64_t cardTypeKey(AccountKey card, TransactionType type)
+        {
+            return card * TYPE_COUNT + static_cast<std::uint64_t>(type);
+        }
+
+        std::uint32_t journalFor(const std::string &directory, const std::string &serial);
+        bool addLocked(const Transaction &transaction, std::uint32_t journal, JournalPosition position);
+        bool before(std::uint32_t a, std::uint32_t b) const;
+        size_t insertSorted(Postings &postings, std::uint32_t position) const;
+        std::uint32_t lowerBound(std::int64_t ticks) const;
+        Transaction readRecord(std::uint32_t position) const;
+    };
+}
+
+#endif
@@ -0,0 +1,52 @@
+#ifndef TRANSACTION_ID_HPP
+#define TRANSACTION_ID_HPP
+
+#include <string>
+#include <atomic>
+#include <cstdint>
+
+namespace ATMSystem
+{
+    // 64-bit transaction ids: the high 32 bits hold the issue time in Unix
+    // seconds, the low 32 bits a sequence number from the issuing thread's
+    // block. Ids are unique and group by second, but neither ids nor their
+    // sequences follow issue order across threads: each thread counts
+    // through its own block. Order records by timestamp instead.
+    using TransactionId = std::uint64_t;
+
+    class TransactionIdGenerator
+    {
+    public:
+        static constexpr unsigned SEQUENCE_BITS = 32;
+        static constexpr std::uint64_t SEQUENCE_MASK = (std::uint64_t(1) << SEQUENCE_BITS) - 1;
+        // sequence numbers each thread claims at once
+        static constexpr std::uint64_t BLOCK_SIZE = 1024;
+
+        // Issues a fresh id. Threads draw from private blocks, so the shared
+        // counter is touched once per BLOCK_SIZE ids.
+        static TransactionId next();
+
+        // Makes later ids use sequence numbers above id's, e.g. after a
+        // journal replay; pass the id with the highest sequence, which need
+        // not be the highest id. Blocks already claimed by threads are
+        // unaffected.
+        static void advancePast(TransactionId id);
+
+        static constexpr TransactionId makeId(std::int64_t seconds, std::uint64_t sequence)
+        {
+            return (static_cast<std::uint64_t>(seconds) << SEQUENCE_BITS) | (sequence & SEQUENCE_MASK);
+        }
+        static constexpr std::int64_t secondsOf(TransactionId id) { return static_cast<std::int64_t>(id >> SEQUENCE_BITS); }
+        static constexpr std::uint64_t sequenceOf(TransactionId id) { return id & SEQUENCE_MASK; }
+
+    private:
+        static std::atomic<std::uint64_t> nextBlock;
+    };
+
+    // Renders id as "YYYYMMDD-HHMMSS-NNNNNN" in local time; sequences past
+    // 999999 print in full
+    void appendTransactionId(std::string &out, TransactionId id);
+    std::string formatTransactionId(TransactionId id);
+}
+
+#endif
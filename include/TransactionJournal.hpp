@@ -0,0 +1,208 @@
+#ifndef TRANSACTION_JOURNAL_HPP
+#define TRANSACTION_JOURNAL_HPP
+
+#include <string>
+#include <vector>
+#include <map>
+#include <mutex>
+#include <atomic>
+#include <functional>
+#include <cstdint>
+#include <cstddef>
+#include "Transaction.hpp"
+
+namespace ATMSystem
+{
+    // A point in a journal: the next record to read is record of segment
+    struct JournalPosition
+    {
+        std::uint32_t segment = 0;
+        std::uint64_t record = 0;
+    };
+
+    // Append-only binary journal of one ATM's transactions. Records are
+    // written as raw Transaction bytes into fixed-capacity segment files
+    // mapped with mmap; a full segment is sealed and the next one started.
+    // Only the active segment, and those filled since the last sync, stay
+    // mapped, so memory use does not grow with history, and the files are
+    // read back directly after a restart.
+    // The active segment header also carries the ATM's current cash
+    // cassette counts, so they survive a crash as well.
+    class TransactionJournal
+    {
+    public:
+        static constexpr size_t DEFAULT_SEGMENT_RECORDS = 4096;
+        static constexpr size_t MAX_CASH_SLOTS = 8;
+
+        TransactionJournal(const std::string &directory, const std::string &atmSerial,
+                           size_t segmentRecords = DEFAULT_SEGMENT_RECORDS);
+        ~TransactionJournal();
+
+        TransactionJournal(const TransactionJournal &) = delete;
+        TransactionJournal &operator=(const TransactionJournal &) = delete;
+
+        bool isOpen() const { return active.map != nullptr; }
+        bool append(const Transaction &transaction) { return appendBatch(&transaction, 1); }
+        // Appends every record or none: the segments a batch needs are opened
+        // before any record is written. positions, if given, receives where
+        // each record went.
+        bool appendBatch(const Transaction *records, size_t count, JournalPosition *positions = nullptr);
+        // Flushes the records appended since the last sync, and the headers,
+        // to disk with fdatasync. If that fails those records are taken back,
+        // so neither readers nor a later recovery see them.
+        bool sync();
+
+        // Stores the cassette counts in the active segment header
+        void recordCash(const std::map<int, int> &inventory);
+        // Cassette counts found in the journal when it was opened
+        const std::map<int, int> &getRecoveredCash() const { return recoveredCash; }
+
+        // Calls fn for every transaction synced before the call, oldest
+        // first. Only the end position is taken under the lock; synced
+        // records never change, so appends continue while fn runs.
+        template <typename Fn>
+        void forEach(Fn &&fn) const
+        {
+            visitSegments(directory, serial, JournalPosition{}, forEachRecord(fn), currentEnd());
+        }
+
+        // Read-only mapping of one segment for reading records by position.
+        // The mapping sees records appended after it was made.
+        class SegmentMap
+        {
+        public:
+            SegmentMap(const std::string &directory, const std::string &serial, std::uint32_t index);
+            ~SegmentMap();
+
+            SegmentMap(const SegmentMap &) = delete;
+            SegmentMap &operator=(const SegmentMap &) = delete;
+
+            bool isOpen() const { return map != nullptr; }
+            // records published so far
+            std::uint64_t getCount() const;
+            // record must be below getCount()
+            const Transaction &operator[](std::uint64_t record) const;
+
+        private:
+            void *map = nullptr;
+            size_t bytes = 0;
+        };
+
+        std::uint32_t getSegmentCount() const;
+        // records appended since the journal was opened
+        std::uint64_t getAppendCount() const { return appendCount.load(std::memory_order_relaxed); }
+        const std::string &getDirectory() const { return directory; }
+        const std::string &getSerial() const { return serial; }
+
+        // Reading journals without an open ATM, e.g. during recovery.
+        // Segments are mapped read-only for the duration of the visit.
+        static std::vector<std::string> listSerials(const std::string &directory);
+        static JournalPosition endPosition(const std::string &directory, const std::string &serial);
+
+        template <typename Fn>
+        static void scan(const std::string &directory, const std::string &serial,
+                         JournalPosition from, Fn &&fn)
+        {
+            visitSegments(directory, serial, from, forEachRecord(fn));
+        }
+
+        // Like scan, but fn also receives each record's position
+        template <typename Fn>
+        static void scanPositions(const std::string &directory, const std::string &serial,
+                                  JournalPosition from, Fn &&fn)
+        {
+            visitSegments(directory, serial, from,
+                          [&fn](const Transaction *records, size_t count, JournalPosition first)
+                          {
+                              for (size_t i = 0; i < count; i++)
+                              {
+                                  fn(records[i], JournalPosition{first.segment, first.record + i});
+                              }
+                          });
+        }
+
+    private:
+        struct CashSlot
+        {
+            std::int32_t denomination;
+            std::int32_t count;
+        };
+
+        struct SegmentHeader
+        {
+            char magic[8];
+            std::uint32_t version;
+            std::uint32_t recordSize;
+            std::uint64_t capacity;
+            std::uint64_t count; // published after the record bytes are written
+            std::uint32_t cashSlotCount;
+            std::uint32_t reserved;
+            CashSlot cash[MAX_CASH_SLOTS];
+        };
+
+        // records, their count and the position of the first one
+        using SegmentVisitor = std::function<void(const Transaction *, size_t, JournalPosition)>;
+
+        static constexpr char MAGIC[8] = {'A', 'T', 'M', 'J', 'R', 'N', 'L', '\0'};
+        static constexpr std::uint32_t VERSION = 2;
+
+        std::string directory;
+        std::string serial;
+        size_t segmentRecords;
+        std::map<int, int> recoveredCash;
+
+        struct Segment
+        {
+            std::uint32_t index = 0;
+            int fd = -1;
+            void *map = nullptr;
+            size_t bytes = 0;
+            bool created = false; // the file did not exist before it was opened
+
+            SegmentHeader *header() const { return static_cast<SegmentHeader *>(map); }
+            Transaction *records() const;
+        };
+
+        mutable std::mutex mutex;
+        Segment active;
+        // segments filled since the last sync; they stay mapped so the next
+        // sync can flush them, or take their records back if it fails
+        std::vector<Segment> unsynced;
+        JournalPosition syncedEnd;
+        std::uint64_t unsyncedCount = 0;
+        std::atomic<std::uint64_t> appendCount{0};
+
+        template <typename Fn>
+        static SegmentVisitor forEachRecord(Fn &fn)
+        {
+            return [&fn](const Transaction *records, size_t count, JournalPosition)
+            {
+                for (size_t i = 0; i < count; i++)
+                {
+                    fn(records[i]);
+                }
+            };
+        }
+
+        static std::string segmentPath(const std::string &directory, const std::string &serial, std::uint32_t index);
+        static bool segmentExists(const std::string &directory, const std::string &serial, std::uint32_t index);
+        static bool isCompatible(const SegmentHeader &header, size_t fileBytes);
+        // visits [from, to); the default end is wherever the files stop
+        static void visitSegments(const std::string &directory, const std::string &serial,
+                                  JournalPosition from, const SegmentVisitor &visit,
+                                  JournalPosition to = {UINT32_MAX, UINT64_MAX});
+        static bool syncDirectory(const std::string &directory);
+        JournalPosition currentEnd() const;
+
+        size_t segmentBytes() const { return sizeof(SegmentHeader) + segmentRecords * sizeof(Transaction); }
+
+        bool openSegment(std::uint32_t index, Segment &segment) const;
+        static void closeSegment(Segment &segment);
+        // closes and deletes a segment whose records are all being taken back
+        void discardSegment(Segment &segment) const;
+        // returns the journal to syncedEnd; the caller holds the lock
+        void rollBack();
+    };
+}
+
+#endif
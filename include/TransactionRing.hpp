@@ -0,0 +1,69 @@
+#ifndef TRANSACTION_RING_HPP
+#define TRANSACTION_RING_HPP
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include "Transaction.hpp"
+
+namespace ATMSystem
+{
+    // Fixed-capacity ring of the most recent transactions. Records are stored
+    // inline and overwritten oldest first, so adding never allocates and
+    // iteration walks at most two contiguous runs, oldest to newest.
+    template <size_t Capacity>
+    class TransactionRing
+    {
+    public:
+        class const_iterator
+        {
+        public:
+            using iterator_category = std::forward_iterator_tag;
+            using value_type = Transaction;
+            using difference_type = std::ptrdiff_t;
+            using pointer = const Transaction *;
+            using reference = const Transaction &;
+
+            const_iterator(const TransactionRing *ring, size_t offset) : ring(ring), offset(offset) {}
+
+            reference operator*() const { return ring->slots[(ring->oldest() + offset) % Capacity]; }
+            pointer operator->() const { return &**this; }
+            const_iterator &operator++()
+            {
+                offset++;
+                return *this;
+            }
+            bool operator==(const const_iterator &other) const { return offset == other.offset; }
+            bool operator!=(const const_iterator &other) const { return offset != other.offset; }
+
+        private:
+            const TransactionRing *ring;
+            size_t offset;
+        };
+
+        void push(const Transaction &transaction)
+        {
+            slots[written % Capacity] = transaction;
+            written++;
+        }
+
+        size_t size() const { return written < Capacity ? static_cast<size_t>(written) : Capacity; }
+        bool empty() const { return written == 0; }
+        static constexpr size_t capacity() { return Capacity; }
+        // every record ever pushed, including those already overwritten
+        std::uint64_t getTotalCount() const { return written; }
+
+        const_iterator begin() const { return const_iterator(this, 0); }
+        const_iterator end() const { return const_iterator(this, size()); }
+        const Transaction &newest() const { return slots[(written - 1) % Capacity]; }
+
+    private:
+        std::array<Transaction, Capacity> slots;
+        std::uint64_t written = 0;
+
+        size_t oldest() const { return written < Capacity ? 0 : static_cast<size_t>(written % Capacity); }
+    };
+}
+
+#endif
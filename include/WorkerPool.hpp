@@ -0,0 +1,50 @@
+#ifndef WORKER_POOL_HPP
+#define WORKER_POOL_HPP
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace ATMSystem
+{
+    // Fixed set of threads draining a bounded job queue. submit blocks while
+    // the queue is full, so a producer that reads faster than the workers
+    // build never holds more than maxQueued jobs in memory. A pool of zero
+    // threads runs each job inside submit instead.
+    class WorkerPool
+    {
+    private:
+        std::mutex mutex;
+        std::condition_variable workAvailable;
+        std::condition_variable spaceAvailable;
+        std::condition_variable idle;
+        std::deque<std::function<void()>> jobs;
+        size_t maxQueued;
+        size_t running = 0;
+        bool stopping = false;
+        std::vector<std::thread> threads;
+
+        void run();
+
+    public:
+        // maxQueued 0 means two per thread
+        explicit WorkerPool(size_t threadCount = defaultThreadCount(), size_t maxQueued = 0);
+        ~WorkerPool();
+
+        WorkerPool(const WorkerPool &) = delete;
+        WorkerPool &operator=(const WorkerPool &) = delete;
+
+        // Jobs must not throw
+        void submit(std::function<void()> job);
+        // Returns once every submitted job has finished
+        void wait();
+
+        size_t getThreadCount() const { return threads.size(); }
+        static size_t defaultThreadCount();
+    };
+}
+
+#endif
@@ -17,45 +17,139 @@ namespace ATMSystem
 
     const int ATM::MAX_PIN_ATTEMPTS = 3;
 
-    ATM::ATM(const std::string &serial, BankType type, LanguageSupport lang, std::shared_ptr<Bank> primary)
+    ATM::ATM(const std::string &serial, BankType type, LanguageSupport lang, std::shared_ptr<Bank> primary,
+             GroupCommitConfig commitConfig)
         : serialNumber(serial),
           bankType(type),
           languageSupport(lang),
           primaryBank(primary),
+          journal(JOURNAL_DIRECTORY, serial),
+          journalWriter(journal, commitConfig),
           ui(lang == LanguageSupport::BILINGUAL)
     {
     }
 
-    void ATM::printTransactionHistory() const
+    bool ATM::addToHistory(const Transaction &transaction)
     {
-        ui.displayMessage("TRANSACTION_HISTORY_HEADER");
+        // returns once the record is on disk
+        JournalPosition position;
+        if (!journalWriter.commit(transaction, &position))
+        {
+            ui.displayMessage(MessageId::ERROR_SYSTEM);
+            return false;
+        }
+
+        aggregates.record(transaction);
+        if (historyStore)
+        {
+            historyStore->add(transaction, journal, position);
+        }
+        return true;
+    }
+
+    void ATM::printHistoryHeader() const
+    {
+        ui.displayMessage(MessageId::TRANSACTION_HISTORY_HEADER);
 
         // Header row
         std::cout << std::left
-                  << std::setw(25) << ui.getLocalizedMessage("TRANSACTION_ID_HEADER")
-                  << std::setw(15) << ui.getLocalizedMessage("CARD_NUMBER_HEADER")
-                  << std::setw(25) << ui.getLocalizedMessage("TYPE_HEADER")
-                  << std::setw(12) << ui.getLocalizedMessage("AMOUNT_HEADER")
-                  << std::setw(10) << ui.getLocalizedMessage("FEE_HEADER")
-                  << std::setw(35) << ui.getLocalizedMessage("TIMESTAMP_HEADER")
-                  << ui.getLocalizedMessage("DETAILS_HEADER") << "\n";
+                  << std::setw(25) << ui.getLocalizedView(MessageId::TRANSACTION_ID_HEADER)
+                  << std::setw(15) << ui.getLocalizedView(MessageId::CARD_NUMBER_HEADER)
+                  << std::setw(25) << ui.getLocalizedView(MessageId::TYPE_HEADER)
+                  << std::setw(12) << ui.getLocalizedView(MessageId::AMOUNT_HEADER)
+                  << std::setw(10) << ui.getLocalizedView(MessageId::FEE_HEADER)
+                  << std::setw(35) << ui.getLocalizedView(MessageId::TIMESTAMP_HEADER)
+                  << ui.getLocalizedView(MessageId::DETAILS_HEADER) << "\n";
 
         std::cout << std::string(150, '-') << '\n';
+    }
+
+    void ATM::printHistoryRow(const Transaction &transaction) const
+    {
+        std::cout << std::left
+                  << std::setw(25) << transaction.formatTransactionId()
+                  << std::setw(15) << transaction.formatCardNumber()
+                  << std::setw(25) << transaction.getTypeString()
+                  << std::setw(12) << transaction.getAmount()
+                  << std::setw(10) << transaction.getFee()
+                  << transaction.getFormattedTimestamp() << "  "
+                  << std::left << transaction.getDetails(ui) << '\n';
+    }
+
+    void ATM::printTransactionHistory() const
+    {
+        printHistoryHeader();
 
         // Transaction rows
-        for (const auto &transaction : transactionHistory)
+        journal.forEach([&](const Transaction &transaction)
+                        { printHistoryRow(transaction); });
+
+        std::cout << std::string(150, '-') << '\n';
+    }
+
+    void ATM::printHistoryQuery(const HistoryQuery &query) const
+    {
+        if (!historyStore)
         {
-            std::cout << std::left
-                      << std::setw(25) << transaction.getTransactionId()
-                      << std::setw(15) << transaction.getCardNumber()
-                      << std::setw(25) << transaction.getTypeString()
-                      << std::setw(12) << std::fixed << std::setprecision(2) << transaction.getAmount()
-                      << std::setw(10) << std::fixed << std::setprecision(2) << transaction.getFee()
-                      << transaction.getFormattedTimestamp() << "  "
-                      << std::left << transaction.getDetails() << '\n';
+            ui.displayMessage(MessageId::ERROR_SYSTEM);
+            return;
         }
 
+        printHistoryHeader();
+        auto results = historyStore->query(query);
+        for (const auto &transaction : results)
+        {
+            printHistoryRow(transaction);
+        }
         std::cout << std::string(150, '-') << '\n';
+        std::cout << ui.formatMessage(MessageId::HISTORY_QUERY_RESULT, results.size()) << "\n";
+    }
+
+    void ATM::printRecentTransactions(const Account &account) const
+    {
+        printHistoryHeader();
+        size_t shown = 0;
+        {
+            auto recent = account.getRecentTransactions();
+            for (const auto &transaction : recent)
+            {
+                printHistoryRow(transaction);
+            }
+            shown = recent.size();
+        }
+        std::cout << std::string(150, '-') << '\n';
+        std::cout << ui.formatMessage(MessageId::RECENT_TRANSACTIONS_NOTE, shown) << "\n";
+    }
+
+    void ATM::printAggregates(const std::string &scope, const TransactionAggregates &source) const
+    {
+        static const TransactionType TYPES[] = {TransactionType::DEPOSIT, TransactionType::WITHDRAWAL,
+                                                TransactionType::TRANSFER_CASH, TransactionType::TRANSFER_ACCOUNT};
+        static const MessageId TYPE_NAMES[] = {MessageId::TRANSACTION_TYPE_DEPOSIT, MessageId::TRANSACTION_TYPE_WITHDRAWAL,
+                                               MessageId::TRANSACTION_TYPE_CASH_TRANSFER, MessageId::TRANSACTION_TYPE_ACCOUNT_TRANSFER};
+
+        AggregateSnapshot totals = source.getTotals();
+        AggregateSnapshot recent = source.getRecent(std::chrono::hours(1));
+
+        std::cout << ui.formatMessage(MessageId::ACTIVITY_SCOPE, scope) << "\n";
+        for (size_t i = 0; i < std::size(TYPES); i++)
+        {
+            const AggregateTotals &row = totals[TYPES[i]];
+            std::cout << ui.formatMessage(MessageId::ACTIVITY_ROW, ui.getLocalizedView(TYPE_NAMES[i]), row.count,
+                                          row.amount.toWon(), row.fee.toWon(), recent[TYPES[i]].count)
+                      << "\n";
+        }
+        std::cout << ui.formatMessage(MessageId::ACTIVITY_CASH, totals.cashIn.toWon(), totals.cashOut.toWon()) << "\n";
+    }
+
+    void ATM::printActivitySummary() const
+    {
+        printAggregates(serialNumber, aggregates);
+        printAggregates(primaryBank->getName(), primaryBank->getAggregates());
+        for (const auto &bank : connectedBanks)
+        {
+            printAggregates(bank->getName(), bank->getAggregates());
+        }
     }
 
     void ATM::exportTransactionHistory(const std::string &filename) const
@@ -63,46 +157,59 @@ namespace ATMSystem
         std::ofstream file(filename);
         if (!file)
         {
-            ui.displayMessage("ERROR_SYSTEM");
+            ui.displayMessage(MessageId::ERROR_SYSTEM);
             return;
         }
 
         auto now = std::chrono::system_clock::now();
         auto time = std::chrono::system_clock::to_time_t(now);
 
-        file << ui.getLocalizedMessage("TRANSACTION_HISTORY_HEADER") << " - "
+        file << ui.getLocalizedView(MessageId::TRANSACTION_HISTORY_HEADER) << " - "
              << std::put_time(std::localtime(&time), "%Y-%m-%d %H:%M:%S")
              << "\n\n";
 
         // Header row
         file << std::left
-             << std::setw(25) << ui.getLocalizedMessage("TRANSACTION_ID_HEADER")
-             << std::setw(15) << ui.getLocalizedMessage("CARD_NUMBER_HEADER")
-             << std::setw(20) << ui.getLocalizedMessage("TYPE_HEADER")
-             << std::right << std::setw(12) << ui.getLocalizedMessage("AMOUNT_HEADER")
-             << std::setw(10) << ui.getLocalizedMessage("FEE_HEADER")
-             << std::setw(25) << ui.getLocalizedMessage("TIMESTAMP_HEADER")
-             << std::left << ui.getLocalizedMessage("DETAILS_HEADER") << "\n";
+             << std::setw(25) << ui.getLocalizedView(MessageId::TRANSACTION_ID_HEADER)
+             << std::setw(15) << ui.getLocalizedView(MessageId::CARD_NUMBER_HEADER)
+             << std::setw(20) << ui.getLocalizedView(MessageId::TYPE_HEADER)
+             << std::right << std::setw(12) << ui.getLocalizedView(MessageId::AMOUNT_HEADER)
+             << std::setw(10) << ui.getLocalizedView(MessageId::FEE_HEADER)
+             << std::setw(25) << ui.getLocalizedView(MessageId::TIMESTAMP_HEADER)
+             << std::left << ui.getLocalizedView(MessageId::DETAILS_HEADER) << "\n";
 
         file << std::string(150, '-') << '\n';
 
         // Transaction rows
-        for (const auto &transaction : transactionHistory)
-        {
-            file << std::left
-                 << std::setw(25) << transaction.getTransactionId()
-                 << std::setw(15) << transaction.getCardNumber()
-                 << std::setw(20) << transaction.getTypeString()
-                 << std::right << std::setw(10) << std::fixed << std::setprecision(2) << transaction.getAmount()
-                 << std::setw(8) << std::fixed << std::setprecision(2) << transaction.getFee()
-                 << transaction.getFormattedTimestamp() << "  "
-                 << std::left << transaction.getDetails() << '\n';
-        }
+        journal.forEach([&](const Transaction &transaction)
+                        {
+                            file << std::left
+                                 << std::setw(25) << transaction.formatTransactionId()
+                                 << std::setw(15) << transaction.formatCardNumber()
+                                 << std::setw(20) << transaction.getTypeString()
+                                 << std::right << std::setw(10) << transaction.getAmount()
+                                 << std::setw(8) << transaction.getFee()
+                                 << transaction.getFormattedTimestamp() << "  "
+                                 << std::left << transaction.getDetails(ui) << '\n';
+                        });
 
         file << std::string(150, '-') << '\n';
 
         file.close();
-        ui.displayMessage("EXPORT_SUCCESS");
+        ui.displayMessage(MessageId::EXPORT_SUCCESS);
+    }
+
+    bool ATM::exportTransactions(const ExportOptions &options, std::uint64_t &rows) const
+    {
+        TransactionExporter exporter(options);
+        if (!exporter.open())
+        {
+            return false;
+        }
+        journal.forEach([&](const Transaction &transaction)
+                        { exporter.write(transaction); });
+        rows = exporter.getRowCount();
+        return exporter.finish();
     }
 
     bool ATM::isAdminCard(const std::string &cardNumber) const
@@ -112,17 +219,50 @@ namespace ATMSystem
 
     void ATM::displayAdminMenu(UI &ui)
     {
-        ui.displayMessage("ADMIN_MENU");
+        ui.displayMessage(MessageId::ADMIN_MENU);
         std::string choice = ui.getInput();
 
         if (choice == "1")
         {
             printTransactionHistory();
             exportTransactionHistory("transaction_history.txt");
+
+            auto stats = journalWriter.getStats();
+            std::cout << ui.formatMessage(MessageId::COMMIT_STATS, stats.commits, stats.batches,
+                                          static_cast<std::uint64_t>(stats.commitsPerSecond)) << "\n";
+        }
+        else if (choice == "2")
+        {
+            ExportOptions options;
+            std::uint64_t rows = 0;
+            if (ui.getExportOptions(options) && exportTransactions(options, rows))
+            {
+                std::cout << ui.formatMessage(MessageId::EXPORT_COMPLETE, rows, options.path) << "\n";
+            }
+            else
+            {
+                ui.displayMessage(MessageId::ERROR_SYSTEM);
+            }
+        }
+        else if (choice == "3")
+        {
+            HistoryQuery query;
+            if (ui.getHistoryQuery(query))
+            {
+                printHistoryQuery(query);
+            }
+            else
+            {
+                ui.displayMessage(MessageId::ERROR_SYSTEM);
+            }
+        }
+        else if (choice == "4")
+        {
+            printActivitySummary();
         }
 
         endCurrentSession();
-        ui.displayMessage("THANK_YOU");
+        ui.displayMessage(MessageId::THANK_YOU);
         std::cout << "\n";
         for (int i = 0; i < 60; i++)
             std::cout << "#";
@@ -145,62 +285,79 @@ namespace ATMSystem
 
     void ATM::addConnectedBank(std::shared_ptr<Bank> bank)
     {
-        if (bank != primaryBank)
+        if (bank != primaryBank && connectedBankSet.insert(bank.get()).second)
         {
             connectedBanks.push_back(bank);
         }
     }
 
-    bool ATM::insertCard(const std::string &cardNumber)
-    {
-        return true;
-    }
-
-    bool ATM::validatePin(const std::string &accountNumber, const std::string &pin, int &attempts)
+    ATM::ResolvedAccount ATM::resolveAccount(const std::string &accountNumber) const
     {
-        std::shared_ptr<Bank> cardBank = primaryBank;
-        bool found = false;
+        if (const auto &directory = primaryBank->getAccountDirectory())
+        {
+            const auto *entry = directory->find(accountNumber);
+            if (!entry)
+            {
+                return {};
+            }
+            if (entry->bank == primaryBank.get())
+            {
+                return {entry->account, entry->bank, true};
+            }
+            if (bankType == BankType::MULTI_BANK && connectedBankSet.count(entry->bank) > 0)
+            {
+                return {entry->account, entry->bank, false};
+            }
+            return {};
+        }
 
-        // find which bank card belongs to
+        // banks built without a shared directory: probe each one
         if (auto account = primaryBank->getAccount(accountNumber))
         {
-            found = true;
+            return {account, primaryBank.get(), true};
         }
-        else if (bankType == BankType::MULTI_BANK)
+        if (bankType == BankType::MULTI_BANK)
         {
             for (const auto &bank : connectedBanks)
             {
                 if (auto account = bank->getAccount(accountNumber))
                 {
-                    cardBank = bank;
-                    found = true;
-                    break;
+                    return {account, bank.get(), false};
                 }
             }
         }
+        return {};
+    }
 
-        if (!found)
+    bool ATM::insertCard(const std::string &cardNumber)
+    {
+        return true;
+    }
+
+    bool ATM::validatePin(const std::string &accountNumber, const std::string &pin, int &attempts)
+    {
+        // find which bank card belongs to
+        auto card = resolveAccount(accountNumber);
+        if (!card)
         {
             return false;
         }
 
         // verify PIN with bank
-        if (!cardBank->verifyPIN(accountNumber, pin))
+        if (!card.bank->verifyPIN(accountNumber, pin))
         {
             attempts++;
             if (attempts >= MAX_PIN_ATTEMPTS)
             {
-                ui.displayMessage("MAX_ATTEMPTS_EXCEEDED");
+                ui.displayMessage(MessageId::MAX_ATTEMPTS_EXCEEDED);
                 if (currentSession)
                 {
-                    currentSession->endSessionWithError(ui.getLocalizedMessage("MAX_PIN_EXCEEDED"));
+                    currentSession->endSessionWithError(ui.getLocalizedMessage(MessageId::MAX_PIN_EXCEEDED));
                 }
                 return false;
             }
-            ui.displayMessage("WRONG_PIN");
-            std::string message = ui.getLocalizedMessage("ATTEMPTS_REMAINING");
-            size_t pos = message.find("{}");
-            message.replace(pos, 2, std::to_string(MAX_PIN_ATTEMPTS - attempts));
+            ui.displayMessage(MessageId::WRONG_PIN);
+            std::string message = ui.formatMessage(MessageId::ATTEMPTS_REMAINING, MAX_PIN_ATTEMPTS - attempts);
             std::cout << message << "\n";
             return false;
         }
@@ -208,10 +365,10 @@ namespace ATMSystem
         return true;
     }
 
-    bool ATM::processCashDeposit(const std::string &accountNumber, int amount,
+    bool ATM::processCashDeposit(const std::string &accountNumber, Money amount,
                                  const std::map<int, int> &cashInput,
                                  const std::map<int, int> &feeInput,
-                                 int &depositedAmount)
+                                 Money &depositedAmount)
     {
         // count total bills in deposit
         int totalBills = 0;
@@ -222,85 +379,50 @@ namespace ATMSystem
 
         if (totalBills > MAX_CASH_INSERT)
         {
-            ui.displayMessage("MAX_DEPOSIT_EXCEEDED");
+            ui.displayMessage(MessageId::MAX_DEPOSIT_EXCEEDED);
             return false;
         }
 
-        auto account = primaryBank->getAccount(accountNumber);
-
-        bool isPrimaryBank = true;
-
-        if (!account && bankType == BankType::MULTI_BANK)
-        {
-            for (const auto &bank : connectedBanks)
-            {
-                account = bank->getAccount(accountNumber);
-                if (account)
-                {
-                    isPrimaryBank = false;
-                    break;
-                }
-            }
-        }
+        auto resolvedAccount = resolveAccount(accountNumber);
+        auto account = resolvedAccount.account;
+        bool isPrimaryBank = resolvedAccount.isPrimary;
 
         if (!account)
         {
-            ui.displayMessage("ACCOUNT_NOT_FOUND");
+            ui.displayMessage(MessageId::ACCOUNT_NOT_FOUND);
             return false;
         }
 
         // update ATM cash inventory
-        for (const auto &[denom, count] : cashInput)
-        {
-            cashInventory[denom] += count;
-        }
-        for (const auto &[denom, count] : feeInput)
-        {
-            cashInventory[denom] += count;
-        }
+        addCash(cashInput);
+        addCash(feeInput);
 
         depositedAmount = amount;
         return account->deposit(depositedAmount);
     }
 
-    bool ATM::processCheckDeposit(const std::string &accountNumber, int amount,
+    bool ATM::processCheckDeposit(const std::string &accountNumber, Money amount,
                                   const std::map<int, int> &feeInput,
-                                  int &depositedAmount)
+                                  Money &depositedAmount)
     {
         if (!currentSession->canDepositCheck())
         {
-            ui.displayMessage("MAX_CHECK_DEPOSIT_EXCEEDED");
+            ui.displayMessage(MessageId::MAX_CHECK_DEPOSIT_EXCEEDED);
             return false;
         }
 
-        auto account = primaryBank->getAccount(accountNumber);
-
-        bool isPrimaryBank = true;
-
-        if (!account && bankType == BankType::MULTI_BANK)
-        {
-            for (const auto &bank : connectedBanks)
-            {
-                account = bank->getAccount(accountNumber);
-                if (account)
-                {
-                    isPrimaryBank = false;
-                    break;
-                }
-            }
-        }
+        auto resolvedAccount = resolveAccount(accountNumber);
+        auto account = resolvedAccount.account;
+        bool isPrimaryBank = resolvedAccount.isPrimary;
 
         if (!account)
         {
-            ui.displayMessage("ACCOUNT_NOT_FOUND");
+            ui.displayMessage(MessageId::ACCOUNT_NOT_FOUND);
             return false;
         }
 
         // update ATM cash inventory
-        for (const auto &[denom, count] : feeInput)
-        {
-            cashInventory[denom] += count;
-        }
+        addCash(feeInput);
 
         depositedAmount = amount;
         if (account->deposit(depositedAmount))
@@ -314,27 +436,15 @@ namespace ATMSystem
         }
     }
 
-    bool ATM::deposit(const std::string &accountNumber, double amount, bool isCash, int &depositedAmount, int &fee)
+    bool ATM::deposit(const std::string &accountNumber, Money amount, bool isCash, Money &depositedAmount, Money &fee)
     {
-        auto account = primaryBank->getAccount(accountNumber);
-        bool isPrimaryBank = true;
-
-        if (!account && bankType == BankType::MULTI_BANK)
-        {
-            for (const auto &bank : connectedBanks)
-            {
-                account = bank->getAccount(accountNumber);
-                if (account)
-                {
-                    isPrimaryBank = false;
-                    break;
-                }
-            }
-        }
+        auto resolvedAccount = resolveAccount(accountNumber);
+        auto account = resolvedAccount.account;
+        bool isPrimaryBank = resolvedAccount.isPrimary;
 
         if (!account)
         {
-            ui.displayMessage("ACCOUNT_NOT_FOUND");
+            ui.displayMessage(MessageId::ACCOUNT_NOT_FOUND);
             return false;
         }
 
@@ -348,44 +458,39 @@ namespace ATMSystem
 
         depositedAmount = amount;
 
-        if (account->deposit(depositedAmount))
+        if (!account->deposit(depositedAmount))
         {
-            // add transaction to history
-            if (currentSession)
-            {
-                currentSession->addTransaction(
-                    TransactionType::DEPOSIT,
-                    depositedAmount,
-                    fee,
-                    isCash ? ui.getLocalizedMessage("CASH_DEPOSIT_TYPE") : ui.getLocalizedMessage("CHECK_DEPOSIT_TYPE"));
-            }
-            return true;
+            return false;
         }
-        return false;
-    }
 
-    bool ATM::withdraw(const std::string &accountNumber, double amount,
-                       int &withdrawnAmount, int &fee, std::map<int, int> &bills)
-    {
-        auto account = primaryBank->getAccount(accountNumber);
-        bool isPrimaryBank = true;
-
-        if (!account && bankType == BankType::MULTI_BANK)
+        // journal the applied credit; without a record it is taken back
+        if (currentSession)
         {
-            for (const auto &bank : connectedBanks)
+            TransactionId id = currentSession->addTransaction(
+                TransactionType::DEPOSIT,
+                depositedAmount,
+                fee,
+                isCash ? TransactionChannel::CASH : TransactionChannel::CHECK);
+            if (id == 0)
             {
-                account = bank->getAccount(accountNumber);
-                if (account)
-                {
-                    isPrimaryBank = false;
-                    break;
-                }
+                account->undo(depositedAmount);
+                return false;
             }
+            recordInAccounts(id, *account);
         }
+        return true;
+    }
+
+    bool ATM::withdraw(const std::string &accountNumber, Money amount,
+                       Money &withdrawnAmount, Money &fee, std::map<int, int> &bills)
+    {
+        auto resolvedAccount = resolveAccount(accountNumber);
+        auto account = resolvedAccount.account;
+        bool isPrimaryBank = resolvedAccount.isPrimary;
 
         if (!account)
         {
-            ui.displayMessage("ACCOUNT_NOT_FOUND");
+            ui.displayMessage(MessageId::ACCOUNT_NOT_FOUND);
             return false;
         }
 
@@ -396,65 +501,65 @@ namespace ATMSystem
 
         if (!hasSufficientCash(amount))
         {
-            ui.displayMessage("ERROR_INSUFFICIENT_CASH");
+            ui.displayMessage(MessageId::ERROR_INSUFFICIENT_CASH);
             return false;
         }
 
-        if (account->getBalance() < amount + fee)
+        bills = getCashBreakdown(amount);
+        if (bills.empty())
         {
-            ui.displayMessage("INSUFFICIENT_FUNDS");
+            ui.displayMessage(MessageId::ERROR_INVALID_OPERATION);
             return false;
         }
 
-        bills = getCashBreakdown(amount);
-        if (bills.empty())
+        // the planned bills are reserved first, so the plan cannot go stale
+        if (!dispenseCash(bills))
         {
-            ui.displayMessage("ERROR_INVALID_OPERATION");
+            ui.displayMessage(MessageId::ERROR_INSUFFICIENT_CASH);
             return false;
         }
 
-        if (account->withdraw(amount + fee))
+        // funds are checked and debited in one atomic step
+        if (!account->withdraw(amount + fee))
         {
-            updateCashInventory(-amount);
-            // add transaction to history
-            if (currentSession)
+            addCash(bills);
+            ui.displayMessage(MessageId::INSUFFICIENT_FUNDS);
+            return false;
+        }
+
+        // journal the applied debit; without a record the funds and the
+        // reserved bills go back
+        if (currentSession)
+        {
+            TransactionId id = currentSession->addTransaction(
+                TransactionType::WITHDRAWAL,
+                amount,
+                fee,
+                TransactionChannel::CASH);
+            if (id == 0)
             {
-                currentSession->addTransaction(
-                    TransactionType::WITHDRAWAL,
-                    amount,
-                    fee,
-                    ui.getLocalizedMessage("WITHDRAWAL_TYPE"));
-                currentSession->incrementWithdrawalCount();
+                account->undo(-(amount + fee));
+                addCash(bills);
+                return false;
             }
-            return true;
+            recordInAccounts(id, *account);
+            currentSession->incrementWithdrawalCount();
         }
-        return false;
+        return true;
     }
 
     bool ATM::transfer(const std::string &fromAccount, const std::string &toAccount,
-                       double amount, bool isCashTransfer,
-                       int &transferredAmount, int &fee)
+                       Money amount, bool isCashTransfer,
+                       Money &transferredAmount, Money &fee)
     {
         // validate destination account exists
-        std::shared_ptr<Account> destAccount = primaryBank->getAccount(toAccount);
-        bool isDestPrimary = true;
-
-        if (!destAccount && bankType == BankType::MULTI_BANK)
-        {
-            for (const auto &bank : connectedBanks)
-            {
-                destAccount = bank->getAccount(toAccount);
-                if (destAccount)
-                {
-                    isDestPrimary = false;
-                    break;
-                }
-            }
-        }
+        auto resolvedDestAccount = resolveAccount(toAccount);
+        auto destAccount = resolvedDestAccount.account;
+        bool isDestPrimary = resolvedDestAccount.isPrimary;
 
         if (!destAccount)
         {
-            ui.displayMessage("INVALID_ACCOUNT");
+            ui.displayMessage(MessageId::INVALID_ACCOUNT);
             return false;
         }
 
@@ -463,48 +568,48 @@ namespace ATMSystem
             fee = TransactionFees::TRANSFER_CASH;
             transferredAmount = amount;
 
-            if (transferredAmount <= 0)
+            if (!transferredAmount.isPositive())
             {
-                ui.displayMessage("INVALID_AMOUNT");
+                ui.displayMessage(MessageId::INVALID_AMOUNT);
                 return false;
             }
 
-            // update ATM cash inventory
-            updateCashInventory(amount);
+            // credit first, so only a transfer that happened is journaled
+            if (!destAccount->deposit(transferredAmount))
+            {
+                return false;
+            }
 
-            // add transaction to session history
             if (currentSession)
             {
-                currentSession->addTransaction(
+                TransactionId id = currentSession->addTransaction(
                     TransactionType::TRANSFER_CASH,
                     transferredAmount,
                     fee,
-                    ui.getLocalizedMessage("TO") + " " + toAccount);
+                    TransactionChannel::CASH,
+                    destAccount->getKey(),
+                    resolvedDestAccount.bank->getId());
+                if (id == 0)
+                {
+                    destAccount->undo(transferredAmount);
+                    return false;
+                }
+                recordInAccounts(id, *destAccount);
             }
 
-            return destAccount->deposit(transferredAmount);
+            // update ATM cash inventory
+            updateCashInventory(amount);
+            return true;
         }
         else
         {
-            auto sourceAccount = primaryBank->getAccount(fromAccount);
-            bool isSourcePrimary = true;
-
-            if (!sourceAccount && bankType == BankType::MULTI_BANK)
-            {
-                for (const auto &bank : connectedBanks)
-                {
-                    sourceAccount = bank->getAccount(fromAccount);
-                    if (sourceAccount)
-                    {
-                        isSourcePrimary = false;
-                        break;
-                    }
-                }
-            }
+            auto resolvedSourceAccount = resolveAccount(fromAccount);
+            auto sourceAccount = resolvedSourceAccount.account;
+            bool isSourcePrimary = resolvedSourceAccount.isPrimary;
 
             if (!sourceAccount)
             {
-                ui.displayMessage("INVALID_ACCOUNT");
+                ui.displayMessage(MessageId::INVALID_ACCOUNT);
                 return false;
             }
 
@@ -524,32 +629,58 @@ namespace ATMSystem
 
             transferredAmount = amount;
 
-            if (sourceAccount->getBalance() < amount + fee)
+            TransferStatus status = Bank::transfer(*sourceAccount, *destAccount, amount + fee, amount);
+            if (status == TransferStatus::INSUFFICIENT_FUNDS)
             {
-                ui.displayMessage("INSUFFICIENT_FUNDS");
+                ui.displayMessage(MessageId::INSUFFICIENT_FUNDS);
+                return false;
+            }
+            if (status == TransferStatus::COMPENSATION_FAILED)
+            {
+                std::cout << ui.formatMessage(MessageId::TRANSFER_NOT_REVERSED, (amount + fee).toWon(), fromAccount) << "\n";
+                return false;
+            }
+            if (status != TransferStatus::SUCCESS)
+            {
+                ui.displayMessage(MessageId::INVALID_AMOUNT);
                 return false;
             }
 
-            if (sourceAccount->withdraw(amount + fee))
+            if (currentSession)
             {
-                if (destAccount->deposit(amount))
-                {
-                    if (currentSession)
-                    {
-                        currentSession->addTransaction(
-                            TransactionType::TRANSFER_ACCOUNT,
-                            transferredAmount,
-                            fee,
-                            ui.getLocalizedMessage("FROM") + " " + fromAccount + " " + ui.getLocalizedMessage("TO") + " " + toAccount);
-                    }
-                    return true;
-                }
-                else
+                TransactionId id = currentSession->addTransaction(
+                    TransactionType::TRANSFER_ACCOUNT,
+                    transferredAmount,
+                    fee,
+                    TransactionChannel::ACCOUNT,
+                    destAccount->getKey(),
+                    resolvedDestAccount.bank->getId());
+                if (id == 0)
                 {
-                    sourceAccount->deposit(amount + fee);
+                    // reverse both legs of the unjournaled transfer
+                    destAccount->undo(amount);
+                    sourceAccount->undo(-(amount + fee));
+                    return false;
                 }
+                recordInAccounts(id, *sourceAccount, destAccount.get());
             }
-            return false;
+            return true;
+        }
+    }
+
+    void ATM::recordInAccounts(TransactionId id, Account &account, Account *counterparty) const
+    {
+        // 0 means the session had already ended and kept no record
+        if (id == 0)
+        {
+            return;
+        }
+
+        const Transaction &transaction = currentSession->getTransactions().back();
+        account.recordTransaction(transaction);
+        if (counterparty && counterparty != &account)
+        {
+            counterparty->recordTransaction(transaction);
         }
     }
 
@@ -559,51 +690,37 @@ namespace ATMSystem
 
     bool ATM::addCash(const std::map<int, int> &cash)
     {
-        for (const auto &[denomination, count] : cash)
+        if (!cassettes.add(cash))
         {
-            cashInventory[denomination] += count;
+            return false;
         }
+        journal.recordCash(cassettes.toMap());
         return true;
     }
 
-    bool ATM::hasSufficientCash(int amount) const
+    bool ATM::restoreCash()
     {
-        int totalAvailable = 0;
-        for (const auto &[denomination, count] : cashInventory)
+        const auto &recovered = journal.getRecoveredCash();
+        if (recovered.empty())
         {
-            totalAvailable += denomination * count;
+            return false;
         }
-        return totalAvailable >= amount;
-    }
-
-    std::map<int, int> ATM::getCashBreakdown(int amount) const
-    {
-        std::map<int, int> breakdown;
-        int remaining = amount;
-
-        // use largest denominations first
-        std::vector<int> denoms = {50000, 10000, 5000, 1000};
-        for (int denom : denoms)
+        if (!cassettes.restore(recovered))
         {
-            if (remaining >= denom)
-            {
-                int needed = remaining / denom;
-                int available = cashInventory.at(denom);
-                int use = std::min(needed, available);
-                if (use > 0)
-                {
-                    breakdown[denom] = use;
-                    remaining -= denom * use;
-                }
-            }
+            return false;
         }
+        journal.recordCash(cassettes.toMap());
+        return true;
+    }
 
-        if (remaining > 0)
-        {
-            breakdown.clear();
-        }
+    bool ATM::hasSufficientCash(Money amount) const
+    {
+        return cassettes.getTotal() >= amount;
+    }
 
-        return breakdown;
+    std::map<int, int> ATM::getCashBreakdown(Money amount) const
+    {
+        return dispenser.plan(amount, cassettes.getCounts(), dispensePolicy);
     }
 
     bool ATM::isValidCard(const std::string &cardNumber, const std::shared_ptr<Bank> &issuingBank) const
@@ -615,9 +732,9 @@ namespace ATMSystem
         return true;
     }
 
-    int ATM::getTransactionFee(const std::shared_ptr<Bank> &sourceBank,
-                               const std::shared_ptr<Bank> &destBank,
-                               TransactionType type) const
+    Money ATM::getTransactionFee(const std::shared_ptr<Bank> &sourceBank,
+                                 const std::shared_ptr<Bank> &destBank,
+                                 TransactionType type) const
     {
         bool isSourcePrimary = (sourceBank == primaryBank);
         bool isDestPrimary = (destBank == primaryBank);
@@ -644,29 +761,29 @@ namespace ATMSystem
             return TransactionFees::TRANSFER_CASH;
 
         default:
-            return 0;
+            return Money();
         }
     }
 
-    void ATM::updateCashInventory(double amount)
+    bool ATM::dispenseCash(const std::map<int, int> &bills)
     {
-        if (amount > 0)
+        if (!cassettes.take(bills))
         {
-            return;
+            return false;
         }
+        journal.recordCash(cassettes.toMap());
+        return true;
+    }
 
-        int remainingAmount = -amount;
-        std::vector<int> denominations = {50000, 10000, 5000, 1000};
-
-        for (int denom : denominations)
+    void ATM::updateCashInventory(Money amount)
+    {
+        if (amount.isPositive())
         {
-            if (remainingAmount >= denom && cashInventory[denom] > 0)
-            {
-                int numBills = std::min(remainingAmount / denom, cashInventory[denom]);
-                cashInventory[denom] -= numBills;
-                remainingAmount -= numBills * denom;
-            }
+            return;
         }
+
+        // same plan a withdrawal would report
+        dispenseCash(getCashBreakdown(-amount));
     }
 
 }
\ No newline at end of file
@@ -2,46 +2,101 @@
 
 namespace ATMSystem
 {
+    static_assert(std::atomic<Money>::is_always_lock_free, "Account balance updates must be lock-free");
 
     Account::Account(std::shared_ptr<Bank> b, const std::string &user, const std::string &accNum, const std::string &pinCode)
-        : bank(b), userName(user), accountNumber(accNum), pin(pinCode), balance(0)
+        : bank(b), userName(user), accountNumber(accNum),
+          key(parseAccountNumber(accNum).value_or(NO_ACCOUNT_KEY)), pin(pinCode), balance()
     {
     }
 
-    bool Account::deposit(double amount)
+    bool Account::deposit(Money amount)
     {
-        balance += amount;
+        if (amount.isNegative())
+        {
+            return false;
+        }
+
+        Money current = balance.load(std::memory_order_relaxed);
+        Money updated;
+        do
+        {
+            auto credited = current.tryAdd(amount);
+            if (!credited)
+            {
+                return false;
+            }
+            updated = *credited;
+        } while (!balance.compare_exchange_weak(current, updated,
+                                                std::memory_order_acq_rel,
+                                                std::memory_order_relaxed));
         return true;
     }
 
-    bool Account::withdraw(double amount)
+    bool Account::withdraw(Money amount)
     {
-        if (amount > balance)
+        if (amount.isNegative())
         {
             return false;
         }
-        balance -= amount;
+
+        // the funds check and the debit happen in the same CAS
+        Money current = balance.load(std::memory_order_relaxed);
+        do
+        {
+            if (amount > current)
+            {
+                return false;
+            }
+        } while (!balance.compare_exchange_weak(current, current - amount,
+                                                std::memory_order_acq_rel,
+                                                std::memory_order_relaxed));
         return true;
     }
 
-    bool Account::transfer(const std::string &toAccount, double amount)
+    bool Account::transfer(const std::string &toAccount, Money amount)
     {
-        if (amount > balance)
+        return withdraw(amount);
+    }
+
+    bool Account::undo(Money applied)
+    {
+        Money current = balance.load(std::memory_order_relaxed);
+        Money updated;
+        do
         {
-            return false;
-        }
-        balance -= amount;
+            auto reverted = current.trySubtract(applied);
+            if (!reverted)
+            {
+                return false;
+            }
+            updated = *reverted;
+        } while (!balance.compare_exchange_weak(current, updated,
+                                                std::memory_order_acq_rel,
+                                                std::memory_order_relaxed));
         return true;
     }
 
-    double Account::getBalance() const
+    Money Account::getBalance() const
+    {
+        return balance.load(std::memory_order_acquire);
+    }
+
+    void Account::recordTransaction(const Transaction &transaction)
     {
-        return balance;
+        std::lock_guard<std::mutex> lock(historyMutex);
+        if (!recentTransactions)
+        {
+            recentTransactions = std::make_unique<HistoryRing>();
+        }
+        recentTransactions->push(transaction);
     }
 
-    std::vector<Transaction> Account::getTransactionHistory() const
+    Account::RecentHistory Account::getRecentTransactions() const
     {
-        return transactionHistory;
+        std::unique_lock<std::mutex> lock(historyMutex);
+        const HistoryRing *ring = recentTransactions.get();
+        return RecentHistory(std::move(lock), ring);
     }
 
 }
\ No newline at end of file
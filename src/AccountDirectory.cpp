@@ -0,0 +1,59 @@
+#include "AccountDirectory.hpp"
+#include "Account.hpp"
+#include <mutex>
+
+namespace ATMSystem
+{
+    bool AccountDirectory::registerAccount(AccountKey key, Bank *bank, std::shared_ptr<Account> account)
+    {
+        Shard &shard = shardFor(key);
+        std::unique_lock<std::shared_mutex> lock(shard.mutex);
+
+        // account numbers are unique across the network
+        return shard.entries.try_emplace(key, Entry{bank, std::move(account)}).second;
+    }
+
+    const AccountDirectory::Entry *AccountDirectory::find(AccountKey key) const
+    {
+        if (const Entry *entry = probe(key))
+        {
+            return entry;
+        }
+        return (loader && loader(key)) ? probe(key) : nullptr;
+    }
+
+    const AccountDirectory::Entry *AccountDirectory::probe(AccountKey key) const
+    {
+        const Shard &shard = shardFor(key);
+        std::shared_lock<std::shared_mutex> lock(shard.mutex);
+        auto it = shard.entries.find(key);
+        return (it != shard.entries.end()) ? &it->second : nullptr;
+    }
+
+    const AccountDirectory::Entry *AccountDirectory::find(std::string_view accountNumber) const
+    {
+        auto key = parseAccountNumber(accountNumber);
+        return key ? find(*key) : nullptr;
+    }
+
+    size_t AccountDirectory::size() const
+    {
+        size_t count = 0;
+        for (const auto &shard : shards)
+        {
+            std::shared_lock<std::shared_mutex> lock(shard.mutex);
+            count += shard.entries.size();
+        }
+        return count;
+    }
+
+    void AccountDirectory::reserve(size_t count)
+    {
+        size_t perShard = count / SHARD_COUNT + 1;
+        for (auto &shard : shards)
+        {
+            std::unique_lock<std::shared_mutex> lock(shard.mutex);
+            shard.entries.reserve(perShard);
+        }
+    }
+}
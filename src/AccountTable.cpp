@@ -0,0 +1,97 @@
+#include "AccountTable.hpp"
+#include "Account.hpp"
+
+namespace ATMSystem
+{
+    namespace
+    {
+        // keep the table at most half full so probe chains stay short
+        constexpr size_t MIN_SLOTS = 16;
+
+        size_t slotsFor(size_t count)
+        {
+            size_t slotCount = MIN_SLOTS;
+            while (slotCount < count * 2)
+            {
+                slotCount *= 2;
+            }
+            return slotCount;
+        }
+    }
+
+    void AccountTable::rehash(size_t slotCount)
+    {
+        std::vector<Slot> resized(slotCount, Slot{EMPTY_KEY, 0});
+        const size_t mask = slotCount - 1;
+        for (const auto &slot : slots)
+        {
+            if (slot.key == EMPTY_KEY)
+                continue;
+
+            size_t pos = hash(slot.key) & mask;
+            while (resized[pos].key != EMPTY_KEY)
+            {
+                pos = (pos + 1) & mask;
+            }
+            resized[pos] = slot;
+        }
+        slots.swap(resized);
+    }
+
+    void AccountTable::reserve(size_t count)
+    {
+        accounts.reserve(count);
+        size_t wanted = slotsFor(count);
+        if (wanted > slots.size())
+        {
+            rehash(wanted);
+        }
+    }
+
+    bool AccountTable::insert(AccountKey key, std::shared_ptr<Account> account)
+    {
+        if (key == EMPTY_KEY)
+        {
+            return false;
+        }
+        if ((accounts.size() + 1) * 2 > slots.size())
+        {
+            rehash(slotsFor(accounts.size() + 1));
+        }
+
+        const size_t mask = slots.size() - 1;
+        size_t pos = hash(key) & mask;
+        while (slots[pos].key != EMPTY_KEY)
+        {
+            if (slots[pos].key == key)
+            {
+                return false;
+            }
+            pos = (pos + 1) & mask;
+        }
+
+        slots[pos] = Slot{key, static_cast<std::uint32_t>(accounts.size())};
+        accounts.push_back(std::move(account));
+        return true;
+    }
+
+    const std::shared_ptr<Account> *AccountTable::find(AccountKey key) const
+    {
+        if (slots.empty())
+        {
+            return nullptr;
+        }
+
+        const size_t mask = slots.size() - 1;
+        size_t pos = hash(key) & mask;
+        while (slots[pos].key != EMPTY_KEY)
+        {
+            if (slots[pos].key == key)
+            {
+                return &accounts[slots[pos].index];
+            }
+            pos = (pos + 1) & mask;
+        }
+        return nullptr;
+    }
+}
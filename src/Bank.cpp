@@ -1,10 +1,20 @@
 #include "Bank.hpp"
 #include "UI.hpp"
 #include <iostream>
+#include <algorithm>
+#include <functional>
+#include <mutex>
+#include <atomic>
 
 namespace ATMSystem
 {
-    Bank::Bank(const std::string &bankName) : name(bankName) {}
+    namespace
+    {
+        std::atomic<std::uint32_t> nextBankId{1};
+    }
+
+    Bank::Bank(const std::string &bankName, std::shared_ptr<AccountDirectory> accountDirectory)
+        : name(bankName), id(nextBankId++), directory(std::move(accountDirectory)) {}
 
     bool Bank::createAccount(const std::string &userName, const std::string &accountNumber, const std::string &pin)
     {
@@ -13,35 +23,342 @@ namespace ATMSystem
         // validate PIN format
         if (pin.length() != 4 || !std::all_of(pin.begin(), pin.end(), ::isdigit))
         {
-            ui.displayMessage("INVALID_PIN_FORMAT");
+            ui.displayMessage(MessageId::INVALID_PIN_FORMAT);
+            return false;
+        }
+
+        auto key = parseAccountNumber(accountNumber);
+        if (!key || numberInUse(*key))
+        {
             return false;
         }
 
         auto account = std::make_shared<Account>(shared_from_this(), userName, accountNumber, pin);
-        accounts[accountNumber] = account;
+        {
+            AccountShard &shard = shardFor(*key);
+            std::unique_lock<std::shared_mutex> lock(shard.mutex);
+            if (shard.accounts.find(*key))
+            {
+                return false;
+            }
+            if (directory && !directory->registerAccount(*key, this, account))
+            {
+                return false;
+            }
+            shard.accounts.insert(*key, account);
+        }
+
+        std::lock_guard<std::mutex> lock(userAccountsMutex);
         userAccounts[userName].push_back(accountNumber);
         return true;
     }
 
-    bool Bank::verifyPIN(const std::string &accountNumber, const std::string &pin)
+    size_t Bank::createAccounts(const std::vector<AccountSpec> &batch)
+    {
+        struct Pending
+        {
+            AccountKey key;
+            std::shared_ptr<Account> account;
+        };
+
+        std::array<std::vector<Pending>, ACCOUNT_SHARD_COUNT> byShard;
+        auto self = shared_from_this();
+        for (const auto &spec : batch)
+        {
+            auto key = parseAccountNumber(spec.accountNumber);
+            if (!key || numberInUse(*key) || spec.pin.length() != 4 || !std::all_of(spec.pin.begin(), spec.pin.end(), ::isdigit) ||
+                spec.openingBalance.isNegative())
+            {
+                continue;
+            }
+
+            auto account = std::make_shared<Account>(self, spec.userName, spec.accountNumber, spec.pin);
+            account->balance.store(spec.openingBalance, std::memory_order_relaxed);
+            byShard[accountShardOf<ACCOUNT_SHARD_COUNT>(*key)].push_back({*key, std::move(account)});
+        }
+
+        std::vector<const Account *> created;
+        created.reserve(batch.size());
+        for (size_t index = 0; index < ACCOUNT_SHARD_COUNT; index++)
+        {
+            AccountShard &shard = shards[index];
+            std::unique_lock<std::shared_mutex> lock(shard.mutex);
+            for (auto &pending : byShard[index])
+            {
+                if (shard.accounts.find(pending.key) ||
+                    (directory && !directory->registerAccount(pending.key, this, pending.account)))
+                {
+                    continue;
+                }
+                created.push_back(pending.account.get());
+                shard.accounts.insert(pending.key, std::move(pending.account));
+            }
+        }
+
+        std::lock_guard<std::mutex> lock(userAccountsMutex);
+        for (const Account *account : created)
+        {
+            userAccounts[account->getUserName()].push_back(account->getAccountNumber());
+        }
+        return created.size();
+    }
+
+    void Bank::attachImage(std::shared_ptr<const SystemImage> systemImage, std::uint32_t index)
+    {
+        image = std::move(systemImage);
+        imageBank = index;
+        reserveAccounts(static_cast<size_t>(image->accountsEnd(index) - image->accountsBegin(index)));
+        imageLoaded.store(false, std::memory_order_release);
+    }
+
+    bool Bank::inImage(AccountKey key) const
     {
-        auto it = accounts.find(accountNumber);
-        if (it != accounts.end())
+        return !imageLoaded.load(std::memory_order_acquire) && image->findAccount(imageBank, key);
+    }
+
+    bool Bank::numberInUse(AccountKey key) const
+    {
+        // the directory's loader also finds numbers still unloaded in any
+        // bank's image slice, not just this one
+        return (directory && directory->find(key)) || inImage(key);
+    }
+
+    std::shared_ptr<Account> Bank::loadFromImage(const SystemImage::AccountRecord &record) const
+    {
+        AccountShard &shard = shards[accountShardOf<ACCOUNT_SHARD_COUNT>(record.key)];
+        std::shared_ptr<Account> account;
         {
-            return it->second->getPin() == pin;
+            std::unique_lock<std::shared_mutex> lock(shard.mutex);
+            if (const auto *existing = shard.accounts.find(record.key))
+            {
+                return *existing;
+            }
+
+            auto self = std::const_pointer_cast<Bank>(shared_from_this());
+            account = std::make_shared<Account>(self, std::string(image->getUserName(record)),
+                                                formatAccountNumber(record.key),
+                                                std::string(record.pin, sizeof(record.pin)));
+            account->balance.store(Money(record.balance), std::memory_order_relaxed);
+            if (directory)
+            {
+                directory->registerAccount(record.key, self.get(), account);
+            }
+            shard.accounts.insert(record.key, account);
         }
-        return false;
+
+        std::lock_guard<std::mutex> lock(userAccountsMutex);
+        userAccounts[account->getUserName()].push_back(account->getAccountNumber());
+        return account;
     }
 
-    std::shared_ptr<Account> Bank::getAccount(const std::string &accountNumber)
+    std::shared_ptr<Account> Bank::materialize(AccountKey key) const
     {
-        auto it = accounts.find(accountNumber);
-        return (it != accounts.end()) ? it->second : nullptr;
+        if (imageLoaded.load(std::memory_order_acquire))
+        {
+            return nullptr;
+        }
+        const auto *record = image->findAccount(imageBank, key);
+        return record ? loadFromImage(*record) : nullptr;
+    }
+
+    void Bank::materializeAll() const
+    {
+        std::lock_guard<std::mutex> lock(imageMutex);
+        if (imageLoaded.load(std::memory_order_acquire))
+        {
+            return;
+        }
+        for (const auto *record = image->accountsBegin(imageBank); record != image->accountsEnd(imageBank); ++record)
+        {
+            loadFromImage(*record);
+        }
+        imageLoaded.store(true, std::memory_order_release);
+    }
+
+    void Bank::reserveAccounts(size_t count)
+    {
+        size_t perShard = count / ACCOUNT_SHARD_COUNT + 1;
+        for (auto &shard : shards)
+        {
+            std::unique_lock<std::shared_mutex> lock(shard.mutex);
+            shard.accounts.reserve(perShard);
+        }
+
+        std::lock_guard<std::mutex> lock(userAccountsMutex);
+        userAccounts.reserve(count);
+    }
+
+    size_t Bank::getAccountCount() const
+    {
+        ensureMaterialized();
+        size_t count = 0;
+        for (const auto &shard : shards)
+        {
+            std::shared_lock<std::shared_mutex> lock(shard.mutex);
+            count += shard.accounts.size();
+        }
+        return count;
+    }
+
+    std::vector<std::shared_ptr<Account>> Bank::getAllAccounts() const
+    {
+        std::vector<std::shared_ptr<Account>> allAccounts;
+        allAccounts.reserve(getAccountCount());
+        forEachAccount([&](const std::shared_ptr<Account> &account)
+                       { allAccounts.push_back(account); });
+        return allAccounts;
+    }
+
+    bool Bank::verifyPIN(std::string_view accountNumber, const std::string &pin) const
+    {
+        auto account = getAccount(accountNumber);
+        return account && account->getPin() == pin;
+    }
+
+    std::shared_ptr<Account> Bank::getAccount(std::string_view accountNumber) const
+    {
+        auto key = parseAccountNumber(accountNumber);
+        return key ? getAccount(*key) : nullptr;
+    }
+
+    std::shared_ptr<Account> Bank::getAccount(AccountKey key) const
+    {
+        {
+            const AccountShard &shard = shardFor(key);
+            std::shared_lock<std::shared_mutex> lock(shard.mutex);
+            if (const auto *account = shard.accounts.find(key))
+            {
+                return *account;
+            }
+        }
+        return materialize(key);
     }
 
     std::vector<std::string> Bank::getUserAccounts(const std::string &userName)
     {
+        ensureMaterialized();
+        std::lock_guard<std::mutex> lock(userAccountsMutex);
         auto it = userAccounts.find(userName);
         return (it != userAccounts.end()) ? it->second : std::vector<std::string>();
     }
+
+    bool Bank::adjustBalance(Account &account, Money delta)
+    {
+        Money current = account.balance.load(std::memory_order_relaxed);
+        while (true)
+        {
+            auto next = current.tryAdd(delta);
+            if (!next)
+            {
+                return false;
+            }
+            if (account.balance.compare_exchange_weak(current, *next, std::memory_order_acq_rel))
+            {
+                return true;
+            }
+        }
+    }
+
+    bool Bank::restoreBalance(AccountKey key, Money balance)
+    {
+        auto account = getAccount(key);
+        if (!account)
+        {
+            return false;
+        }
+        account->balance.store(balance, std::memory_order_release);
+        return true;
+    }
+
+    ReplayStatus Bank::replayTransaction(const Transaction &transaction)
+    {
+        // a corrupt record must not throw out of the replay worker
+        auto debit = transaction.getAmount().tryAdd(transaction.getFee());
+        if (!debit || transaction.getAmount().isNegative() || transaction.getFee().isNegative())
+        {
+            return ReplayStatus::INVALID_RECORD;
+        }
+
+        Money cardDelta;
+        Money counterpartyDelta;
+        switch (transaction.getType())
+        {
+        case TransactionType::DEPOSIT:
+            cardDelta = transaction.getAmount();
+            break;
+        case TransactionType::WITHDRAWAL:
+            cardDelta = Money() - *debit;
+            break;
+        case TransactionType::TRANSFER_CASH:
+            // amount and fee were paid in cash at the ATM
+            counterpartyDelta = transaction.getAmount();
+            break;
+        case TransactionType::TRANSFER_ACCOUNT:
+            cardDelta = Money() - *debit;
+            counterpartyDelta = transaction.getAmount();
+            break;
+        default:
+            return ReplayStatus::INVALID_RECORD;
+        }
+
+        ReplayStatus status = ReplayStatus::NOT_OWNED;
+        auto apply = [&](AccountKey key, Money delta)
+        {
+            if (delta.isZero())
+            {
+                return;
+            }
+            if (auto account = getAccount(key))
+            {
+                if (!adjustBalance(*account, delta))
+                {
+                    status = ReplayStatus::INVALID_RECORD;
+                }
+                else if (status == ReplayStatus::NOT_OWNED)
+                {
+                    status = ReplayStatus::APPLIED;
+                }
+            }
+        };
+        apply(transaction.getCardNumber(), cardDelta);
+        apply(transaction.getCounterpartyAccount(), counterpartyDelta);
+        return status;
+    }
+
+    TransferStatus Bank::transfer(Account &source, Account &destination, Money debit, Money credit)
+    {
+        if (debit.isNegative() || credit.isNegative() || credit > debit)
+        {
+            return TransferStatus::INVALID_AMOUNT;
+        }
+
+        // lock ordering by address keeps opposing transfers deadlock-free
+        std::unique_lock<std::mutex> firstLock;
+        std::unique_lock<std::mutex> secondLock;
+        if (&source == &destination)
+        {
+            firstLock = std::unique_lock<std::mutex>(source.transferMutex);
+        }
+        else
+        {
+            bool sourceFirst = std::less<Account *>()(&source, &destination);
+            Account &first = sourceFirst ? source : destination;
+            Account &second = sourceFirst ? destination : source;
+            firstLock = std::unique_lock<std::mutex>(first.transferMutex);
+            secondLock = std::unique_lock<std::mutex>(second.transferMutex);
+        }
+
+        if (!source.withdraw(debit))
+        {
+            return TransferStatus::INSUFFICIENT_FUNDS;
+        }
+
+        if (!destination.deposit(credit))
+        {
+            // give the debit back; this fails only if deposits made since
+            // pushed the source balance to the limit
+            return source.deposit(debit) ? TransferStatus::CREDIT_REJECTED : TransferStatus::COMPENSATION_FAILED;
+        }
+        return TransferStatus::SUCCESS;
+    }
 }
\ No newline at end of file
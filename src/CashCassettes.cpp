@@ -0,0 +1,111 @@
+#include "CashCassettes.hpp"
+
+namespace ATMSystem
+{
+    bool CashCassettes::isValid(const std::map<int, int> &bills)
+    {
+        for (const auto &[denomination, count] : bills)
+        {
+            if (!slotOf(denomination) || count < 0)
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    bool CashCassettes::add(const std::map<int, int> &bills)
+    {
+        if (!isValid(bills))
+        {
+            return false;
+        }
+
+        std::int64_t added = 0;
+        for (const auto &[denomination, count] : bills)
+        {
+            counts[*slotOf(denomination)].fetch_add(count, std::memory_order_acq_rel);
+            added += static_cast<std::int64_t>(denomination) * count;
+        }
+        totalWon.fetch_add(added, std::memory_order_acq_rel);
+        return true;
+    }
+
+    bool CashCassettes::take(const std::map<int, int> &bills)
+    {
+        if (!isValid(bills))
+        {
+            return false;
+        }
+
+        std::int64_t taken = 0;
+        for (auto it = bills.begin(); it != bills.end(); ++it)
+        {
+            std::atomic<int> &slot = counts[*slotOf(it->first)];
+            int current = slot.load(std::memory_order_relaxed);
+            bool enough = true;
+            do
+            {
+                if (current < it->second)
+                {
+                    enough = false;
+                    break;
+                }
+            } while (!slot.compare_exchange_weak(current, current - it->second,
+                                                 std::memory_order_acq_rel,
+                                                 std::memory_order_relaxed));
+
+            if (!enough)
+            {
+                // put back what this call already took
+                for (auto back = bills.begin(); back != it; ++back)
+                {
+                    counts[*slotOf(back->first)].fetch_add(back->second, std::memory_order_acq_rel);
+                }
+                return false;
+            }
+            taken += static_cast<std::int64_t>(it->first) * it->second;
+        }
+        totalWon.fetch_sub(taken, std::memory_order_acq_rel);
+        return true;
+    }
+
+    bool CashCassettes::restore(const std::map<int, int> &bills)
+    {
+        if (!isValid(bills))
+        {
+            return false;
+        }
+
+        std::int64_t total = 0;
+        for (size_t slot = 0; slot < SLOT_COUNT; slot++)
+        {
+            auto it = bills.find(CASH_DENOMINATIONS[slot]);
+            int count = it != bills.end() ? it->second : 0;
+            counts[slot].store(count, std::memory_order_release);
+            total += static_cast<std::int64_t>(CASH_DENOMINATIONS[slot]) * count;
+        }
+        totalWon.store(total, std::memory_order_release);
+        return true;
+    }
+
+    CashCassettes::Counts CashCassettes::getCounts() const
+    {
+        Counts snapshot;
+        for (size_t slot = 0; slot < SLOT_COUNT; slot++)
+        {
+            snapshot[slot] = counts[slot].load(std::memory_order_acquire);
+        }
+        return snapshot;
+    }
+
+    std::map<int, int> CashCassettes::toMap() const
+    {
+        std::map<int, int> inventory;
+        for (size_t slot = 0; slot < SLOT_COUNT; slot++)
+        {
+            inventory[CASH_DENOMINATIONS[slot]] = counts[slot].load(std::memory_order_acquire);
+        }
+        return inventory;
+    }
+}
@@ -0,0 +1,125 @@
+#include "CashDispenser.hpp"
+#include <vector>
+#include <limits>
+#include <numeric>
+
+namespace ATMSystem
+{
+    namespace
+    {
+        constexpr std::int64_t UNREACHABLE = std::numeric_limits<std::int64_t>::max();
+        constexpr std::int64_t SCARCITY_SCALE = 1024;
+    }
+
+    CashDispenser::CashDispenser()
+    {
+        unit = 0;
+        for (int denomination : CASH_DENOMINATIONS)
+        {
+            unit = std::gcd(unit, static_cast<std::int64_t>(denomination));
+        }
+    }
+
+    void CashDispenser::build(Table &target, const CashCassettes::Counts &counts, DispensePolicy policy,
+                              std::int64_t capacity) const
+    {
+        target.counts = counts;
+        target.policy = policy;
+        target.capacity = capacity;
+        target.lots.clear();
+
+        for (size_t slot = 0; slot < CashCassettes::SLOT_COUNT; slot++)
+        {
+            int denomination = CASH_DENOMINATIONS[slot];
+            int available = counts[slot];
+            if (available <= 0)
+            {
+                continue;
+            }
+
+            std::int64_t units = denomination / unit;
+            std::int64_t usable = std::min<std::int64_t>(available, capacity / units);
+            std::int64_t billCost = 1;
+            if (policy == DispensePolicy::PRESERVE_SCARCE)
+            {
+                // a bill costs more the fewer of its kind are left
+                billCost += units * SCARCITY_SCALE / (available + 1);
+            }
+
+            for (std::int64_t lot = 1; usable > 0; lot *= 2)
+            {
+                std::int64_t take = std::min(lot, usable);
+                target.lots.push_back({denomination, static_cast<int>(take), take * units, take * billCost});
+                usable -= take;
+            }
+        }
+
+        size_t width = static_cast<size_t>(capacity) + 1;
+        target.best.assign(width, UNREACHABLE);
+        target.taken.assign(target.lots.size() * width, 0);
+        target.best[0] = 0;
+
+        for (size_t i = 0; i < target.lots.size(); i++)
+        {
+            const Lot &lot = target.lots[i];
+            std::uint8_t *taken = target.taken.data() + i * width;
+            for (std::int64_t reach = capacity; reach >= lot.units; reach--)
+            {
+                std::int64_t from = target.best[reach - lot.units];
+                if (from != UNREACHABLE && from + lot.cost < target.best[reach])
+                {
+                    target.best[reach] = from + lot.cost;
+                    taken[reach] = 1;
+                }
+            }
+        }
+        target.built = true;
+    }
+
+    std::map<int, int> CashDispenser::walkBack(const Table &source, std::int64_t amount)
+    {
+        std::map<int, int> bills;
+        if (source.best[amount] == UNREACHABLE)
+        {
+            return bills;
+        }
+
+        // walk the lots backwards to recover the chosen ones
+        size_t width = static_cast<size_t>(source.capacity) + 1;
+        std::int64_t reach = amount;
+        for (size_t i = source.lots.size(); i-- > 0;)
+        {
+            if (source.taken[i * width + reach])
+            {
+                bills[source.lots[i].denomination] += source.lots[i].bills;
+                reach -= source.lots[i].units;
+            }
+        }
+        return bills;
+    }
+
+    std::map<int, int> CashDispenser::plan(Money amount, const CashCassettes::Counts &counts, DispensePolicy policy) const
+    {
+        if (!amount.isPositive() || amount.toWon() % unit != 0)
+        {
+            return {};
+        }
+
+        std::int64_t target = amount.toWon() / unit;
+        std::int64_t limit = TABLE_LIMIT_WON / unit;
+        if (target > limit)
+        {
+            // beyond the limit a one-off table sized to the amount is built
+            Table oneOff;
+            build(oneOff, counts, policy, target);
+            return walkBack(oneOff, target);
+        }
+
+        std::lock_guard<std::mutex> lock(tableMutex);
+        if (!table.built || table.counts != counts || table.policy != policy)
+        {
+            build(table, counts, policy, limit);
+        }
+        return walkBack(table, target);
+    }
+}
@@ -0,0 +1,230 @@
+#include "FleetExporter.hpp"
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <queue>
+#include <functional>
+#include <optional>
+#include <atomic>
+
+namespace ATMSystem
+{
+    namespace
+    {
+        // Hands filled chunks from one producer to the merger and returns
+        // drained chunks, so chunk buffers are allocated once per export.
+        class ChunkChannel
+        {
+        private:
+            std::mutex mutex;
+            std::condition_variable changed;
+            std::queue<std::vector<Transaction>> full;
+            std::vector<std::vector<Transaction>> spare;
+            bool closed = false;
+
+        public:
+            explicit ChunkChannel(size_t chunks)
+            {
+                spare.resize(chunks);
+                for (auto &chunk : spare)
+                {
+                    chunk.reserve(FleetExporter::CHUNK_RECORDS);
+                }
+            }
+
+            // producer side
+            std::vector<Transaction> takeSpare()
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+                changed.wait(lock, [&]()
+                             { return !spare.empty(); });
+                std::vector<Transaction> chunk = std::move(spare.back());
+                spare.pop_back();
+                chunk.clear();
+                return chunk;
+            }
+
+            void push(std::vector<Transaction> chunk)
+            {
+                {
+                    std::lock_guard<std::mutex> lock(mutex);
+                    full.push(std::move(chunk));
+                }
+                changed.notify_all();
+            }
+
+            void close()
+            {
+                {
+                    std::lock_guard<std::mutex> lock(mutex);
+                    closed = true;
+                }
+                changed.notify_all();
+            }
+
+            // merger side; false once the producer is done and drained
+            bool pop(std::vector<Transaction> &chunk)
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+                if (chunk.capacity() > 0)
+                {
+                    spare.push_back(std::move(chunk));
+                    changed.notify_all();
+                }
+                changed.wait(lock, [&]()
+                             { return !full.empty() || closed; });
+                if (full.empty())
+                {
+                    return false;
+                }
+                chunk = std::move(full.front());
+                full.pop();
+                return true;
+            }
+        };
+
+        struct Cursor
+        {
+            ChunkChannel *channel;
+            std::vector<Transaction> chunk;
+            size_t next = 0;
+
+            const Transaction &current() const { return chunk[next]; }
+
+            // moves to the next record, fetching chunks as needed
+            bool advance()
+            {
+                next++;
+                while (next >= chunk.size())
+                {
+                    if (!channel->pop(chunk))
+                    {
+                        return false;
+                    }
+                    next = 0;
+                }
+                return true;
+            }
+        };
+
+        bool mergeBefore(const Transaction &a, const Transaction &b)
+        {
+            if (a.getTimestamp() != b.getTimestamp())
+            {
+                return a.getTimestamp() < b.getTimestamp();
+            }
+            return a.getTransactionId() < b.getTransactionId();
+        }
+
+        struct MergeAfter
+        {
+            bool operator()(const Transaction &a, const Transaction &b) const { return mergeBefore(b, a); }
+        };
+    }
+
+    bool FleetExporter::exportHistory(const ExportOptions &options, std::uint64_t &rows) const
+    {
+        TransactionExporter exporter(options);
+        if (!exporter.open())
+        {
+            return false;
+        }
+
+        std::vector<std::unique_ptr<ChunkChannel>> channels;
+        std::vector<std::thread> producers;
+        std::atomic<bool> unordered{false};
+        channels.reserve(atms.size());
+        producers.reserve(atms.size());
+        for (const auto &atm : atms)
+        {
+            channels.push_back(std::make_unique<ChunkChannel>(CHUNKS_PER_PRODUCER));
+            ChunkChannel *channel = channels.back().get();
+            const TransactionJournal &journal = atm->getJournal();
+            producers.emplace_back([channel, &journal, &exporter, &unordered]()
+                                   {
+                                       std::vector<Transaction> chunk = channel->takeSpare();
+                                       std::priority_queue<Transaction, std::vector<Transaction>, MergeAfter> window;
+                                       std::optional<Transaction> last;
+                                       auto emit = [&]()
+                                       {
+                                           // the window was too small to put this record in place
+                                           if (last && mergeBefore(window.top(), *last))
+                                           {
+                                               unordered.store(true, std::memory_order_relaxed);
+                                           }
+                                           last = window.top();
+                                           window.pop();
+                                           chunk.push_back(*last);
+                                           if (chunk.size() == CHUNK_RECORDS)
+                                           {
+                                               channel->push(std::move(chunk));
+                                               chunk = channel->takeSpare();
+                                           }
+                                       };
+
+                                       // only synced records; a batch being written may still be taken back
+                                       journal.forEach([&](const Transaction &transaction)
+                                                       {
+                                                           if (!exporter.inRange(transaction))
+                                                           {
+                                                               return;
+                                                           }
+                                                           window.push(transaction);
+                                                           if (window.size() > REORDER_WINDOW)
+                                                           {
+                                                               emit();
+                                                           }
+                                                       });
+                                       while (!window.empty())
+                                       {
+                                           emit();
+                                       }
+                                       if (!chunk.empty())
+                                       {
+                                           channel->push(std::move(chunk));
+                                       }
+                                       channel->close();
+                                   });
+        }
+
+        // min-heap of cursors ordered by their current record
+        std::vector<Cursor> cursors;
+        cursors.reserve(channels.size());
+        for (auto &channel : channels)
+        {
+            Cursor cursor{channel.get(), {}, 0};
+            if (channel->pop(cursor.chunk))
+            {
+                cursors.push_back(std::move(cursor));
+            }
+        }
+        auto later = [&](size_t a, size_t b)
+        {
+            return mergeBefore(cursors[b].current(), cursors[a].current());
+        };
+        std::priority_queue<size_t, std::vector<size_t>, decltype(later)> heap(later);
+        for (size_t i = 0; i < cursors.size(); i++)
+        {
+            heap.push(i);
+        }
+
+        bool ok = true;
+        while (!heap.empty())
+        {
+            size_t top = heap.top();
+            heap.pop();
+            ok = exporter.write(cursors[top].current()) && ok;
+            if (cursors[top].advance())
+            {
+                heap.push(top);
+            }
+        }
+
+        for (auto &producer : producers)
+        {
+            producer.join();
+        }
+        rows = exporter.getRowCount();
+        return exporter.finish() && ok && !unordered.load(std::memory_order_relaxed);
+    }
+}
@@ -0,0 +1,216 @@
+#include "GroupCommitWriter.hpp"
+
+namespace ATMSystem
+{
+    GroupCommitWriter::GroupCommitWriter(TransactionJournal &journalRef, Config commitConfig)
+        : journal(journalRef), config(commitConfig), startTime(std::chrono::steady_clock::now())
+    {
+        if (config.maxBatch == 0)
+        {
+            config.maxBatch = 1;
+        }
+        for (size_t i = 0; i < QUEUE_CAPACITY; i++)
+        {
+            cells[i].sequence.store(i, std::memory_order_relaxed);
+        }
+        writer = std::thread(&GroupCommitWriter::run, this);
+    }
+
+    GroupCommitWriter::~GroupCommitWriter()
+    {
+        {
+            std::lock_guard<std::mutex> lock(wakeMutex);
+            stopping.store(true);
+        }
+        writerWake.notify_one();
+        writer.join();
+    }
+
+    std::uint64_t GroupCommitWriter::submit(const Transaction &transaction)
+    {
+        std::uint64_t pos = enqueuePos.load(std::memory_order_relaxed);
+        for (;;)
+        {
+            Cell &cell = cells[pos & (QUEUE_CAPACITY - 1)];
+            std::uint64_t sequence = cell.sequence.load(std::memory_order_acquire);
+            if (sequence == pos)
+            {
+                if (enqueuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+                {
+                    cell.transaction = transaction;
+                    cell.sequence.store(pos + 1, std::memory_order_release);
+                    break;
+                }
+            }
+            else if (sequence < pos)
+            {
+                // full: this cell's earlier record is still being committed
+                std::this_thread::yield();
+                pos = enqueuePos.load(std::memory_order_relaxed);
+            }
+            else
+            {
+                pos = enqueuePos.load(std::memory_order_relaxed);
+            }
+        }
+
+        // pairs with the fence in run(): either we see the writer idle or it
+        // sees this record before sleeping
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (writerIdle.load(std::memory_order_relaxed))
+        {
+            std::lock_guard<std::mutex> lock(wakeMutex);
+            writerWake.notify_one();
+        }
+        return pos + 1;
+    }
+
+    bool GroupCommitWriter::waitDurable(std::uint64_t ticket, JournalPosition *position)
+    {
+        // failures are recorded before durableTicket is published
+        bool written = true;
+        if (durableTicket.load(std::memory_order_acquire) < ticket ||
+            hasFailedBatches.load(std::memory_order_relaxed))
+        {
+            std::unique_lock<std::mutex> lock(durableMutex);
+            durableWake.wait(lock, [&]()
+                             { return durableTicket.load(std::memory_order_acquire) >= ticket; });
+            for (auto it = failedBatches.begin(); it != failedBatches.end(); ++it)
+            {
+                if (ticket >= it->firstTicket && ticket <= it->lastTicket)
+                {
+                    if (--it->unanswered == 0)
+                    {
+                        failedBatches.erase(it);
+                        hasFailedBatches.store(!failedBatches.empty(), std::memory_order_relaxed);
+                    }
+                    written = false;
+                    break;
+                }
+            }
+        }
+
+        // the ticket's cell is ours until it is handed back
+        std::uint64_t pos = ticket - 1;
+        Cell &cell = cells[pos & (QUEUE_CAPACITY - 1)];
+        if (written && position)
+        {
+            *position = cell.position;
+        }
+        cell.sequence.store(pos + QUEUE_CAPACITY, std::memory_order_release);
+        return written;
+    }
+
+    bool GroupCommitWriter::recordReady() const
+    {
+        return cells[dequeuePos & (QUEUE_CAPACITY - 1)].sequence.load(std::memory_order_acquire) == dequeuePos + 1;
+    }
+
+    bool GroupCommitWriter::tryDequeue(Transaction &out)
+    {
+        Cell &cell = cells[dequeuePos & (QUEUE_CAPACITY - 1)];
+        if (cell.sequence.load(std::memory_order_acquire) != dequeuePos + 1)
+        {
+            return false;
+        }
+        // the cell stays taken until its waiter has read the position
+        out = cell.transaction;
+        dequeuePos++;
+        return true;
+    }
+
+    void GroupCommitWriter::run()
+    {
+        std::vector<Transaction> batch;
+        std::vector<JournalPosition> positions(config.maxBatch);
+        batch.reserve(config.maxBatch);
+        Transaction record;
+
+        for (;;)
+        {
+            if (!tryDequeue(record))
+            {
+                std::unique_lock<std::mutex> lock(wakeMutex);
+                writerIdle.store(true, std::memory_order_relaxed);
+                // recheck after announcing idleness so no submit is missed
+                std::atomic_thread_fence(std::memory_order_seq_cst);
+                writerWake.wait(lock, [&]()
+                                { return stopping.load() || recordReady(); });
+                writerIdle.store(false, std::memory_order_relaxed);
+                if (!tryDequeue(record))
+                {
+                    return; // stopping with an empty queue
+                }
+            }
+
+            // gather what is queued; linger only for a submit that has taken
+            // its ticket but not yet published its record
+            batch.clear();
+            batch.push_back(record);
+            auto deadline = std::chrono::steady_clock::now() + config.maxLinger;
+            while (batch.size() < config.maxBatch)
+            {
+                if (tryDequeue(record))
+                {
+                    batch.push_back(record);
+                    continue;
+                }
+                if (stopping.load(std::memory_order_relaxed) ||
+                    enqueuePos.load(std::memory_order_relaxed) == dequeuePos)
+                {
+                    break;
+                }
+
+                // sleep until that submit wakes us or the linger runs out
+                std::unique_lock<std::mutex> lock(wakeMutex);
+                writerIdle.store(true, std::memory_order_relaxed);
+                std::atomic_thread_fence(std::memory_order_seq_cst);
+                bool ready = writerWake.wait_until(lock, deadline, [&]()
+                                                   { return stopping.load() || recordReady(); });
+                writerIdle.store(false, std::memory_order_relaxed);
+                if (!ready)
+                {
+                    break;
+                }
+            }
+
+            bool written = journal.appendBatch(batch.data(), batch.size(), positions.data()) && journal.sync();
+            std::uint64_t lastTicket = dequeuePos;
+            if (written)
+            {
+                std::uint64_t pos = lastTicket - batch.size();
+                for (size_t i = 0; i < batch.size(); i++, pos++)
+                {
+                    cells[pos & (QUEUE_CAPACITY - 1)].position = positions[i];
+                }
+                commitCount.fetch_add(batch.size(), std::memory_order_relaxed);
+                batchCount.fetch_add(1, std::memory_order_relaxed);
+            }
+
+            {
+                std::lock_guard<std::mutex> lock(durableMutex);
+                if (!written)
+                {
+                    // only this batch fails; later batches answer for themselves
+                    failedBatches.push_back({lastTicket - batch.size() + 1, lastTicket, batch.size()});
+                    hasFailedBatches.store(true, std::memory_order_relaxed);
+                }
+                durableTicket.store(lastTicket, std::memory_order_release);
+            }
+            durableWake.notify_all();
+        }
+    }
+
+    GroupCommitWriter::Stats GroupCommitWriter::getStats() const
+    {
+        Stats stats;
+        stats.commits = commitCount.load(std::memory_order_relaxed);
+        stats.batches = batchCount.load(std::memory_order_relaxed);
+        std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - startTime;
+        if (elapsed.count() > 0)
+        {
+            stats.commitsPerSecond = static_cast<double>(stats.commits) / elapsed.count();
+        }
+        return stats;
+    }
+}
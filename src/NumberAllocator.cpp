@@ -0,0 +1,97 @@
+#include "NumberAllocator.hpp"
+#include "AccountNumber.hpp"
+#include <random>
+#include <stdexcept>
+
+namespace ATMSystem
+{
+    std::uint64_t NumberAllocator::randomKey()
+    {
+        std::random_device rd;
+        return (static_cast<std::uint64_t>(rd()) << 32) ^ rd();
+    }
+
+    NumberAllocator::NumberAllocator(int digits, std::uint64_t key)
+        : digits(digits)
+    {
+        if (digits < 2 || digits > 18 || digits % 2 != 0)
+        {
+            throw std::invalid_argument("NumberAllocator width must be even and at most 18 digits");
+        }
+
+        radix = 1;
+        for (int i = 0; i < digits / 2; i++)
+        {
+            radix *= 10;
+        }
+        capacity = radix * radix;
+
+        // derive independent round keys from the one seed
+        for (int i = 0; i < ROUNDS; i++)
+        {
+            key += 0x9e3779b97f4a7c15ULL;
+            roundKeys[i] = mixAccountKey(key);
+        }
+    }
+
+    std::uint64_t NumberAllocator::permute(std::uint64_t index) const
+    {
+        // each round (left, right) -> (right, left + F(right)) mod radix is
+        // invertible, so the network is a bijection on [0, radix^2)
+        std::uint64_t left = index / radix;
+        std::uint64_t right = index % radix;
+        for (std::uint64_t roundKey : roundKeys)
+        {
+            std::uint64_t mixed = (left + mixAccountKey(right ^ roundKey) % radix) % radix;
+            left = right;
+            right = mixed;
+        }
+        return left * radix + right;
+    }
+
+    std::optional<std::uint64_t> NumberAllocator::allocate()
+    {
+        auto index = allocateRange(1);
+        if (!index)
+        {
+            return std::nullopt;
+        }
+        return permute(*index);
+    }
+
+    std::optional<std::uint64_t> NumberAllocator::allocateRange(std::uint64_t count)
+    {
+        // the counter only moves when the whole range fits, so a request
+        // that fails leaves the remaining numbers for smaller ones
+        std::uint64_t first = nextIndex.load(std::memory_order_relaxed);
+        do
+        {
+            if (first > capacity || count > capacity - first)
+            {
+                return std::nullopt;
+            }
+        } while (!nextIndex.compare_exchange_weak(first, first + count, std::memory_order_relaxed));
+        return first;
+    }
+
+    std::optional<std::string> NumberAllocator::allocateString()
+    {
+        auto number = allocate();
+        if (!number)
+        {
+            return std::nullopt;
+        }
+        return format(*number);
+    }
+
+    std::string NumberAllocator::format(std::uint64_t number) const
+    {
+        std::string text(static_cast<size_t>(digits), '0');
+        for (int i = digits; i > 0 && number > 0; i--)
+        {
+            text[i - 1] = static_cast<char>('0' + number % 10);
+            number /= 10;
+        }
+        return text;
+    }
+}
@@ -0,0 +1,399 @@
+#include "RecoveryManager.hpp"
+#include "TransactionId.hpp"
+#include "WorkerPool.hpp"
+#include <unordered_map>
+#include <algorithm>
+#include <cstring>
+#include <cstdio>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+namespace ATMSystem
+{
+    namespace
+    {
+        bool writeAll(int fd, const void *data, size_t size)
+        {
+            const char *bytes = static_cast<const char *>(data);
+            while (size > 0)
+            {
+                ssize_t written = ::write(fd, bytes, size);
+                if (written < 0)
+                {
+                    return false;
+                }
+                bytes += written;
+                size -= static_cast<size_t>(written);
+            }
+            return true;
+        }
+
+        // Read-only mapping of a whole file, released on scope exit
+        class MappedFile
+        {
+        private:
+            void *map = nullptr;
+            size_t bytes = 0;
+
+        public:
+            explicit MappedFile(const std::string &path)
+            {
+                int fd = ::open(path.c_str(), O_RDONLY);
+                if (fd < 0)
+                {
+                    return;
+                }
+                struct stat info;
+                if (::fstat(fd, &info) == 0 && info.st_size > 0)
+                {
+                    void *result = ::mmap(nullptr, static_cast<size_t>(info.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+                    if (result != MAP_FAILED)
+                    {
+                        map = result;
+                        bytes = static_cast<size_t>(info.st_size);
+                    }
+                }
+                ::close(fd);
+            }
+
+            ~MappedFile()
+            {
+                if (map)
+                {
+                    ::munmap(map, bytes);
+                }
+            }
+
+            MappedFile(const MappedFile &) = delete;
+            MappedFile &operator=(const MappedFile &) = delete;
+
+            const char *data() const { return static_cast<const char *>(map); }
+            size_t size() const { return bytes; }
+        };
+    }
+
+    RecoveryManager::RecoveryManager(const std::string &dir,
+                                     const std::vector<std::shared_ptr<Bank>> &bankList,
+                                     const std::vector<std::shared_ptr<ATM>> &atmList)
+        : directory(dir), banks(bankList), atms(atmList)
+    {
+    }
+
+    std::uint64_t RecoveryManager::totalAppends() const
+    {
+        std::uint64_t total = 0;
+        for (const auto &atm : atms)
+        {
+            total += atm->getJournal().getAppendCount();
+        }
+        return total;
+    }
+
+    bool RecoveryManager::readMarks(const char *&cursor, const char *end, CheckpointHeader &header,
+                                    std::unordered_map<std::string, JournalPosition> &marks)
+    {
+        if (!cursor || static_cast<size_t>(end - cursor) < sizeof(header))
+        {
+            return false;
+        }
+        std::memcpy(&header, cursor, sizeof(header));
+        cursor += sizeof(header);
+        if (std::memcmp(header.magic, MAGIC, sizeof(MAGIC)) != 0 || header.version != VERSION ||
+            static_cast<size_t>(end - cursor) / sizeof(JournalMark) < header.journalCount)
+        {
+            return false;
+        }
+        for (std::uint32_t i = 0; i < header.journalCount; i++)
+        {
+            JournalMark mark;
+            std::memcpy(&mark, cursor, sizeof(mark));
+            cursor += sizeof(mark);
+            marks.emplace(std::string(mark.serial, strnlen(mark.serial, sizeof(mark.serial))), mark.position);
+        }
+        return true;
+    }
+
+    bool RecoveryManager::hasUnappliedRecords(bool stateMatchesCheckpoint) const
+    {
+        MappedFile checkpoint(checkpointPath());
+        std::unordered_map<std::string, JournalPosition> marks;
+        if (stateMatchesCheckpoint)
+        {
+            const char *cursor = checkpoint.data();
+            CheckpointHeader header;
+            readMarks(cursor, cursor + checkpoint.size(), header, marks);
+        }
+
+        for (const auto &serial : TransactionJournal::listSerials(directory))
+        {
+            auto mark = marks.find(serial);
+            JournalPosition applied = mark != marks.end() ? mark->second : JournalPosition{};
+            JournalPosition end = TransactionJournal::endPosition(directory, serial);
+            if (end.segment > applied.segment || (end.segment == applied.segment && end.record > applied.record))
+            {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    RecoveryManager::Result RecoveryManager::recover()
+    {
+        Result result;
+
+        // checkpoint layout: header, journal marks, then per bank its name
+        // length, name, account count and that many balance entries
+        MappedFile checkpoint(checkpointPath());
+        std::unordered_map<std::string, JournalPosition> marks;
+        std::unordered_map<std::string, std::pair<const BalanceEntry *, std::uint64_t>> sections;
+
+        const char *cursor = checkpoint.data();
+        const char *end = cursor + checkpoint.size();
+        CheckpointHeader header;
+        bool valid = readMarks(cursor, end, header, marks) && header.bankCount == banks.size();
+        if (valid)
+        {
+            for (std::uint32_t i = 0; i < header.bankCount && valid; i++)
+            {
+                std::uint32_t nameLength;
+                std::uint64_t count;
+                valid = static_cast<size_t>(end - cursor) >= sizeof(nameLength);
+                if (valid)
+                {
+                    std::memcpy(&nameLength, cursor, sizeof(nameLength));
+                    cursor += sizeof(nameLength);
+                    valid = static_cast<size_t>(end - cursor) >= nameLength + sizeof(count);
+                }
+                if (valid)
+                {
+                    std::string name(cursor, nameLength);
+                    cursor += nameLength;
+                    std::memcpy(&count, cursor, sizeof(count));
+                    cursor += sizeof(count);
+                    valid = static_cast<std::uint64_t>(end - cursor) / sizeof(BalanceEntry) >= count &&
+                            sections.emplace(std::move(name), std::make_pair(reinterpret_cast<const BalanceEntry *>(cursor), count)).second;
+                    cursor += valid ? count * sizeof(BalanceEntry) : 0;
+                }
+            }
+            // every bank needs its own section; anything else means the bank
+            // set changed, and the whole checkpoint is dropped for a full replay
+            for (const auto &bank : banks)
+            {
+                valid = valid && sections.count(bank->getName()) > 0;
+            }
+        }
+        if (!valid)
+        {
+            marks.clear();
+            sections.clear();
+        }
+
+        // balances and replay run one job per bank, so no two jobs touch
+        // the same account
+        size_t threads = std::min(banks.size(), WorkerPool::defaultThreadCount());
+        WorkerPool pool(threads > 1 ? threads : 0);
+        std::vector<size_t> restored(banks.size(), 0);
+        for (size_t i = 0; i < banks.size(); i++)
+        {
+            auto section = sections.find(banks[i]->getName());
+            if (section == sections.end())
+            {
+                continue;
+            }
+            pool.submit([&, i, entries = section->second.first, count = section->second.second]()
+                        {
+                            for (std::uint64_t e = 0; e < count; e++)
+                            {
+                                BalanceEntry entry;
+                                std::memcpy(&entry, entries + e, sizeof(entry));
+                                if (banks[i]->restoreBalance(entry.key, Money(entry.won)))
+                                {
+                                    restored[i]++;
+                                }
+                            }
+                        });
+        }
+        pool.wait();
+        for (size_t count : restored)
+        {
+            result.restoredBalances += count;
+        }
+
+        // The journals are read once. Each record goes to the banks owning
+        // its card and counterparty account, and a batch is replayed once
+        // REPLAY_BATCH records are waiting.
+        std::unordered_map<const Bank *, size_t> bankSlots;
+        for (size_t i = 0; i < banks.size(); i++)
+        {
+            bankSlots.emplace(banks[i].get(), i);
+        }
+        const AccountDirectory *accountDirectory = banks.empty() ? nullptr : banks.front()->getAccountDirectory().get();
+        auto slotOf = [&](AccountKey key) -> size_t
+        {
+            if (accountDirectory)
+            {
+                const auto *entry = accountDirectory->find(key);
+                auto slot = entry ? bankSlots.find(entry->bank) : bankSlots.end();
+                return slot != bankSlots.end() ? slot->second : banks.size();
+            }
+            for (size_t i = 0; i < banks.size(); i++)
+            {
+                if (banks[i]->getAccount(key))
+                {
+                    return i;
+                }
+            }
+            return banks.size();
+        };
+
+        std::vector<std::vector<Transaction>> pending(banks.size());
+        std::vector<std::vector<TransactionId>> invalid(banks.size());
+        size_t pendingCount = 0;
+        auto replayPending = [&]()
+        {
+            for (size_t i = 0; i < banks.size(); i++)
+            {
+                if (pending[i].empty())
+                {
+                    continue;
+                }
+                pool.submit([&, i]()
+                            {
+                                for (const auto &transaction : pending[i])
+                                {
+                                    if (banks[i]->replayTransaction(transaction) == ReplayStatus::INVALID_RECORD)
+                                    {
+                                        invalid[i].push_back(transaction.getTransactionId());
+                                    }
+                                }
+                            });
+            }
+            pool.wait();
+            for (auto &records : pending)
+            {
+                records.clear();
+            }
+            pendingCount = 0;
+        };
+
+        // the id with the highest sequence; a later second may carry a
+        // lower sequence from another thread's block
+        TransactionId lastId = 0;
+        for (const auto &serial : TransactionJournal::listSerials(directory))
+        {
+            auto mark = marks.find(serial);
+            TransactionJournal::scan(directory, serial, mark != marks.end() ? mark->second : JournalPosition{},
+                                     [&](const Transaction &transaction)
+                                     {
+                                         size_t card = slotOf(transaction.getCardNumber());
+                                         size_t counterparty = transaction.getCounterpartyAccount() != NO_ACCOUNT_KEY
+                                                                   ? slotOf(transaction.getCounterpartyAccount())
+                                                                   : banks.size();
+                                         if (card < banks.size())
+                                         {
+                                             pending[card].push_back(transaction);
+                                         }
+                                         if (counterparty < banks.size() && counterparty != card)
+                                         {
+                                             pending[counterparty].push_back(transaction);
+                                         }
+                                         result.replayedRecords++;
+                                         if (TransactionIdGenerator::sequenceOf(transaction.getTransactionId()) >
+                                             TransactionIdGenerator::sequenceOf(lastId))
+                                         {
+                                             lastId = transaction.getTransactionId();
+                                         }
+                                         if (++pendingCount == REPLAY_BATCH)
+                                         {
+                                             replayPending();
+                                         }
+                                     });
+        }
+        replayPending();
+        TransactionIdGenerator::advancePast(lastId);
+
+        // a record touching two banks may be reported by both
+        for (const auto &ids : invalid)
+        {
+            result.invalidRecords.insert(result.invalidRecords.end(), ids.begin(), ids.end());
+        }
+        std::sort(result.invalidRecords.begin(), result.invalidRecords.end());
+        result.invalidRecords.erase(std::unique(result.invalidRecords.begin(), result.invalidRecords.end()),
+                                    result.invalidRecords.end());
+
+        for (const auto &atm : atms)
+        {
+            if (atm->restoreCash())
+            {
+                result.restoredATMs++;
+            }
+        }
+        return result;
+    }
+
+    bool RecoveryManager::writeCheckpoint()
+    {
+        std::string tempPath = checkpointPath() + ".tmp";
+        int fd = ::open(tempPath.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+        if (fd < 0)
+        {
+            return false;
+        }
+
+        std::vector<std::string> serials = TransactionJournal::listSerials(directory);
+
+        CheckpointHeader header{};
+        std::memcpy(header.magic, MAGIC, sizeof(MAGIC));
+        header.version = VERSION;
+        header.journalCount = static_cast<std::uint32_t>(serials.size());
+        header.bankCount = static_cast<std::uint32_t>(banks.size());
+        bool ok = writeAll(fd, &header, sizeof(header));
+
+        for (const auto &serial : serials)
+        {
+            JournalMark mark{};
+            std::memcpy(mark.serial, serial.data(), std::min(serial.size(), sizeof(mark.serial)));
+            mark.position = TransactionJournal::endPosition(directory, serial);
+            ok = ok && writeAll(fd, &mark, sizeof(mark));
+        }
+
+        std::vector<BalanceEntry> entries;
+        for (const auto &bank : banks)
+        {
+            std::string name = bank->getName();
+            auto nameLength = static_cast<std::uint32_t>(name.size());
+            ok = ok && writeAll(fd, &nameLength, sizeof(nameLength));
+            ok = ok && writeAll(fd, name.data(), name.size());
+
+            entries.clear();
+            entries.reserve(bank->getAccountCount());
+            bank->forEachAccount([&](const std::shared_ptr<Account> &account)
+                                 { entries.push_back({account->getKey(), account->getBalance().toWon()}); });
+            std::uint64_t count = entries.size();
+            ok = ok && writeAll(fd, &count, sizeof(count));
+            ok = ok && writeAll(fd, entries.data(), entries.size() * sizeof(BalanceEntry));
+        }
+
+        ok = ok && ::fsync(fd) == 0;
+        ::close(fd);
+        if (!ok || std::rename(tempPath.c_str(), checkpointPath().c_str()) != 0)
+        {
+            std::remove(tempPath.c_str());
+            return false;
+        }
+
+        appendsAtCheckpoint = totalAppends();
+        return true;
+    }
+
+    bool RecoveryManager::maybeCheckpoint()
+    {
+        if (totalAppends() - appendsAtCheckpoint < CHECKPOINT_INTERVAL)
+        {
+            return true;
+        }
+        return writeCheckpoint();
+    }
+}
@@ -8,10 +8,8 @@
 
 namespace ATMSystem
 {
-    std::atomic<uint64_t> Session::nextTransactionId{0};
-
     Session::Session(const std::string &card, std::shared_ptr<Account> acc, std::shared_ptr<ATM> atmPtr)
-        : cardNumber(card), account(acc), atm(atmPtr),
+        : cardNumber(parseAccountNumber(card).value_or(NO_ACCOUNT_KEY)), account(acc), atm(atmPtr),
           startTime(std::chrono::system_clock::now()), isActive(true),
           withdrawalCount(0), checkDepositCount(0)
     {
@@ -20,31 +18,29 @@ namespace ATMSystem
         sessionId = std::to_string(std::chrono::duration_cast<std::chrono::milliseconds>(duration).count());
     }
 
-    std::string Session::generateTransactionId()
-    {
-        auto now = std::chrono::system_clock::now();
-        auto now_t = std::chrono::system_clock::to_time_t(now);
-        std::stringstream ss;
-        ss << std::put_time(std::localtime(&now_t), "%Y%m%d-%H%M%S-");
-        ss << std::setfill('0') << std::setw(6) << nextTransactionId++;
-        return ss.str();
-    }
-
-    std::string Session::addTransaction(TransactionType type, double amount, double fee, const std::string &details)
+    TransactionId Session::addTransaction(TransactionType type, Money amount, Money fee,
+                                          TransactionChannel channel, AccountKey counterparty,
+                                          std::uint32_t counterpartyBank)
     {
         if (!isActive)
-            return "";
+            return 0;
 
-        std::string transId = generateTransactionId();
-        Transaction transaction(transId, cardNumber, type, amount, fee, details);
-        transactions.push_back(transaction);
+        auto atmPtr = atm.lock();
+        if (!atmPtr)
+            return 0;
+
+        TransactionId transId = TransactionIdGenerator::next();
+        Transaction transaction(transId, cardNumber, type, amount, fee, channel, counterparty, counterpartyBank);
+
+        // the session keeps only records that reached the journal
+        if (!atmPtr->addToHistory(transaction))
+            return 0;
 
-        // add to ATM's global transaction history
-        if (auto atmPtr = atm.lock())
+        transactions.push_back(transaction);
+        if (account)
         {
-            atmPtr->addToHistory(transaction);
+            account->getBank()->getAggregates().record(transaction);
         }
-
         return transId;
     }
 
@@ -60,13 +56,7 @@ namespace ATMSystem
         if (!reason.empty())
         {
             UI ui(false);
-            std::string message = ui.getLocalizedMessage("SYSTEM_ERROR_LOG");
-            size_t pos = message.find("{}");
-            if (pos != std::string::npos)
-            {
-                message.replace(pos, 2, reason);
-            }
-            std::cout << message << std::endl;
+            std::cout << ui.formatMessage(MessageId::SYSTEM_ERROR_LOG, reason) << std::endl;
         }
     }
 
@@ -76,15 +66,15 @@ namespace ATMSystem
         status.lastError = error;
 
         // set appropriate error
-        if (error.find(ui.getLocalizedMessage("INSUFFICIENT_FUNDS")) != std::string::npos)
+        if (error.find(ui.getLocalizedMessage(MessageId::INSUFFICIENT_FUNDS)) != std::string::npos)
         {
             status.insufficientFunds = true;
         }
-        else if (error.find(ui.getLocalizedMessage("INSUFFICIENT_CASH_ERROR")) != std::string::npos)
+        else if (error.find(ui.getLocalizedMessage(MessageId::INSUFFICIENT_CASH_ERROR)) != std::string::npos)
         {
             status.insufficientCash = true;
         }
-        else if (error.find(ui.getLocalizedMessage("CARD_ERROR")) != std::string::npos)
+        else if (error.find(ui.getLocalizedMessage(MessageId::CARD_ERROR)) != std::string::npos)
         {
             status.cardError = true;
         }
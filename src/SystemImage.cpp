@@ -0,0 +1,392 @@
+#include "SystemImage.hpp"
+#include "ATM.hpp"
+#include "Bank.hpp"
+#include "AccountDirectory.hpp"
+#include "TransactionHistoryStore.hpp"
+#include <algorithm>
+#include <unordered_map>
+#include <cstring>
+#include <cstdio>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+namespace ATMSystem
+{
+    namespace
+    {
+        constexpr size_t WRITE_BUFFER_SIZE = 1 << 20;
+
+        size_t align8(size_t offset)
+        {
+            return (offset + 7) & ~size_t(7);
+        }
+
+        // Positioned writes through a fixed buffer
+        class ImageWriter
+        {
+        private:
+            int fd;
+            off_t position;
+            std::vector<char> buffer;
+            bool ok = true;
+
+        public:
+            ImageWriter(int fd, off_t position) : fd(fd), position(position) { buffer.reserve(WRITE_BUFFER_SIZE); }
+
+            void append(const void *bytes, size_t length)
+            {
+                if (buffer.size() + length > WRITE_BUFFER_SIZE)
+                {
+                    flush();
+                }
+                if (length > WRITE_BUFFER_SIZE)
+                {
+                    write(bytes, length);
+                    return;
+                }
+                const char *begin = static_cast<const char *>(bytes);
+                buffer.insert(buffer.end(), begin, begin + length);
+            }
+
+            void flush()
+            {
+                write(buffer.data(), buffer.size());
+                buffer.clear();
+            }
+
+            bool good() const { return ok; }
+
+        private:
+            void write(const void *bytes, size_t length)
+            {
+                const char *cursor = static_cast<const char *>(bytes);
+                while (ok && length > 0)
+                {
+                    ssize_t written = ::pwrite(fd, cursor, length, position);
+                    if (written < 0)
+                    {
+                        ok = false;
+                        return;
+                    }
+                    cursor += written;
+                    length -= static_cast<size_t>(written);
+                    position += written;
+                }
+            }
+        };
+    }
+
+    SystemImage::Layout SystemImage::layoutFor(const Header &header)
+    {
+        Layout layout;
+        layout.banks = align8(sizeof(Header));
+        layout.atms = layout.banks + header.bankCount * sizeof(BankRecord);
+        layout.connections = layout.atms + header.atmCount * sizeof(ATMRecord);
+        layout.accounts = align8(layout.connections + header.connectionCount * sizeof(std::uint32_t));
+        layout.strings = layout.accounts + header.accountCount * sizeof(AccountRecord);
+        layout.end = layout.strings + header.stringBytes;
+        return layout;
+    }
+
+    bool SystemImage::save(const std::string &path,
+                           const std::vector<std::shared_ptr<Bank>> &banks,
+                           const std::vector<std::shared_ptr<ATM>> &atms)
+    {
+        std::string tempPath = path + ".tmp";
+        int fd = ::open(tempPath.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+        if (fd < 0)
+        {
+            return false;
+        }
+
+        std::string strings;
+        std::unordered_map<const Bank *, std::uint32_t> bankIndex;
+        std::vector<BankRecord> bankRecords;
+        for (const auto &bank : banks)
+        {
+            bankIndex.emplace(bank.get(), static_cast<std::uint32_t>(bankRecords.size()));
+            BankRecord record{};
+            record.nameOffset = strings.size();
+            record.nameLength = static_cast<std::uint32_t>(bank->getName().size());
+            strings += bank->getName();
+            bankRecords.push_back(record);
+        }
+
+        std::vector<ATMRecord> atmRecords;
+        std::vector<std::uint32_t> connections;
+        for (const auto &atm : atms)
+        {
+            ATMRecord record{};
+            const std::string serial = atm->getSerialNumber();
+            std::memcpy(record.serial, serial.data(), std::min(serial.size(), sizeof(record.serial) - 1));
+            record.primaryBank = bankIndex.at(atm->getPrimaryBank().get());
+            record.firstConnection = static_cast<std::uint32_t>(connections.size());
+            for (const auto &bank : atm->getConnectedBanks())
+            {
+                connections.push_back(bankIndex.at(bank.get()));
+            }
+            record.connectionCount = static_cast<std::uint32_t>(connections.size()) - record.firstConnection;
+            record.type = static_cast<std::uint8_t>(atm->getBankType());
+            record.language = static_cast<std::uint8_t>(atm->getLanguageSupport());
+            for (size_t slot = 0; slot < CashCassettes::SLOT_COUNT; slot++)
+            {
+                record.cash[slot] = atm->getCassettes().getCount(slot);
+            }
+            atmRecords.push_back(record);
+        }
+
+        Header header{};
+        std::memcpy(header.magic, MAGIC, sizeof(MAGIC));
+        header.version = VERSION;
+        header.bankCount = static_cast<std::uint32_t>(bankRecords.size());
+        header.atmCount = static_cast<std::uint32_t>(atmRecords.size());
+        header.connectionCount = static_cast<std::uint32_t>(connections.size());
+        Layout layout = layoutFor(header);
+
+        // accounts go first, sorted by key within each bank
+        ImageWriter accountWriter(fd, static_cast<off_t>(layout.accounts));
+        std::vector<const Account *> sorted;
+        bool pinsValid = true;
+        for (size_t index = 0; index < banks.size() && pinsValid; index++)
+        {
+            sorted.clear();
+            banks[index]->forEachAccount([&](const std::shared_ptr<Account> &account)
+                                         { sorted.push_back(account.get()); });
+            std::sort(sorted.begin(), sorted.end(), [](const Account *a, const Account *b)
+                      { return a->getKey() < b->getKey(); });
+
+            bankRecords[index].firstAccount = header.accountCount;
+            bankRecords[index].accountCount = sorted.size();
+            for (const Account *account : sorted)
+            {
+                AccountRecord record{};
+                record.key = account->getKey();
+                record.balance = account->getBalance().toWon();
+                const std::string user = account->getUserName();
+                record.userOffset = strings.size();
+                record.userLength = static_cast<std::uint32_t>(user.size());
+                const std::string pin = account->getPin();
+                // the record holds exactly one PIN; refuse rather than truncate
+                if (pin.size() != sizeof(record.pin))
+                {
+                    pinsValid = false;
+                    break;
+                }
+                std::memcpy(record.pin, pin.data(), sizeof(record.pin));
+                strings += user;
+                accountWriter.append(&record, sizeof(record));
+            }
+            header.accountCount += sorted.size();
+        }
+        header.stringBytes = strings.size();
+        layout = layoutFor(header);
+        accountWriter.append(strings.data(), strings.size());
+        accountWriter.flush();
+
+        // then the fixed sections in front of them
+        ImageWriter writer(fd, 0);
+        writer.append(&header, sizeof(header));
+        std::vector<char> padding(layout.banks - sizeof(header), 0);
+        writer.append(padding.data(), padding.size());
+        writer.append(bankRecords.data(), bankRecords.size() * sizeof(BankRecord));
+        writer.append(atmRecords.data(), atmRecords.size() * sizeof(ATMRecord));
+        writer.append(connections.data(), connections.size() * sizeof(std::uint32_t));
+        padding.assign(layout.accounts - (layout.connections + connections.size() * sizeof(std::uint32_t)), 0);
+        writer.append(padding.data(), padding.size());
+        writer.flush();
+
+        bool ok = pinsValid && accountWriter.good() && writer.good() && ::fsync(fd) == 0;
+        ::close(fd);
+        if (!ok || std::rename(tempPath.c_str(), path.c_str()) != 0)
+        {
+            std::remove(tempPath.c_str());
+            return false;
+        }
+        return true;
+    }
+
+    std::shared_ptr<SystemImage> SystemImage::open(const std::string &path)
+    {
+        int fd = ::open(path.c_str(), O_RDONLY);
+        if (fd < 0)
+        {
+            return nullptr;
+        }
+
+        struct stat info;
+        if (::fstat(fd, &info) != 0 || static_cast<size_t>(info.st_size) < sizeof(Header))
+        {
+            ::close(fd);
+            return nullptr;
+        }
+
+        size_t size = static_cast<size_t>(info.st_size);
+        void *map = ::mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+        ::close(fd);
+        if (map == MAP_FAILED)
+        {
+            return nullptr;
+        }
+
+        std::shared_ptr<SystemImage> image(new SystemImage());
+        image->data = static_cast<const char *>(map);
+        image->size = size;
+
+        const Header &header = image->header();
+        if (std::memcmp(header.magic, MAGIC, sizeof(MAGIC)) != 0 || header.version != VERSION)
+        {
+            return nullptr;
+        }
+        image->layout = layoutFor(header);
+        if (image->layout.end > size)
+        {
+            return nullptr;
+        }
+
+        // reject records that point outside the image
+        for (std::uint32_t bank = 0; bank < header.bankCount; bank++)
+        {
+            const BankRecord &record = image->bankRecord(bank);
+            if (record.firstAccount + record.accountCount > header.accountCount ||
+                record.nameOffset + record.nameLength > header.stringBytes)
+            {
+                return nullptr;
+            }
+        }
+        for (std::uint32_t atm = 0; atm < header.atmCount; atm++)
+        {
+            const ATMRecord &record = image->atmRecord(atm);
+            if (record.primaryBank >= header.bankCount ||
+                record.firstConnection + record.connectionCount > header.connectionCount ||
+                record.type > static_cast<std::uint8_t>(BankType::MULTI_BANK) ||
+                record.language > static_cast<std::uint8_t>(LanguageSupport::BILINGUAL))
+            {
+                return nullptr;
+            }
+        }
+        const std::uint32_t *connections = reinterpret_cast<const std::uint32_t *>(image->data + image->layout.connections);
+        if (std::any_of(connections, connections + header.connectionCount, [&](std::uint32_t bank)
+                        { return bank >= header.bankCount; }))
+        {
+            return nullptr;
+        }
+        return image;
+    }
+
+    SystemImage::~SystemImage()
+    {
+        if (data)
+        {
+            ::munmap(const_cast<char *>(data), size);
+        }
+    }
+
+    const SystemImage::BankRecord &SystemImage::bankRecord(std::uint32_t bank) const
+    {
+        return reinterpret_cast<const BankRecord *>(data + layout.banks)[bank];
+    }
+
+    const SystemImage::ATMRecord &SystemImage::atmRecord(std::uint32_t atm) const
+    {
+        return reinterpret_cast<const ATMRecord *>(data + layout.atms)[atm];
+    }
+
+    std::string_view SystemImage::text(std::uint64_t offset, std::uint32_t length) const
+    {
+        if (offset + length > header().stringBytes)
+        {
+            return {};
+        }
+        return std::string_view(data + layout.strings + offset, length);
+    }
+
+    std::string_view SystemImage::getUserName(const AccountRecord &record) const
+    {
+        return text(record.userOffset, record.userLength);
+    }
+
+    const SystemImage::AccountRecord *SystemImage::accountsBegin(std::uint32_t bank) const
+    {
+        return reinterpret_cast<const AccountRecord *>(data + layout.accounts) + bankRecord(bank).firstAccount;
+    }
+
+    const SystemImage::AccountRecord *SystemImage::accountsEnd(std::uint32_t bank) const
+    {
+        return accountsBegin(bank) + bankRecord(bank).accountCount;
+    }
+
+    const SystemImage::AccountRecord *SystemImage::findAccount(std::uint32_t bank, AccountKey key) const
+    {
+        const AccountRecord *begin = accountsBegin(bank);
+        const AccountRecord *end = accountsEnd(bank);
+        const AccountRecord *found = std::lower_bound(begin, end, key, [](const AccountRecord &record, AccountKey value)
+                                                      { return record.key < value; });
+        return (found != end && found->key == key) ? found : nullptr;
+    }
+
+    void SystemImage::restore(const std::shared_ptr<AccountDirectory> &directory,
+                              const std::shared_ptr<TransactionHistoryStore> &historyStore,
+                              std::vector<std::shared_ptr<Bank>> &banks,
+                              std::vector<std::shared_ptr<ATM>> &atms) const
+    {
+        auto self = shared_from_this();
+        const Header &imageHeader = header();
+
+        std::vector<std::shared_ptr<Bank>> restored;
+        for (std::uint32_t index = 0; index < imageHeader.bankCount; index++)
+        {
+            const BankRecord &record = bankRecord(index);
+            auto bank = std::make_shared<Bank>(std::string(text(record.nameOffset, record.nameLength)), directory);
+            bank->attachImage(self, index);
+            restored.push_back(bank);
+        }
+
+        if (directory)
+        {
+            // accounts not looked up yet are found in the image on a miss
+            std::vector<Bank *> owners;
+            for (const auto &bank : restored)
+            {
+                owners.push_back(bank.get());
+            }
+            directory->setLoader([self, owners](AccountKey key)
+                                 {
+                                     for (std::uint32_t index = 0; index < owners.size(); index++)
+                                     {
+                                         if (self->findAccount(index, key))
+                                         {
+                                             return owners[index]->getAccount(key) != nullptr;
+                                         }
+                                     }
+                                     return false;
+                                 });
+        }
+
+        const std::uint32_t *connections = reinterpret_cast<const std::uint32_t *>(data + layout.connections);
+        for (std::uint32_t index = 0; index < imageHeader.atmCount; index++)
+        {
+            const ATMRecord &record = atmRecord(index);
+            std::string serial(record.serial, strnlen(record.serial, sizeof(record.serial)));
+            auto atm = std::make_shared<ATM>(serial, static_cast<BankType>(record.type),
+                                             static_cast<LanguageSupport>(record.language),
+                                             restored[record.primaryBank]);
+            for (std::uint32_t i = 0; i < record.connectionCount; i++)
+            {
+                atm->addConnectedBank(restored[connections[record.firstConnection + i]]);
+            }
+
+            std::map<int, int> cash;
+            for (size_t slot = 0; slot < CashCassettes::SLOT_COUNT; slot++)
+            {
+                cash[CASH_DENOMINATIONS[slot]] = record.cash[slot];
+            }
+            atm->addCash(cash);
+            atm->setHistoryStore(historyStore);
+            atms.push_back(atm);
+        }
+
+        banks.insert(banks.end(), restored.begin(), restored.end());
+    }
+}
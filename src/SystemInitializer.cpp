@@ -1,60 +1,105 @@
 #include "SystemInitializer.hpp"
+#include "SystemProvisioner.hpp"
+#include "SystemImage.hpp"
 #include <iostream>
-#include <random>
-#include <set>
+#include <algorithm>
+#include <stdexcept>
 
 namespace ATMSystem
 {
 
-    std::string SystemInitializer::generateSerialNumber()
+    std::string SystemInitializer::generateAccountNumber()
     {
-        static std::random_device rd;
-        static std::mt19937 gen(rd());
-        static std::uniform_int_distribution<> dis(0, 999999);
-        static std::set<std::string> usedSerials;
-
-        std::string serial;
-        do
+        auto accountNum = accountNumbers.allocateString();
+        if (accountNum && *accountNum == ADMIN_CARD)
         {
-            // generate new serial number
-            serial = std::to_string(dis(gen));
-            while (serial.length() < 6)
-            {
-                serial = "0" + serial;
-            }
-        } while (usedSerials.find(serial) != usedSerials.end());
+            // the permutation hands out each number once, so one skip suffices
+            accountNum = accountNumbers.allocateString();
+        }
+        if (!accountNum)
+        {
+            throw std::runtime_error("account number space exhausted");
+        }
+        return *accountNum;
+    }
 
-        usedSerials.insert(serial);
-        return serial;
+    std::string SystemInitializer::generateSerialNumber()
+    {
+        auto serial = serialNumbers.allocateString();
+        if (!serial)
+        {
+            throw std::runtime_error("ATM serial number space exhausted");
+        }
+        return *serial;
     }
 
     void SystemInitializer::initializeSystem()
     {
-        ui.displayMessage("SYSTEM_INIT");
+        ui.displayMessage(MessageId::SYSTEM_INIT);
         initializeBanks();
+        // index earlier runs before any ATM appends to its journal
+        historyStore->loadJournals(JOURNAL_DIRECTORY);
         initializeATMs();
-        ui.displayMessage("SYSTEM_INIT_COMPLETE");
+        ui.displayMessage(MessageId::SYSTEM_INIT_COMPLETE);
+    }
+
+    bool SystemInitializer::provisionFromFile(const std::string &path)
+    {
+        ui.displayMessage(MessageId::SYSTEM_INIT);
+        historyStore->loadJournals(JOURNAL_DIRECTORY);
+
+        SystemProvisioner provisioner(banks, atms, accountDirectory, historyStore, accountNumbers);
+        if (!provisioner.load(path))
+        {
+            std::cout << ui.formatMessage(MessageId::PROVISION_FAILED, path, provisioner.getErrorLine()) << "\n";
+            return false;
+        }
+
+        const auto &counts = provisioner.getCounts();
+        std::cout << ui.formatMessage(MessageId::PROVISION_COMPLETE, counts.banks, counts.accounts, counts.atms,
+                                      counts.skippedAccounts)
+                  << "\n";
+        ui.displayMessage(MessageId::SYSTEM_INIT_COMPLETE);
+        return true;
+    }
+
+    bool SystemInitializer::restoreFromImage(const std::string &path)
+    {
+        auto image = SystemImage::open(path);
+        if (!image)
+        {
+            return false;
+        }
+
+        historyStore->loadJournals(JOURNAL_DIRECTORY);
+        image->restore(accountDirectory, historyStore, banks, atms);
+        std::cout << ui.formatMessage(MessageId::IMAGE_RESTORED, banks.size(), image->getAccountCount(), atms.size(), path)
+                  << "\n";
+        return true;
+    }
+
+    bool SystemInitializer::saveImage(const std::string &path) const
+    {
+        return SystemImage::save(path, banks, atms);
     }
 
     void SystemInitializer::initializeBanks()
     {
-        std::cout << ui.getLocalizedMessage("ENTER_NUM_BANKS");
+        std::cout << ui.getLocalizedView(MessageId::ENTER_NUM_BANKS);
         int numBanks;
         std::cin >> numBanks;
         std::cin.ignore();
 
         for (int i = 0; i < numBanks; i++)
         {
-            std::string message = ui.getLocalizedMessage("BANK_NAME_PROMPT");
-            size_t pos = message.find("{}");
-            message.replace(pos, 2, std::to_string(i + 1));
+            std::string message = ui.formatMessage(MessageId::BANK_NAME_PROMPT, i + 1);
             std::cout << "\n"
                       << message;
 
             std::string bankName;
             std::getline(std::cin, bankName);
 
-            auto bank = std::make_shared<Bank>(bankName);
+            auto bank = std::make_shared<Bank>(bankName, accountDirectory);
             banks.push_back(bank);
             initializeBankAccounts(bank);
         }
@@ -63,11 +108,11 @@ namespace ATMSystem
     void SystemInitializer::initializeATMs()
     {
         std::cout << "\n"
-                  << ui.getLocalizedMessage("ENTER_NUM_ATMS");
+                  << ui.getLocalizedView(MessageId::ENTER_NUM_ATMS);
         int numATMs;
         while (!(std::cin >> numATMs) || numATMs <= 0)
         {
-            ui.displayMessage("ENTER_VALID_NUMBER");
+            ui.displayMessage(MessageId::ENTER_VALID_NUMBER);
             std::cin.clear();
             std::cin.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
         }
@@ -81,14 +126,12 @@ namespace ATMSystem
             int typeChoice;
             do
             {
-                std::string prompt = ui.getLocalizedMessage("ATM_TYPE_PROMPT");
-                size_t pos = prompt.find("{}");
-                prompt.replace(pos, 2, std::to_string(i + 1));
+                std::string prompt = ui.formatMessage(MessageId::ATM_TYPE_PROMPT, i + 1);
                 std::cout << prompt;
                 std::cin >> typeChoice;
                 if (typeChoice != 1 && typeChoice != 2)
                 {
-                    ui.displayMessage("INVALID_CHOICE");
+                    ui.displayMessage(MessageId::INVALID_CHOICE);
                 }
             } while (typeChoice != 1 && typeChoice != 2);
             BankType bankType = (typeChoice == 1) ? BankType::SINGLE_BANK : BankType::MULTI_BANK;
@@ -101,13 +144,13 @@ namespace ATMSystem
                 std::cin >> langChoice;
                 if (langChoice != 1 && langChoice != 2)
                 {
-                    ui.displayMessage("INVALID_CHOICE");
+                    ui.displayMessage(MessageId::INVALID_CHOICE);
                 }
             } while (langChoice != 1 && langChoice != 2);
             LanguageSupport langSupport = (langChoice == 1) ? LanguageSupport::UNILINGUAL : LanguageSupport::BILINGUAL;
 
             // Primary bank selection
-            ui.displayMessage("AVAILABLE_BANKS");
+            ui.displayMessage(MessageId::AVAILABLE_BANKS);
             for (size_t j = 0; j < banks.size(); j++)
             {
                 std::cout << (j + 1) << ". " << banks[j]->getName() << "\n";
@@ -116,22 +159,18 @@ namespace ATMSystem
             int bankChoice;
             do
             {
-                std::string prompt = ui.getLocalizedMessage("SELECT_PRIMARY_BANK");
-                size_t pos = prompt.find("{}");
-                prompt.replace(pos, 2, std::to_string(banks.size()));
+                std::string prompt = ui.formatMessage(MessageId::SELECT_PRIMARY_BANK, banks.size());
                 std::cout << prompt;
                 std::cin >> bankChoice;
                 if (bankChoice < 1 || bankChoice > static_cast<int>(banks.size()))
                 {
-                    ui.displayMessage("INVALID_CHOICE");
+                    ui.displayMessage(MessageId::INVALID_CHOICE);
                 }
             } while (bankChoice < 1 || bankChoice > static_cast<int>(banks.size()));
             bankChoice--;
 
             // Initialize cash inventory
-            std::string message = ui.getLocalizedMessage("INIT_CASH");
-            size_t pos = message.find("{}");
-            message.replace(pos, 2, serial);
+            std::string message = ui.formatMessage(MessageId::INIT_CASH, serial);
             std::cout << message << "\n";
 
             std::map<int, int> inventory;
@@ -140,14 +179,12 @@ namespace ATMSystem
                 int count;
                 do
                 {
-                    std::string prompt = ui.getLocalizedMessage("BILL_PROMPT");
-                    pos = prompt.find("{}");
-                    prompt.replace(pos, 2, std::to_string(denom));
+                    std::string prompt = ui.formatMessage(MessageId::BILL_PROMPT, denom);
                     std::cout << prompt;
                     std::cin >> count;
                     if (count < 0)
                     {
-                        ui.displayMessage("ENTER_VALID_NUMBER");
+                        ui.displayMessage(MessageId::ENTER_VALID_NUMBER);
                     }
                 } while (count < 0);
                 inventory[denom] = count;
@@ -155,6 +192,7 @@ namespace ATMSystem
 
             auto atm = std::make_shared<ATM>(serial, bankType, langSupport, banks[bankChoice]);
             atm->addCash(inventory);
+            atm->setHistoryStore(historyStore);
 
             if (bankType == BankType::MULTI_BANK)
             {
@@ -169,9 +207,7 @@ namespace ATMSystem
 
             atms.push_back(atm);
 
-            std::string successMsg = ui.getLocalizedMessage("ATM_CREATED");
-            pos = successMsg.find("{}");
-            successMsg.replace(pos, 2, serial);
+            std::string successMsg = ui.formatMessage(MessageId::ATM_CREATED, serial);
             std::cout << successMsg << "\n";
         }
         std::cin.ignore();
@@ -184,9 +220,7 @@ namespace ATMSystem
 
         do
         {
-            std::string message = ui.getLocalizedMessage("ENTER_NUM_USERS");
-            size_t pos = message.find("{}");
-            message.replace(pos, 2, bank->getName());
+            std::string message = ui.formatMessage(MessageId::ENTER_NUM_USERS, bank->getName());
             std::cout << message;
 
             if (std::cin >> numUsers && numUsers > 0)
@@ -195,7 +229,7 @@ namespace ATMSystem
             }
             else
             {
-                ui.displayMessage("ENTER_VALID_NUMBER");
+                ui.displayMessage(MessageId::ENTER_VALID_NUMBER);
                 std::cin.clear();
                 std::cin.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
             }
@@ -205,9 +239,7 @@ namespace ATMSystem
 
         for (int i = 0; i < numUsers; i++)
         {
-            std::string prompt = ui.getLocalizedMessage("USER_NAME_PROMPT");
-            size_t pos = prompt.find("{}");
-            prompt.replace(pos, 2, std::to_string(i + 1));
+            std::string prompt = ui.formatMessage(MessageId::USER_NAME_PROMPT, i + 1);
             std::cout << prompt;
 
             std::string userName;
@@ -218,9 +250,7 @@ namespace ATMSystem
 
             do
             {
-                std::string message = ui.getLocalizedMessage("NUM_ACCOUNTS_PROMPT");
-                pos = message.find("{}");
-                message.replace(pos, 2, userName);
+                std::string message = ui.formatMessage(MessageId::NUM_ACCOUNTS_PROMPT, userName);
                 std::cout << message;
 
                 if (std::cin >> numAccounts && numAccounts > 0)
@@ -229,7 +259,7 @@ namespace ATMSystem
                 }
                 else
                 {
-                    ui.displayMessage("ENTER_VALID_NUMBER");
+                    ui.displayMessage(MessageId::ENTER_VALID_NUMBER);
                     std::cin.clear();
                     std::cin.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
                 }
@@ -239,23 +269,13 @@ namespace ATMSystem
 
             for (int j = 0; j < numAccounts; j++)
             {
-                std::string accountNum;
-                do
-                {
-                    accountNum = std::to_string(rand() % 1000000000000LL);
-                    while (accountNum.length() < 12)
-                    {
-                        accountNum = "0" + accountNum;
-                    }
-                } while (bank->getAccount(accountNum) != nullptr);
+                std::string accountNum = generateAccountNumber();
 
                 std::string pin;
                 bool validPin = false;
                 do
                 {
-                    std::string prompt = ui.getLocalizedMessage("ENTER_PIN_FOR_ACCOUNT");
-                    pos = prompt.find("{}");
-                    prompt.replace(pos, 2, accountNum);
+                    std::string prompt = ui.formatMessage(MessageId::ENTER_PIN_FOR_ACCOUNT, accountNum);
                     std::cout << prompt;
                     std::getline(std::cin, pin);
 
@@ -265,22 +285,18 @@ namespace ATMSystem
                     }
                     else
                     {
-                        ui.displayMessage("INVALID_PIN_FORMAT");
+                        ui.displayMessage(MessageId::INVALID_PIN_FORMAT);
                     }
                 } while (!validPin);
 
                 if (bank->createAccount(userName, accountNum, pin))
                 {
-                    std::string successMsg = ui.getLocalizedMessage("ACCOUNT_CREATED");
-                    pos = successMsg.find("{}");
-                    successMsg.replace(pos, 2, accountNum);
-                    pos = successMsg.find("{}");
-                    successMsg.replace(pos, 2, userName);
+                    std::string successMsg = ui.formatMessage(MessageId::ACCOUNT_CREATED, accountNum, userName);
                     std::cout << successMsg << "\n";
                 }
                 else
                 {
-                    ui.displayMessage("ACCOUNT_CREATION_FAILED");
+                    ui.displayMessage(MessageId::ACCOUNT_CREATION_FAILED);
                     j--;
                 }
             }
@@ -0,0 +1,405 @@
+#include "SystemProvisioner.hpp"
+#include <algorithm>
+#include <charconv>
+#include <cstring>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+namespace ATMSystem
+{
+    namespace
+    {
+        constexpr size_t MAX_FIELDS = 10;
+
+        // splits on spaces and tabs; stops after MAX_FIELDS
+        void splitFields(std::string_view line, std::vector<std::string_view> &fields)
+        {
+            fields.clear();
+            size_t pos = 0;
+            while (pos < line.size() && fields.size() <= MAX_FIELDS)
+            {
+                while (pos < line.size() && (line[pos] == ' ' || line[pos] == '\t'))
+                {
+                    pos++;
+                }
+                size_t start = pos;
+                while (pos < line.size() && line[pos] != ' ' && line[pos] != '\t')
+                {
+                    pos++;
+                }
+                if (pos > start)
+                {
+                    fields.push_back(line.substr(start, pos - start));
+                }
+            }
+        }
+
+        template <typename T>
+        bool parseNumber(std::string_view text, T &value)
+        {
+            auto result = std::from_chars(text.data(), text.data() + text.size(), value);
+            return result.ec == std::errc() && result.ptr == text.data() + text.size();
+        }
+    }
+
+    SystemProvisioner::SystemProvisioner(std::vector<std::shared_ptr<Bank>> &banks,
+                                         std::vector<std::shared_ptr<ATM>> &atms,
+                                         std::shared_ptr<AccountDirectory> accountDirectory,
+                                         std::shared_ptr<TransactionHistoryStore> historyStore,
+                                         NumberAllocator &accountNumbers)
+        : banks(banks), atms(atms), accountDirectory(std::move(accountDirectory)),
+          historyStore(std::move(historyStore)), accountNumbers(accountNumbers)
+    {
+    }
+
+    bool SystemProvisioner::load(const std::string &path)
+    {
+        int fd = ::open(path.c_str(), O_RDONLY);
+        if (fd < 0)
+        {
+            return false;
+        }
+
+        struct stat info;
+        if (::fstat(fd, &info) != 0)
+        {
+            ::close(fd);
+            return false;
+        }
+
+        size_t size = static_cast<size_t>(info.st_size);
+        const char *data = nullptr;
+        if (size > 0)
+        {
+            void *map = ::mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+            if (map == MAP_FAILED)
+            {
+                ::close(fd);
+                return false;
+            }
+            ::madvise(map, size, MADV_SEQUENTIAL);
+            data = static_cast<const char *>(map);
+        }
+        ::close(fd);
+
+        // on a single core the handoff only adds overhead, so build inline
+        size_t workers = WorkerPool::defaultThreadCount();
+        pool = std::make_unique<WorkerPool>(workers > 1 ? workers : 0);
+        bool ok = true;
+        size_t lineNumber = 0;
+        const char *cursor = data;
+        const char *end = data + size;
+        while (cursor < end)
+        {
+            const char *newline = static_cast<const char *>(std::memchr(cursor, '\n', end - cursor));
+            const char *lineEnd = newline ? newline : end;
+            std::string_view line(cursor, lineEnd - cursor);
+            if (!line.empty() && line.back() == '\r')
+            {
+                line.remove_suffix(1);
+            }
+            lineNumber++;
+            if (!parseLine(line))
+            {
+                errorLine = lineNumber;
+                ok = false;
+                break;
+            }
+            cursor = lineEnd + 1;
+        }
+
+        if (data)
+        {
+            ::munmap(const_cast<char *>(data), size);
+        }
+        if (ok)
+        {
+            for (auto &entry : entries)
+            {
+                flushAccounts(entry);
+            }
+        }
+
+        // banks must be complete before ATMs connect to them
+        pool.reset();
+        counts.accounts = createdAccounts.load();
+        counts.skippedAccounts = skippedAccounts.load();
+        if (!ok)
+        {
+            return false;
+        }
+        createATMs();
+        return true;
+    }
+
+    bool SystemProvisioner::parseLine(std::string_view line)
+    {
+        splitFields(line, fields);
+        if (fields.empty() || fields[0].front() == '#')
+        {
+            return true;
+        }
+
+        if (fields[0] == "account")
+        {
+            return addAccount(fields);
+        }
+        if (fields[0] == "accounts")
+        {
+            return addGeneratedAccounts(fields);
+        }
+        if (fields[0] == "bank")
+        {
+            return addBank(fields);
+        }
+        if (fields[0] == "atm")
+        {
+            return addATM(fields);
+        }
+        return false;
+    }
+
+    bool SystemProvisioner::addBank(const std::vector<std::string_view> &fields)
+    {
+        if (fields.size() < 2 || fields.size() > 3)
+        {
+            return false;
+        }
+
+        std::string name(fields[1]);
+        if (bankIndex.count(name))
+        {
+            return false;
+        }
+
+        size_t expected = 0;
+        if (fields.size() == 3 && !parseNumber(fields[2], expected))
+        {
+            return false;
+        }
+
+        auto bank = std::make_shared<Bank>(name, accountDirectory);
+        if (expected > 0)
+        {
+            bank->reserveAccounts(expected);
+            expectedAccounts += expected;
+            if (accountDirectory)
+            {
+                accountDirectory->reserve(expectedAccounts);
+            }
+        }
+
+        bankIndex.emplace(std::move(name), entries.size());
+        entries.push_back({bank, {}});
+        banks.push_back(bank);
+        counts.banks++;
+        return true;
+    }
+
+    bool SystemProvisioner::addAccount(const std::vector<std::string_view> &fields)
+    {
+        if (fields.size() < 5 || fields.size() > 6)
+        {
+            return false;
+        }
+
+        auto it = bankIndex.find(std::string(fields[1]));
+        if (it == bankIndex.end())
+        {
+            return false;
+        }
+
+        std::int64_t balance = 0;
+        if (fields.size() == 6 && !parseNumber(fields[5], balance))
+        {
+            return false;
+        }
+
+        BankEntry &entry = entries[it->second];
+        if (entry.pending.empty())
+        {
+            // the previous batch was handed off with its buffer
+            entry.pending.reserve(ACCOUNT_BATCH_SIZE);
+        }
+        entry.pending.push_back({std::string(fields[2]), std::string(fields[3]), std::string(fields[4]), Money(balance)});
+        if (entry.pending.size() == ACCOUNT_BATCH_SIZE)
+        {
+            flushAccounts(entry);
+        }
+        return true;
+    }
+
+    bool SystemProvisioner::addGeneratedAccounts(const std::vector<std::string_view> &fields)
+    {
+        if (fields.size() < 4 || fields.size() > 5)
+        {
+            return false;
+        }
+
+        auto it = bankIndex.find(std::string(fields[1]));
+        if (it == bankIndex.end())
+        {
+            return false;
+        }
+
+        size_t count;
+        if (!parseNumber(fields[2], count) || count == 0)
+        {
+            return false;
+        }
+
+        std::string pin(fields[3]);
+        if (pin.length() != 4 || !std::all_of(pin.begin(), pin.end(), ::isdigit))
+        {
+            return false;
+        }
+
+        std::int64_t balance = 0;
+        if (fields.size() == 5 && (!parseNumber(fields[4], balance) || balance < 0))
+        {
+            return false;
+        }
+
+        auto firstIndex = accountNumbers.allocateRange(count);
+        if (!firstIndex)
+        {
+            return false;
+        }
+
+        // each job owns a disjoint slice of the permutation's index space
+        BankEntry &entry = entries[it->second];
+        for (size_t offset = 0; offset < count; offset += ACCOUNT_BATCH_SIZE)
+        {
+            size_t batchCount = std::min(ACCOUNT_BATCH_SIZE, count - offset);
+            size_t firstOrdinal = entry.generated + offset + 1;
+            pool->submit([this, bank = entry.bank, index = *firstIndex + offset, batchCount, firstOrdinal, pin,
+                          balance]()
+                         { generateAccounts(bank, index, batchCount, firstOrdinal, pin, Money(balance)); });
+        }
+        entry.generated += count;
+        return true;
+    }
+
+    bool SystemProvisioner::addATM(const std::vector<std::string_view> &fields)
+    {
+        if (fields.size() != 5 + CASH_DENOMINATIONS.size())
+        {
+            return false;
+        }
+
+        ATMSpec spec;
+        spec.serial = std::string(fields[1]);
+        if (spec.serial.length() != ATM_SERIAL_LENGTH || !std::all_of(spec.serial.begin(), spec.serial.end(), ::isdigit))
+        {
+            return false;
+        }
+
+        if (fields[2] == "single")
+            spec.type = BankType::SINGLE_BANK;
+        else if (fields[2] == "multi")
+            spec.type = BankType::MULTI_BANK;
+        else
+            return false;
+
+        if (fields[3] == "uni")
+            spec.language = LanguageSupport::UNILINGUAL;
+        else if (fields[3] == "bi")
+            spec.language = LanguageSupport::BILINGUAL;
+        else
+            return false;
+
+        auto it = bankIndex.find(std::string(fields[4]));
+        if (it == bankIndex.end())
+        {
+            return false;
+        }
+        spec.primaryBank = it->second;
+
+        for (size_t slot = 0; slot < CASH_DENOMINATIONS.size(); slot++)
+        {
+            int count;
+            if (!parseNumber(fields[5 + slot], count) || count < 0)
+            {
+                return false;
+            }
+            spec.cash[CASH_DENOMINATIONS[slot]] = count;
+        }
+
+        for (const auto &other : atmSpecs)
+        {
+            if (other.serial == spec.serial)
+            {
+                return false;
+            }
+        }
+        atmSpecs.push_back(std::move(spec));
+        return true;
+    }
+
+    void SystemProvisioner::flushAccounts(BankEntry &entry)
+    {
+        if (entry.pending.empty())
+        {
+            return;
+        }
+        pool->submit([this, bank = entry.bank, batch = std::move(entry.pending)]()
+                     { createAccounts(*bank, batch, 0); });
+        entry.pending = {};
+    }
+
+    void SystemProvisioner::createAccounts(Bank &bank, const std::vector<AccountSpec> &batch, size_t alreadySkipped)
+    {
+        size_t created = bank.createAccounts(batch);
+        createdAccounts.fetch_add(created, std::memory_order_relaxed);
+        skippedAccounts.fetch_add(alreadySkipped + batch.size() - created, std::memory_order_relaxed);
+    }
+
+    void SystemProvisioner::generateAccounts(const std::shared_ptr<Bank> &bank, std::uint64_t firstIndex, size_t count,
+                                             size_t firstOrdinal, const std::string &pin, Money balance)
+    {
+        static const AccountKey adminKey = *parseAccountNumber(ADMIN_CARD);
+
+        std::vector<AccountSpec> batch;
+        batch.reserve(count);
+        std::string prefix = bank->getName() + "-";
+        size_t skipped = 0;
+        for (size_t i = 0; i < count; i++)
+        {
+            AccountKey key = accountNumbers.permute(firstIndex + i);
+            if (key == adminKey)
+            {
+                skipped++;
+                continue;
+            }
+            batch.push_back({prefix + std::to_string(firstOrdinal + i), formatAccountNumber(key), pin, balance});
+        }
+        createAccounts(*bank, batch, skipped);
+    }
+
+    void SystemProvisioner::createATMs()
+    {
+        for (const auto &spec : atmSpecs)
+        {
+            const auto &primary = entries[spec.primaryBank].bank;
+            auto atm = std::make_shared<ATM>(spec.serial, spec.type, spec.language, primary);
+            atm->addCash(spec.cash);
+            atm->setHistoryStore(historyStore);
+
+            if (spec.type == BankType::MULTI_BANK)
+            {
+                for (const auto &entry : entries)
+                {
+                    if (entry.bank != primary)
+                    {
+                        atm->addConnectedBank(entry.bank);
+                    }
+                }
+            }
+
+            atms.push_back(atm);
+            counts.atms++;
+        }
+    }
+}
@@ -1,104 +1,339 @@
 #include "SystemSnapshot.hpp"
-#include <sstream>
 #include <iostream>
+#include <algorithm>
+#include <charconv>
+#include <cstring>
+#include <queue>
 
 namespace ATMSystem
 {
+    namespace
+    {
+        template <typename T>
+        bool parseNumber(std::string_view text, T &value)
+        {
+            auto result = std::from_chars(text.data(), text.data() + text.size(), value);
+            return !text.empty() && result.ec == std::errc() && result.ptr == text.data() + text.size();
+        }
+
+        bool parseWon(std::string_view text, std::optional<Money> &amount)
+        {
+            std::int64_t won;
+            if (!parseNumber(text, won) || won < 0)
+            {
+                return false;
+            }
+            amount = Money(won);
+            return true;
+        }
+
+        struct RankedAccount
+        {
+            Money balance;
+            AccountKey key;
+            std::shared_ptr<Account> account;
+            const std::string *bankName;
+        };
+
+        // higher balance first; ties by account number so output is stable
+        bool ranksAbove(Money balance, AccountKey key, const RankedAccount &other)
+        {
+            return balance > other.balance || (balance == other.balance && key < other.key);
+        }
+    }
+
+    bool SnapshotFilter::matches(const Account &account) const
+    {
+        if (!accountPrefix.empty())
+        {
+            char digits[ACCOUNT_NUMBER_LENGTH];
+            writeAccountNumber(account.getKey(), digits);
+            if (std::memcmp(digits, accountPrefix.data(), accountPrefix.size()) != 0)
+            {
+                return false;
+            }
+        }
+        if (minBalance || maxBalance)
+        {
+            Money balance = account.getBalance();
+            if ((minBalance && balance < *minBalance) || (maxBalance && balance > *maxBalance))
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    bool SnapshotFilter::matches(const ATM &atm) const
+    {
+        if (!bank.empty() && atm.getPrimaryBank()->getName() != bank)
+        {
+            return false;
+        }
+        return !cashBelow || atm.getCassettes().getTotal() < *cashBelow;
+    }
+
+    bool SnapshotFilter::parse(std::string_view arguments, SnapshotFilter &filter)
+    {
+        size_t pos = 0;
+        while (pos < arguments.size())
+        {
+            if (arguments[pos] == ' ' || arguments[pos] == '\t')
+            {
+                pos++;
+                continue;
+            }
+            size_t end = arguments.find_first_of(" \t", pos);
+            std::string_view word = arguments.substr(pos, end == std::string_view::npos ? std::string_view::npos : end - pos);
+            pos = end == std::string_view::npos ? arguments.size() : end;
+
+            size_t equals = word.find('=');
+            if (equals == std::string_view::npos || equals + 1 == word.size())
+            {
+                return false;
+            }
+            std::string_view key = word.substr(0, equals);
+            std::string_view value = word.substr(equals + 1);
+
+            bool valid;
+            if (key == "bank")
+            {
+                filter.bank = std::string(value);
+                valid = true;
+            }
+            else if (key == "prefix")
+            {
+                filter.accountPrefix = std::string(value);
+                valid = value.size() <= ACCOUNT_NUMBER_LENGTH &&
+                        std::all_of(value.begin(), value.end(), [](char c)
+                                    { return c >= '0' && c <= '9'; });
+            }
+            else if (key == "min")
+            {
+                valid = parseWon(value, filter.minBalance);
+            }
+            else if (key == "max")
+            {
+                valid = parseWon(value, filter.maxBalance);
+            }
+            else if (key == "cash")
+            {
+                valid = parseWon(value, filter.cashBelow);
+            }
+            else if (key == "top")
+            {
+                valid = parseNumber(value, filter.top) && filter.top > 0;
+            }
+            else if (key == "page")
+            {
+                // page=0 lists everything without pausing
+                valid = parseNumber(value, filter.pageSize);
+            }
+            else
+            {
+                valid = false;
+            }
 
-    std::string SystemSnapshot::formatCashInventory(const std::map<int, int> &inventory) const
+            if (!valid)
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    void SystemSnapshot::appendCashInventory(std::string &out, const std::map<int, int> &inventory) const
     {
-        UI ui(false);
+        const MessageTemplate &format = ui.getTemplate(MessageId::CASH_INVENTORY_FORMAT);
+        std::string_view separator = ui.getLocalizedView(MessageId::CASH_INVENTORY_SEPARATOR);
 
-        std::stringstream ss;
-        ss << ui.getLocalizedMessage("CASH_INVENTORY_START");
+        out.append(ui.getLocalizedView(MessageId::CASH_INVENTORY_START));
         bool first = true;
         for (const auto &[denomination, count] : inventory)
         {
             if (!first)
-                ss << ui.getLocalizedMessage("CASH_INVENTORY_SEPARATOR");
-
-            std::string format = ui.getLocalizedMessage("CASH_INVENTORY_FORMAT");
-            size_t pos = format.find("{}");
-            format.replace(pos, 2, std::to_string(denomination));
-            pos = format.find("{}");
-            format.replace(pos, 2, std::to_string(count));
-            ss << format;
+                out.append(separator);
 
+            format.appendTo(out, denomination, count);
             first = false;
         }
-        ss << ui.getLocalizedMessage("CASH_INVENTORY_END");
-        return ss.str();
+        out.append(ui.getLocalizedView(MessageId::CASH_INVENTORY_END));
     }
 
-    std::string SystemSnapshot::formatATMInfo(const std::shared_ptr<ATM> &atm) const
+    void SystemSnapshot::appendATMInfo(std::string &out, const std::shared_ptr<ATM> &atm) const
     {
-        UI ui(false);
-        std::stringstream ss;
-        std::string format = ui.getLocalizedMessage("ATM_INFO_FORMAT");
+        ui.appendMessage(out, MessageId::ATM_INFO_FORMAT, atm->getSerialNumber(),
+                         [&](std::string &buffer)
+                         { appendCashInventory(buffer, atm->getCashInventory()); });
+    }
 
-        size_t pos = format.find("{}");
-        format.replace(pos, 2, atm->getSerialNumber());
-        pos = format.find("{}");
-        format.replace(pos, 2, formatCashInventory(atm->getCashInventory()));
+    void SystemSnapshot::appendAccountInfo(std::string &out, const std::shared_ptr<Account> &account,
+                                           const std::string &bankName) const
+    {
+        ui.appendMessage(out, MessageId::ACCOUNT_INFO_FORMAT, bankName, account->getAccountNumber(),
+                         account->getUserName(), account->getBalance().toWon());
+    }
 
-        ss << format;
-        return ss.str();
+    bool SystemSnapshot::continuePaging(size_t shown) const
+    {
+        std::cout << "\n"
+                  << ui.formatMessage(MessageId::SNAPSHOT_MORE, shown);
+        std::string input = ui.getInput();
+        return input != "q" && input != "Q";
     }
 
-    std::string SystemSnapshot::formatAccountInfo(const std::shared_ptr<Account> &account,
-                                                  const std::string &bankName) const
+    void SystemSnapshot::displayAccounts(const SnapshotFilter &filter) const
     {
-        UI ui(false);
-        std::stringstream ss;
-        std::string format = ui.getLocalizedMessage("ACCOUNT_INFO_FORMAT");
-
-        size_t pos = format.find("{}");
-        format.replace(pos, 2, bankName);
-        pos = format.find("{}");
-        format.replace(pos, 2, account->getAccountNumber());
-        pos = format.find("{}");
-        format.replace(pos, 2, account->getUserName());
-        pos = format.find("{}");
-        format.replace(pos, 2, std::to_string(account->getBalance()));
-
-        ss << format;
-        return ss.str();
+        // one buffer reused for every line
+        std::string line;
+        size_t shown = 0;
+        size_t onPage = 0;
+        for (const auto &bank : banks)
+        {
+            if (!filter.bank.empty() && bank->getName() != filter.bank)
+            {
+                continue;
+            }
+
+            const std::string bankName = bank->getName();
+            Bank::AccountCursor cursor;
+            // a full page stops the visit on the next match, so the prompt
+            // only appears when there is more to show, and no lock is held
+            // while it waits
+            while (!bank->visitAccounts(cursor, [&](const std::shared_ptr<Account> &account)
+                                        {
+                                            if (!filter.matches(*account))
+                                            {
+                                                return true;
+                                            }
+                                            if (filter.pageSize > 0 && onPage == filter.pageSize)
+                                            {
+                                                return false;
+                                            }
+                                            line.clear();
+                                            if (onPage > 0)
+                                            {
+                                                line.append(",\n");
+                                            }
+                                            appendAccountInfo(line, account, bankName);
+                                            std::cout << line;
+                                            shown++;
+                                            onPage++;
+                                            return true;
+                                        }))
+            {
+                if (!continuePaging(shown))
+                {
+                    return;
+                }
+                onPage = 0;
+            }
+        }
+    }
+
+    void SystemSnapshot::displayTopAccounts(const SnapshotFilter &filter) const
+    {
+        // min-heap of the best filter.top so far; only those are copied
+        auto worse = [](const RankedAccount &a, const RankedAccount &b)
+        {
+            return ranksAbove(a.balance, a.key, b);
+        };
+        std::priority_queue<RankedAccount, std::vector<RankedAccount>, decltype(worse)> best(worse);
+
+        std::vector<std::string> bankNames;
+        bankNames.reserve(banks.size());
+        for (const auto &bank : banks)
+        {
+            bankNames.push_back(bank->getName());
+        }
+
+        for (size_t i = 0; i < banks.size(); i++)
+        {
+            if (!filter.bank.empty() && bankNames[i] != filter.bank)
+            {
+                continue;
+            }
+            banks[i]->forEachAccount([&](const std::shared_ptr<Account> &account)
+                                     {
+                                         if (!filter.matches(*account))
+                                         {
+                                             return;
+                                         }
+                                         Money balance = account->getBalance();
+                                         AccountKey key = account->getKey();
+                                         if (best.size() < filter.top)
+                                         {
+                                             best.push({balance, key, account, &bankNames[i]});
+                                         }
+                                         else if (ranksAbove(balance, key, best.top()))
+                                         {
+                                             best.pop();
+                                             best.push({balance, key, account, &bankNames[i]});
+                                         }
+                                     });
+        }
+
+        std::vector<RankedAccount> ranked;
+        ranked.reserve(best.size());
+        while (!best.empty())
+        {
+            ranked.push_back(best.top());
+            best.pop();
+        }
+        std::reverse(ranked.begin(), ranked.end());
+
+        std::string line;
+        for (size_t shown = 0; shown < ranked.size(); shown++)
+        {
+            if (filter.pageSize > 0 && shown > 0 && shown % filter.pageSize == 0 && !continuePaging(shown))
+            {
+                return;
+            }
+            line.clear();
+            if (shown > 0 && (filter.pageSize == 0 || shown % filter.pageSize != 0))
+            {
+                line.append(",\n");
+            }
+            appendAccountInfo(line, ranked[shown].account, *ranked[shown].bankName);
+            std::cout << line;
+        }
     }
 
-    void SystemSnapshot::displaySnapshot() const
+    void SystemSnapshot::displaySnapshot(const SnapshotFilter &filter) const
     {
-        UI ui(false);
+        std::string line;
 
         // Display ATM info
-        std::cout << "\n=== " << ui.getLocalizedMessage("ATM_SNAPSHOT") << " ===\n";
+        std::cout << "\n=== " << ui.getLocalizedView(MessageId::ATM_SNAPSHOT) << " ===\n";
         bool firstAtm = true;
         for (const auto &atm : atms)
         {
+            if (!filter.matches(*atm))
+            {
+                continue;
+            }
+            line.clear();
             if (!firstAtm)
             {
-                std::cout << ",\n";
+                line.append(",\n");
             }
-            std::cout << formatATMInfo(atm);
+            appendATMInfo(line, atm);
+            std::cout << line;
             firstAtm = false;
         }
 
         // Display Account info
-        std::cout << "\n\n=== " << ui.getLocalizedMessage("ACCOUNT_SNAPSHOT") << " ===\n";
-        bool firstAccount = true;
-        for (const auto &bank : banks)
+        std::cout << "\n\n=== " << ui.getLocalizedView(MessageId::ACCOUNT_SNAPSHOT) << " ===\n";
+        if (filter.top > 0)
         {
-            for (const auto &account : bank->getAllAccounts())
-            {
-                if (!firstAccount)
-                {
-                    std::cout << ",\n";
-                }
-                std::cout << formatAccountInfo(account, bank->getName());
-                firstAccount = false;
-            }
+            displayTopAccounts(filter);
+        }
+        else
+        {
+            displayAccounts(filter);
         }
         std::cout << "\n"
                   << std::endl;
     }
 
-}
\ No newline at end of file
+}
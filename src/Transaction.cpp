@@ -2,15 +2,48 @@
 #include "UI.hpp"
 #include <sstream>
 #include <iomanip>
+#include <ctime>
 
 namespace ATMSystem
 {
-  Transaction::Transaction(const std::string &id, const std::string &card,
-                           TransactionType transType, double amt,
-                           double transactionFee, const std::string &transDetails)
-      : transactionId(id), cardNumber(card), type(transType),
-        amount(amt), fee(transactionFee), details(transDetails),
-        timestamp(std::chrono::system_clock::now()) {}
+  Transaction::Transaction(TransactionId id, AccountKey card,
+                           TransactionType transType, Money amt,
+                           Money transactionFee, TransactionChannel transChannel,
+                           AccountKey counterparty, std::uint32_t counterpartyBankId)
+      : transactionId(id), cardNumber(card), counterpartyAccount(counterparty),
+        timestamp(std::chrono::system_clock::now()),
+        amount(amt), fee(transactionFee), counterpartyBank(counterpartyBankId),
+        type(transType), channel(transChannel), reserved(0) {}
+
+  std::string Transaction::getDetails(const UI &ui) const
+  {
+    std::string details;
+    switch (type)
+    {
+    case TransactionType::DEPOSIT:
+      details = ui.getLocalizedMessage(channel == TransactionChannel::CHECK ? MessageId::CHECK_DEPOSIT_TYPE
+                                                                            : MessageId::CASH_DEPOSIT_TYPE);
+      break;
+    case TransactionType::WITHDRAWAL:
+      details = ui.getLocalizedMessage(MessageId::WITHDRAWAL_TYPE);
+      break;
+    case TransactionType::TRANSFER_CASH:
+      details.append(ui.getLocalizedView(MessageId::TO));
+      details.push_back(' ');
+      details.append(formatAccountNumber(counterpartyAccount));
+      break;
+    case TransactionType::TRANSFER_ACCOUNT:
+      details.append(ui.getLocalizedView(MessageId::FROM));
+      details.push_back(' ');
+      details.append(formatAccountNumber(cardNumber));
+      details.push_back(' ');
+      details.append(ui.getLocalizedView(MessageId::TO));
+      details.push_back(' ');
+      details.append(formatAccountNumber(counterpartyAccount));
+      break;
+    }
+    return details;
+  }
 
   std::string Transaction::getTypeString() const
   {
@@ -18,15 +51,15 @@ namespace ATMSystem
     switch (type)
     {
     case TransactionType::DEPOSIT:
-      return ui.getLocalizedMessage("TRANSACTION_TYPE_DEPOSIT");
+      return ui.getLocalizedMessage(MessageId::TRANSACTION_TYPE_DEPOSIT);
     case TransactionType::WITHDRAWAL:
-      return ui.getLocalizedMessage("TRANSACTION_TYPE_WITHDRAWAL");
+      return ui.getLocalizedMessage(MessageId::TRANSACTION_TYPE_WITHDRAWAL);
     case TransactionType::TRANSFER_CASH:
-      return ui.getLocalizedMessage("TRANSACTION_TYPE_CASH_TRANSFER");
+      return ui.getLocalizedMessage(MessageId::TRANSACTION_TYPE_CASH_TRANSFER);
     case TransactionType::TRANSFER_ACCOUNT:
-      return ui.getLocalizedMessage("TRANSACTION_TYPE_ACCOUNT_TRANSFER");
+      return ui.getLocalizedMessage(MessageId::TRANSACTION_TYPE_ACCOUNT_TRANSFER);
     default:
-      return ui.getLocalizedMessage("TRANSACTION_TYPE_UNKNOWN");
+      return ui.getLocalizedMessage(MessageId::TRANSACTION_TYPE_UNKNOWN);
     }
   }
 
@@ -35,7 +68,7 @@ namespace ATMSystem
     UI ui(false);
     auto time = std::chrono::system_clock::to_time_t(timestamp);
     std::stringstream ss;
-    ss << std::put_time(std::localtime(&time), ui.getLocalizedMessage("TIMESTAMP_FORMAT").c_str());
+    ss << std::put_time(std::localtime(&time), ui.getLocalizedMessage(MessageId::TIMESTAMP_FORMAT).c_str());
     return ss.str();
   }
-}
\ No newline at end of file
+}
@@ -0,0 +1,113 @@
+#include "TransactionAggregates.hpp"
+
+namespace ATMSystem
+{
+    std::int64_t TransactionAggregates::hourOf(std::chrono::system_clock::time_point time)
+    {
+        return std::chrono::duration_cast<std::chrono::hours>(time.time_since_epoch()).count() / BUCKET_SPAN.count();
+    }
+
+    void TransactionAggregates::Counters::add(const Transaction &transaction)
+    {
+        size_t type = static_cast<size_t>(transaction.getType());
+        std::int64_t amountWon = transaction.getAmount().toWon();
+        count[type].fetch_add(1, std::memory_order_relaxed);
+        amount[type].fetch_add(amountWon, std::memory_order_relaxed);
+        fee[type].fetch_add(transaction.getFee().toWon(), std::memory_order_relaxed);
+
+        if (transaction.getType() == TransactionType::WITHDRAWAL)
+        {
+            cashOut.fetch_add(amountWon, std::memory_order_relaxed);
+        }
+        else if (transaction.getChannel() == TransactionChannel::CASH)
+        {
+            cashIn.fetch_add(amountWon, std::memory_order_relaxed);
+        }
+    }
+
+    void TransactionAggregates::Counters::reset()
+    {
+        for (size_t type = 0; type < TYPE_COUNT; type++)
+        {
+            count[type].store(0, std::memory_order_relaxed);
+            amount[type].store(0, std::memory_order_relaxed);
+            fee[type].store(0, std::memory_order_relaxed);
+        }
+        cashIn.store(0, std::memory_order_relaxed);
+        cashOut.store(0, std::memory_order_relaxed);
+    }
+
+    void TransactionAggregates::Counters::addTo(AggregateSnapshot &snapshot) const
+    {
+        for (size_t type = 0; type < TYPE_COUNT; type++)
+        {
+            snapshot.byType[type].count += count[type].load(std::memory_order_relaxed);
+            snapshot.byType[type].amount += Money(amount[type].load(std::memory_order_relaxed));
+            snapshot.byType[type].fee += Money(fee[type].load(std::memory_order_relaxed));
+        }
+        snapshot.cashIn += Money(cashIn.load(std::memory_order_relaxed));
+        snapshot.cashOut += Money(cashOut.load(std::memory_order_relaxed));
+    }
+
+    void TransactionAggregates::record(const Transaction &transaction)
+    {
+        totals.add(transaction);
+
+        std::int64_t hour = hourOf(transaction.getTimestamp());
+        Bucket &bucket = buckets[static_cast<size_t>(hour) % BUCKET_COUNT];
+        std::int64_t held = bucket.hour.load(std::memory_order_acquire);
+        if (held != hour)
+        {
+            if (held > hour)
+            {
+                return; // older than the window; counted in totals only
+            }
+            std::lock_guard<std::mutex> lock(rolloverMutex);
+            if (bucket.hour.load(std::memory_order_relaxed) < hour)
+            {
+                bucket.hour.store(-1, std::memory_order_relaxed);
+                bucket.counters.reset();
+                bucket.hour.store(hour, std::memory_order_release);
+            }
+        }
+        bucket.counters.add(transaction);
+    }
+
+    AggregateSnapshot TransactionAggregates::getTotals() const
+    {
+        AggregateSnapshot snapshot;
+        totals.addTo(snapshot);
+        return snapshot;
+    }
+
+    AggregateSnapshot TransactionAggregates::getRecent(std::chrono::hours window) const
+    {
+        AggregateSnapshot snapshot;
+        std::int64_t now = hourOf(std::chrono::system_clock::now());
+        std::int64_t oldest = now - window.count() / BUCKET_SPAN.count() + 1;
+        for (const auto &bucket : buckets)
+        {
+            // skip buckets outside the window or rolling over while read
+            std::int64_t hour = bucket.hour.load(std::memory_order_acquire);
+            if (hour < oldest || hour > now)
+            {
+                continue;
+            }
+            AggregateSnapshot part;
+            bucket.counters.addTo(part);
+            if (bucket.hour.load(std::memory_order_acquire) != hour)
+            {
+                continue;
+            }
+            for (size_t type = 0; type < TYPE_COUNT; type++)
+            {
+                snapshot.byType[type].count += part.byType[type].count;
+                snapshot.byType[type].amount += part.byType[type].amount;
+                snapshot.byType[type].fee += part.byType[type].fee;
+            }
+            snapshot.cashIn += part.cashIn;
+            snapshot.cashOut += part.cashOut;
+        }
+        return snapshot;
+    }
+}
@@ -0,0 +1,300 @@
+#include "TransactionExporter.hpp"
+#include <charconv>
+#include <cstring>
+#include <ctime>
+#include <fcntl.h>
+#include <unistd.h>
+
+namespace ATMSystem
+{
+    namespace
+    {
+        constexpr std::string_view TYPE_CODES[] = {"DEPOSIT", "WITHDRAWAL", "TRANSFER_CASH", "TRANSFER_ACCOUNT"};
+        constexpr std::string_view CHANNEL_CODES[] = {"CASH", "CHECK", "ACCOUNT"};
+
+        std::string_view typeCode(TransactionType type)
+        {
+            return TYPE_CODES[static_cast<size_t>(type)];
+        }
+
+        std::string_view channelCode(TransactionChannel channel)
+        {
+            return CHANNEL_CODES[static_cast<size_t>(channel)];
+        }
+
+        template <typename T>
+        void appendNumber(std::string &out, T value)
+        {
+            char digits[24];
+            auto result = std::to_chars(digits, digits + sizeof(digits), value);
+            out.append(digits, result.ptr);
+        }
+
+        void appendAccount(std::string &out, AccountKey key)
+        {
+            char digits[ACCOUNT_NUMBER_LENGTH];
+            writeAccountNumber(key, digits);
+            out.append(digits, ACCOUNT_NUMBER_LENGTH);
+        }
+
+        void writeDigits(char *out, int value, int width)
+        {
+            for (int i = width - 1; i >= 0; i--)
+            {
+                out[i] = static_cast<char>('0' + value % 10);
+                value /= 10;
+            }
+        }
+    }
+
+    TransactionExporter::TransactionExporter(ExportOptions exportOptions)
+        : options(std::move(exportOptions))
+    {
+    }
+
+    TransactionExporter::~TransactionExporter()
+    {
+        if (fd >= 0)
+        {
+            finish();
+        }
+    }
+
+    std::optional<std::chrono::system_clock::time_point> TransactionExporter::parseDate(std::string_view text, bool endOfDay)
+    {
+        int year, month, day;
+        if (text.size() != 10 || text[4] != '-' || text[7] != '-' ||
+            std::from_chars(text.data(), text.data() + 4, year).ptr != text.data() + 4 ||
+            std::from_chars(text.data() + 5, text.data() + 7, month).ptr != text.data() + 7 ||
+            std::from_chars(text.data() + 8, text.data() + 10, day).ptr != text.data() + 10 ||
+            month < 1 || month > 12 || day < 1 || day > 31)
+        {
+            return std::nullopt;
+        }
+
+        std::tm local{};
+        local.tm_year = year - 1900;
+        local.tm_mon = month - 1;
+        local.tm_mday = endOfDay ? day + 1 : day; // mktime normalises overflow
+        local.tm_isdst = -1;
+        std::time_t time = std::mktime(&local);
+        if (time == -1)
+        {
+            return std::nullopt;
+        }
+        return std::chrono::system_clock::from_time_t(time);
+    }
+
+    bool TransactionExporter::open()
+    {
+        fd = ::open(options.path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+        if (fd < 0)
+        {
+            return false;
+        }
+        buffer.reserve(BUFFER_SIZE);
+
+        switch (options.format)
+        {
+        case ExportFormat::CSV:
+            buffer.append("transaction_id,raw_transaction_id,card_number,type,channel,amount,fee,timestamp,counterparty_account,counterparty_bank\n");
+            break;
+        case ExportFormat::JSON_LINES:
+            break;
+        case ExportFormat::BINARY:
+        {
+            std::uint32_t header[2] = {1, static_cast<std::uint32_t>(sizeof(Transaction))};
+            buffer.append(BINARY_MAGIC, sizeof(BINARY_MAGIC));
+            buffer.append(reinterpret_cast<const char *>(header), sizeof(header));
+            break;
+        }
+        }
+        return true;
+    }
+
+    bool TransactionExporter::flush()
+    {
+        const char *data = buffer.data();
+        size_t remaining = buffer.size();
+        while (remaining > 0 && !failed)
+        {
+            ssize_t written = ::write(fd, data, remaining);
+            if (written < 0)
+            {
+                failed = true;
+                break;
+            }
+            data += written;
+            remaining -= static_cast<size_t>(written);
+        }
+        buffer.clear();
+        return !failed;
+    }
+
+    void TransactionExporter::appendTimestamp(const Transaction &transaction)
+    {
+        std::int64_t second = std::chrono::duration_cast<std::chrono::seconds>(
+                                  transaction.getTimestamp().time_since_epoch())
+                                  .count();
+        if (second != cachedSecond)
+        {
+            std::time_t time = static_cast<std::time_t>(second);
+            std::tm utc{};
+            gmtime_r(&time, &utc);
+            // YYYY-MM-DDTHH:MM:SSZ
+            writeDigits(cachedTimestamp, utc.tm_year + 1900, 4);
+            cachedTimestamp[4] = '-';
+            writeDigits(cachedTimestamp + 5, utc.tm_mon + 1, 2);
+            cachedTimestamp[7] = '-';
+            writeDigits(cachedTimestamp + 8, utc.tm_mday, 2);
+            cachedTimestamp[10] = 'T';
+            writeDigits(cachedTimestamp + 11, utc.tm_hour, 2);
+            cachedTimestamp[13] = ':';
+            writeDigits(cachedTimestamp + 14, utc.tm_min, 2);
+            cachedTimestamp[16] = ':';
+            writeDigits(cachedTimestamp + 17, utc.tm_sec, 2);
+            cachedSecond = second;
+        }
+        buffer.append(cachedTimestamp, sizeof(cachedTimestamp));
+        buffer.push_back('Z');
+    }
+
+    void TransactionExporter::appendId(const Transaction &transaction)
+    {
+        TransactionId id = transaction.getTransactionId();
+        std::int64_t second = TransactionIdGenerator::secondsOf(id);
+        if (second != cachedIdSecond)
+        {
+            cachedIdPrefix.clear();
+            appendTransactionId(cachedIdPrefix, TransactionIdGenerator::makeId(second, 0));
+            cachedIdPrefix.resize(cachedIdPrefix.size() - 6);
+            cachedIdSecond = second;
+        }
+        buffer.append(cachedIdPrefix);
+        // same rule as appendTransactionId: six digits, wider when needed
+        std::uint64_t sequence = TransactionIdGenerator::sequenceOf(id);
+        if (sequence < 1000000)
+        {
+            char digits[6];
+            writeDigits(digits, static_cast<int>(sequence), 6);
+            buffer.append(digits, sizeof(digits));
+        }
+        else
+        {
+            appendNumber(buffer, sequence);
+        }
+    }
+
+    void TransactionExporter::appendCsv(const Transaction &transaction)
+    {
+        appendId(transaction);
+        buffer.push_back(',');
+        appendNumber(buffer, transaction.getTransactionId());
+        buffer.push_back(',');
+        appendAccount(buffer, transaction.getCardNumber());
+        buffer.push_back(',');
+        buffer.append(typeCode(transaction.getType()));
+        buffer.push_back(',');
+        buffer.append(channelCode(transaction.getChannel()));
+        buffer.push_back(',');
+        appendNumber(buffer, transaction.getAmount().toWon());
+        buffer.push_back(',');
+        appendNumber(buffer, transaction.getFee().toWon());
+        buffer.push_back(',');
+        appendTimestamp(transaction);
+        buffer.push_back(',');
+        if (transaction.getCounterpartyAccount() != NO_ACCOUNT_KEY)
+        {
+            appendAccount(buffer, transaction.getCounterpartyAccount());
+            buffer.push_back(',');
+            appendNumber(buffer, transaction.getCounterpartyBank());
+        }
+        else
+        {
+            buffer.push_back(',');
+        }
+        buffer.push_back('\n');
+    }
+
+    void TransactionExporter::appendJson(const Transaction &transaction)
+    {
+        buffer.append("{\"transaction_id\":\"");
+        appendId(transaction);
+        // a string, since JSON readers often hold numbers as doubles
+        buffer.append("\",\"raw_transaction_id\":\"");
+        appendNumber(buffer, transaction.getTransactionId());
+        buffer.append("\",\"card_number\":\"");
+        appendAccount(buffer, transaction.getCardNumber());
+        buffer.append("\",\"type\":\"");
+        buffer.append(typeCode(transaction.getType()));
+        buffer.append("\",\"channel\":\"");
+        buffer.append(channelCode(transaction.getChannel()));
+        buffer.append("\",\"amount\":");
+        appendNumber(buffer, transaction.getAmount().toWon());
+        buffer.append(",\"fee\":");
+        appendNumber(buffer, transaction.getFee().toWon());
+        buffer.append(",\"timestamp\":\"");
+        appendTimestamp(transaction);
+        buffer.append("\",\"counterparty_account\":");
+        if (transaction.getCounterpartyAccount() != NO_ACCOUNT_KEY)
+        {
+            buffer.push_back('"');
+            appendAccount(buffer, transaction.getCounterpartyAccount());
+            buffer.append("\",\"counterparty_bank\":");
+            appendNumber(buffer, transaction.getCounterpartyBank());
+        }
+        else
+        {
+            buffer.append("null,\"counterparty_bank\":null");
+        }
+        buffer.append("}\n");
+    }
+
+    bool TransactionExporter::write(const Transaction &transaction)
+    {
+        if (fd < 0 || failed)
+        {
+            return false;
+        }
+        if (!inRange(transaction))
+        {
+            return true;
+        }
+
+        switch (options.format)
+        {
+        case ExportFormat::CSV:
+            appendCsv(transaction);
+            break;
+        case ExportFormat::JSON_LINES:
+            appendJson(transaction);
+            break;
+        case ExportFormat::BINARY:
+            buffer.append(reinterpret_cast<const char *>(&transaction), sizeof(Transaction));
+            break;
+        }
+        rowCount++;
+
+        // leave room for one more row before the buffer would grow
+        if (buffer.size() > BUFFER_SIZE - 512)
+        {
+            return flush();
+        }
+        return true;
+    }
+
+    bool TransactionExporter::finish()
+    {
+        if (fd < 0)
+        {
+            return false;
+        }
+        flush();
+        if (::close(fd) != 0)
+        {
+            failed = true;
+        }
+        fd = -1;
+        return !failed;
+    }
+}
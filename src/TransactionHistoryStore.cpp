@@ -0,0 +1,222 @@
+#include "TransactionHistoryStore.hpp"
+#include <algorithm>
+#include <tuple>
+
+namespace ATMSystem
+{
+    std::int64_t TransactionHistoryStore::bucketOf(std::int64_t ticks)
+    {
+        auto span = std::chrono::duration_cast<std::chrono::system_clock::duration>(BUCKET_SPAN).count();
+        return ticks >= 0 ? ticks / span : -((-(ticks + 1)) / span) - 1;
+    }
+
+    std::uint32_t TransactionHistoryStore::journalFor(const std::string &directory, const std::string &serial)
+    {
+        auto [it, added] = journalIndex.try_emplace(directory + "/" + serial, static_cast<std::uint32_t>(journals.size()));
+        if (added)
+        {
+            journals.emplace_back(directory, serial);
+        }
+        return it->second;
+    }
+
+    bool TransactionHistoryStore::add(const Transaction &transaction, const TransactionJournal &journal,
+                                      JournalPosition position)
+    {
+        std::unique_lock<std::shared_mutex> lock(mutex);
+        return addLocked(transaction, journalFor(journal.getDirectory(), journal.getSerial()), position);
+    }
+
+    bool TransactionHistoryStore::before(std::uint32_t a, std::uint32_t b) const
+    {
+        // equal timestamps keep arrival order
+        return entries[a].ticks < entries[b].ticks || (entries[a].ticks == entries[b].ticks && a < b);
+    }
+
+    size_t TransactionHistoryStore::insertSorted(Postings &postings, std::uint32_t position) const
+    {
+        // records arrive nearly in order, so the walk back is usually empty
+        size_t index = postings.size();
+        while (index > 0 && before(position, postings[index - 1]))
+        {
+            index--;
+        }
+        postings.insert(postings.begin() + index, position);
+        return index;
+    }
+
+    bool TransactionHistoryStore::addLocked(const Transaction &transaction, std::uint32_t journal,
+                                            JournalPosition position)
+    {
+        if (entries.size() >= MAX_RECORDS)
+        {
+            return false;
+        }
+
+        auto index = static_cast<std::uint32_t>(entries.size());
+        std::int64_t ticks = transaction.getTimestamp().time_since_epoch().count();
+        entries.push_back({ticks, journal, position.segment, static_cast<std::uint32_t>(position.record)});
+
+        insertSorted(byCard[transaction.getCardNumber()], index);
+        insertSorted(byCardAndType[cardTypeKey(transaction.getCardNumber(), transaction.getType())], index);
+        insertSorted(byType[static_cast<size_t>(transaction.getType())], index);
+        auto at = static_cast<std::uint32_t>(insertSorted(everything, index));
+
+        // buckets after the record's own shift by one; its own bucket keeps
+        // its first posting unless the record starts a new bucket
+        std::int64_t bucket = bucketOf(ticks);
+        size_t b = buckets.size();
+        while (b > 0 && buckets[b - 1].start > bucket)
+        {
+            buckets[b - 1].first++;
+            b--;
+        }
+        if (b == 0 || buckets[b - 1].start != bucket)
+        {
+            buckets.insert(buckets.begin() + b, Bucket{bucket, at});
+        }
+        return true;
+    }
+
+    void TransactionHistoryStore::loadJournals(const std::string &directory)
+    {
+        struct Loaded
+        {
+            Transaction transaction;
+            std::uint32_t journal;
+            JournalPosition position;
+        };
+
+        std::unique_lock<std::shared_mutex> lock(mutex);
+
+        // journals are each in order; sort the union once so indexing appends
+        std::vector<Loaded> loaded;
+        for (const auto &serial : TransactionJournal::listSerials(directory))
+        {
+            std::uint32_t journal = journalFor(directory, serial);
+            TransactionJournal::scanPositions(directory, serial, JournalPosition{},
+                                              [&](const Transaction &transaction, JournalPosition position)
+                                              { loaded.push_back({transaction, journal, position}); });
+        }
+        std::sort(loaded.begin(), loaded.end(), [](const Loaded &a, const Loaded &b)
+                  {
+                      return std::make_tuple(a.transaction.getTimestamp(), a.transaction.getTransactionId()) <
+                             std::make_tuple(b.transaction.getTimestamp(), b.transaction.getTransactionId());
+                  });
+
+        entries.reserve(entries.size() + loaded.size());
+        everything.reserve(everything.size() + loaded.size());
+        for (const auto &record : loaded)
+        {
+            if (!addLocked(record.transaction, record.journal, record.position))
+            {
+                break;
+            }
+        }
+    }
+
+    size_t TransactionHistoryStore::size() const
+    {
+        std::shared_lock<std::shared_mutex> lock(mutex);
+        return entries.size();
+    }
+
+    std::uint32_t TransactionHistoryStore::lowerBound(std::int64_t ticks) const
+    {
+        // find the time bucket first, then the posting inside it
+        std::int64_t bucket = bucketOf(ticks);
+        auto it = std::upper_bound(buckets.begin(), buckets.end(), bucket,
+                                   [](std::int64_t value, const Bucket &entry)
+                                   { return value < entry.start; });
+        std::uint32_t begin = it == buckets.begin() ? 0 : std::prev(it)->first;
+        std::uint32_t end = it == buckets.end() ? static_cast<std::uint32_t>(everything.size()) : it->first;
+        auto first = std::partition_point(everything.begin() + begin, everything.begin() + end,
+                                          [&](std::uint32_t position)
+                                          { return entries[position].ticks < ticks; });
+        return static_cast<std::uint32_t>(first - everything.begin());
+    }
+
+    Transaction TransactionHistoryStore::readRecord(std::uint32_t position) const
+    {
+        const Entry &entry = entries[position];
+        std::uint64_t key = static_cast<std::uint64_t>(entry.journal) << 32 | entry.segment;
+
+        std::lock_guard<std::mutex> lock(segmentMutex);
+        auto it = std::find_if(mappedSegments.begin(), mappedSegments.end(),
+                               [key](const MappedSegment &segment)
+                               { return segment.key == key; });
+        if (it == mappedSegments.end())
+        {
+            const auto &[directory, serial] = journals[entry.journal];
+            auto map = std::make_unique<TransactionJournal::SegmentMap>(directory, serial, entry.segment);
+            if (!map->isOpen())
+            {
+                return Transaction{};
+            }
+            if (mappedSegments.size() < MAX_MAPPED_SEGMENTS)
+            {
+                mappedSegments.push_back({key, std::move(map)});
+                it = std::prev(mappedSegments.end());
+            }
+            else
+            {
+                it = mappedSegments.begin() + nextEviction;
+                *it = {key, std::move(map)};
+                nextEviction = (nextEviction + 1) % MAX_MAPPED_SEGMENTS;
+            }
+        }
+
+        const auto &segment = *it->map;
+        return entry.record < segment.getCount() ? segment[entry.record] : Transaction{};
+    }
+
+    TransactionHistoryStore::View TransactionHistoryStore::query(const HistoryQuery &query) const
+    {
+        View view;
+        view.lock = std::shared_lock<std::shared_mutex>(mutex);
+        view.store = this;
+
+        // the narrowest posting list
+        const Postings *postings = &everything;
+        static const Postings NO_POSTINGS;
+        if (query.card && query.type)
+        {
+            auto it = byCardAndType.find(cardTypeKey(*query.card, *query.type));
+            postings = it != byCardAndType.end() ? &it->second : &NO_POSTINGS;
+        }
+        else if (query.card)
+        {
+            auto it = byCard.find(*query.card);
+            postings = it != byCard.end() ? &it->second : &NO_POSTINGS;
+        }
+        else if (query.type)
+        {
+            postings = &byType[static_cast<size_t>(*query.type)];
+        }
+
+        std::int64_t from = query.from.time_since_epoch().count();
+        std::int64_t to = query.to.time_since_epoch().count();
+        auto earlierThan = [&](std::int64_t ticks)
+        {
+            return [&, ticks](std::uint32_t position)
+            { return entries[position].ticks < ticks; };
+        };
+
+        Postings::const_iterator first;
+        if (postings == &everything && query.from != std::chrono::system_clock::time_point::min())
+        {
+            first = everything.begin() + lowerBound(from);
+        }
+        else
+        {
+            first = std::partition_point(postings->begin(), postings->end(), earlierThan(from));
+        }
+        auto last = query.to == std::chrono::system_clock::time_point::max()
+                        ? postings->end()
+                        : std::partition_point(first, postings->end(), earlierThan(to));
+
+        view.first = postings->data() + (first - postings->begin());
+        view.last = postings->data() + (last - postings->begin());
+        return view;
+    }
+}
@@ -0,0 +1,93 @@
+#include "TransactionId.hpp"
+#include <chrono>
+#include <ctime>
+#include <algorithm>
+
+namespace ATMSystem
+{
+    // sequence 0 is never issued
+    std::atomic<std::uint64_t> TransactionIdGenerator::nextBlock{1};
+
+    namespace
+    {
+        struct IdBlock
+        {
+            std::uint64_t next = 0;
+            std::uint64_t end = 0;
+        };
+
+        thread_local IdBlock localBlock;
+
+        void appendDigits(std::string &out, std::uint64_t value, int width)
+        {
+            char digits[20];
+            for (int i = width - 1; i >= 0; i--)
+            {
+                digits[i] = static_cast<char>('0' + value % 10);
+                value /= 10;
+            }
+            out.append(digits, width);
+        }
+
+        int digitCount(std::uint64_t value)
+        {
+            int count = 1;
+            while (value >= 10)
+            {
+                value /= 10;
+                count++;
+            }
+            return count;
+        }
+    }
+
+    TransactionId TransactionIdGenerator::next()
+    {
+        if (localBlock.next == localBlock.end)
+        {
+            localBlock.next = nextBlock.fetch_add(BLOCK_SIZE, std::memory_order_relaxed);
+            localBlock.end = localBlock.next + BLOCK_SIZE;
+        }
+        auto seconds = std::chrono::duration_cast<std::chrono::seconds>(
+                           std::chrono::system_clock::now().time_since_epoch())
+                           .count();
+        return makeId(seconds, localBlock.next++);
+    }
+
+    void TransactionIdGenerator::advancePast(TransactionId id)
+    {
+        std::uint64_t wanted = sequenceOf(id) + 1;
+        std::uint64_t current = nextBlock.load(std::memory_order_relaxed);
+        while (current < wanted &&
+               !nextBlock.compare_exchange_weak(current, wanted, std::memory_order_relaxed))
+        {
+        }
+    }
+
+    void appendTransactionId(std::string &out, TransactionId id)
+    {
+        std::time_t time = static_cast<std::time_t>(TransactionIdGenerator::secondsOf(id));
+        std::tm local{};
+        localtime_r(&time, &local);
+
+        appendDigits(out, local.tm_year + 1900, 4);
+        appendDigits(out, local.tm_mon + 1, 2);
+        appendDigits(out, local.tm_mday, 2);
+        out.push_back('-');
+        appendDigits(out, local.tm_hour, 2);
+        appendDigits(out, local.tm_min, 2);
+        appendDigits(out, local.tm_sec, 2);
+        out.push_back('-');
+        // at least six digits; larger sequences widen rather than wrap
+        std::uint64_t sequence = TransactionIdGenerator::sequenceOf(id);
+        appendDigits(out, sequence, std::max(6, digitCount(sequence)));
+    }
+
+    std::string formatTransactionId(TransactionId id)
+    {
+        std::string out;
+        out.reserve(26);
+        appendTransactionId(out, id);
+        return out;
+    }
+}
@@ -0,0 +1,484 @@
+#include "TransactionJournal.hpp"
+#include <string_view>
+#include <algorithm>
+#include <cstring>
+#include <cstdio>
+#include <fcntl.h>
+#include <unistd.h>
+#include <dirent.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+namespace ATMSystem
+{
+    TransactionJournal::TransactionJournal(const std::string &dir, const std::string &atmSerial,
+                                           size_t recordsPerSegment)
+        : directory(dir), serial(atmSerial),
+          segmentRecords(recordsPerSegment > 0 ? recordsPerSegment : DEFAULT_SEGMENT_RECORDS)
+    {
+        ::mkdir(directory.c_str(), 0755);
+
+        // continue after the newest segment left by an earlier run
+        std::uint32_t index = 0;
+        while (segmentExists(directory, serial, index + 1))
+        {
+            index++;
+        }
+
+        // a segment written by an incompatible build is left alone
+        while (!openSegment(index, active))
+        {
+            if (!segmentExists(directory, serial, index))
+            {
+                return;
+            }
+            index++;
+        }
+
+        const SegmentHeader *header = active.header();
+        syncedEnd = JournalPosition{active.index, header->count};
+        for (std::uint32_t i = 0; i < header->cashSlotCount; i++)
+        {
+            recoveredCash[header->cash[i].denomination] = header->cash[i].count;
+        }
+    }
+
+    TransactionJournal::~TransactionJournal()
+    {
+        for (auto &segment : unsynced)
+        {
+            closeSegment(segment);
+        }
+        closeSegment(active);
+    }
+
+    std::string TransactionJournal::segmentPath(const std::string &directory, const std::string &serial,
+                                                std::uint32_t index)
+    {
+        char suffix[16];
+        std::snprintf(suffix, sizeof(suffix), "-%06u.log", index);
+        return directory + "/atm-" + serial + suffix;
+    }
+
+    bool TransactionJournal::segmentExists(const std::string &directory, const std::string &serial,
+                                           std::uint32_t index)
+    {
+        struct stat info;
+        return ::stat(segmentPath(directory, serial, index).c_str(), &info) == 0;
+    }
+
+    bool TransactionJournal::isCompatible(const SegmentHeader &header, size_t fileBytes)
+    {
+        return std::memcmp(header.magic, MAGIC, sizeof(MAGIC)) == 0 &&
+               header.version == VERSION &&
+               header.recordSize == sizeof(Transaction) &&
+               fileBytes >= sizeof(SegmentHeader) + header.capacity * sizeof(Transaction) &&
+               header.count <= header.capacity &&
+               header.cashSlotCount <= MAX_CASH_SLOTS;
+    }
+
+    Transaction *TransactionJournal::Segment::records() const
+    {
+        return reinterpret_cast<Transaction *>(static_cast<char *>(map) + sizeof(SegmentHeader));
+    }
+
+    bool TransactionJournal::openSegment(std::uint32_t index, Segment &segment) const
+    {
+        std::string path = segmentPath(directory, serial, index);
+        int fd = ::open(path.c_str(), O_RDWR | O_CREAT, 0644);
+        if (fd < 0)
+        {
+            return false;
+        }
+
+        struct stat info;
+        if (::fstat(fd, &info) != 0)
+        {
+            ::close(fd);
+            return false;
+        }
+
+        // a fresh file that could not be set up is removed, so a retry
+        // starts it over instead of finding a blank header
+        bool fresh = info.st_size == 0;
+        auto fail = [&](void *map, size_t bytes)
+        {
+            if (map)
+            {
+                ::munmap(map, bytes);
+            }
+            ::close(fd);
+            if (fresh)
+            {
+                ::unlink(path.c_str());
+            }
+            return false;
+        };
+
+        size_t bytes = fresh ? segmentBytes() : static_cast<size_t>(info.st_size);
+        if (fresh && ::ftruncate(fd, static_cast<off_t>(bytes)) != 0)
+        {
+            return fail(nullptr, 0);
+        }
+        if (bytes < sizeof(SegmentHeader))
+        {
+            return fail(nullptr, 0);
+        }
+
+        void *map = ::mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        if (map == MAP_FAILED)
+        {
+            return fail(nullptr, 0);
+        }
+
+        // a new segment file must survive a crash along with its records
+        if (fresh && !syncDirectory(directory))
+        {
+            return fail(map, bytes);
+        }
+
+        auto *header = static_cast<SegmentHeader *>(map);
+        if (fresh)
+        {
+            std::memcpy(header->magic, MAGIC, sizeof(MAGIC));
+            header->version = VERSION;
+            header->recordSize = sizeof(Transaction);
+            header->capacity = segmentRecords;
+            header->count = 0;
+            header->cashSlotCount = 0;
+        }
+        else if (!isCompatible(*header, bytes))
+        {
+            return fail(map, bytes);
+        }
+
+        segment.index = index;
+        segment.fd = fd;
+        segment.map = map;
+        segment.bytes = bytes;
+        segment.created = fresh;
+        return true;
+    }
+
+    void TransactionJournal::closeSegment(Segment &segment)
+    {
+        if (segment.map)
+        {
+            ::munmap(segment.map, segment.bytes);
+            segment.map = nullptr;
+            segment.bytes = 0;
+        }
+        if (segment.fd >= 0)
+        {
+            ::close(segment.fd);
+            segment.fd = -1;
+        }
+    }
+
+    void TransactionJournal::discardSegment(Segment &segment) const
+    {
+        closeSegment(segment);
+        ::unlink(segmentPath(directory, serial, segment.index).c_str());
+    }
+
+    bool TransactionJournal::appendBatch(const Transaction *records, size_t count, JournalPosition *positions)
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (!active.map)
+        {
+            return false;
+        }
+
+        // open every segment the batch needs before writing a record, so a
+        // failed rotation leaves the journal as it was and a later append
+        // tries it again
+        std::vector<Segment> next;
+        size_t needed = count - std::min<size_t>(count, active.header()->capacity - active.header()->count);
+        while (needed > 0)
+        {
+            Segment segment;
+            if (!openSegment((next.empty() ? active.index : next.back().index) + 1, segment))
+            {
+                for (auto &opened : next)
+                {
+                    if (opened.created)
+                    {
+                        discardSegment(opened);
+                    }
+                    else
+                    {
+                        closeSegment(opened);
+                    }
+                }
+                return false;
+            }
+            needed -= std::min<size_t>(needed, segment.header()->capacity - segment.header()->count);
+            next.push_back(segment);
+        }
+
+        size_t appended = count;
+        for (size_t i = 0;; i++)
+        {
+            SegmentHeader *header = active.header();
+            size_t chunk = std::min<size_t>(header->capacity - header->count, count);
+            std::memcpy(active.records() + header->count, records, chunk * sizeof(Transaction));
+            for (size_t r = 0; positions && r < chunk; r++)
+            {
+                *positions++ = JournalPosition{active.index, header->count + r};
+            }
+            __atomic_store_n(&header->count, header->count + chunk, __ATOMIC_RELEASE);
+            records += chunk;
+            count -= chunk;
+            if (i == next.size())
+            {
+                break;
+            }
+
+            // the full segment waits for the next sync; the cash counts
+            // carry over into the one that follows it
+            next[i].header()->cashSlotCount = header->cashSlotCount;
+            std::memcpy(next[i].header()->cash, header->cash, sizeof(header->cash));
+            unsynced.push_back(active);
+            active = next[i];
+        }
+        unsyncedCount += appended;
+        appendCount.fetch_add(appended, std::memory_order_relaxed);
+        return true;
+    }
+
+    bool TransactionJournal::sync()
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (!active.map)
+        {
+            return false;
+        }
+
+        // fdatasync also writes back pages dirtied through the shared mapping
+        bool synced = true;
+        for (const auto &segment : unsynced)
+        {
+            synced = synced && ::fdatasync(segment.fd) == 0;
+        }
+        synced = synced && ::fdatasync(active.fd) == 0;
+        if (!synced)
+        {
+            rollBack();
+            return false;
+        }
+
+        for (auto &segment : unsynced)
+        {
+            closeSegment(segment);
+        }
+        unsynced.clear();
+        syncedEnd = JournalPosition{active.index, active.header()->count};
+        unsyncedCount = 0;
+        return true;
+    }
+
+    void TransactionJournal::rollBack()
+    {
+        // the records after syncedEnd were reported as failed, so they must
+        // not be read back or replayed; segments started since then hold
+        // nothing else and are deleted
+        if (!unsynced.empty())
+        {
+            Segment kept = unsynced.front();
+            kept.header()->cashSlotCount = active.header()->cashSlotCount;
+            std::memcpy(kept.header()->cash, active.header()->cash, sizeof(kept.header()->cash));
+            for (size_t i = 1; i < unsynced.size(); i++)
+            {
+                discardSegment(unsynced[i]);
+            }
+            discardSegment(active);
+            unsynced.clear();
+            active = kept;
+            syncDirectory(directory);
+        }
+        __atomic_store_n(&active.header()->count, syncedEnd.record, __ATOMIC_RELEASE);
+        appendCount.fetch_sub(unsyncedCount, std::memory_order_relaxed);
+        unsyncedCount = 0;
+
+        // best effort; the next successful sync writes the count back anyway
+        ::fdatasync(active.fd);
+    }
+
+    void TransactionJournal::recordCash(const std::map<int, int> &inventory)
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (!active.map)
+        {
+            return;
+        }
+
+        SegmentHeader *header = active.header();
+        std::uint32_t slot = 0;
+        for (const auto &[denomination, count] : inventory)
+        {
+            if (slot == MAX_CASH_SLOTS)
+            {
+                break;
+            }
+            header->cash[slot].denomination = denomination;
+            header->cash[slot].count = count;
+            slot++;
+        }
+        header->cashSlotCount = slot;
+    }
+
+    bool TransactionJournal::syncDirectory(const std::string &directory)
+    {
+        int fd = ::open(directory.c_str(), O_RDONLY | O_DIRECTORY);
+        if (fd < 0)
+        {
+            return false;
+        }
+        bool synced = ::fsync(fd) == 0;
+        ::close(fd);
+        return synced;
+    }
+
+    JournalPosition TransactionJournal::currentEnd() const
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        return syncedEnd;
+    }
+
+    TransactionJournal::SegmentMap::SegmentMap(const std::string &directory, const std::string &serial,
+                                               std::uint32_t index)
+    {
+        int fd = ::open(segmentPath(directory, serial, index).c_str(), O_RDONLY);
+        if (fd < 0)
+        {
+            return;
+        }
+        struct stat info;
+        if (::fstat(fd, &info) == 0 && static_cast<size_t>(info.st_size) >= sizeof(SegmentHeader))
+        {
+            size_t fileBytes = static_cast<size_t>(info.st_size);
+            void *mapped = ::mmap(nullptr, fileBytes, PROT_READ, MAP_SHARED, fd, 0);
+            if (mapped != MAP_FAILED)
+            {
+                if (isCompatible(*static_cast<const SegmentHeader *>(mapped), fileBytes))
+                {
+                    map = mapped;
+                    bytes = fileBytes;
+                }
+                else
+                {
+                    ::munmap(mapped, fileBytes);
+                }
+            }
+        }
+        ::close(fd);
+    }
+
+    TransactionJournal::SegmentMap::~SegmentMap()
+    {
+        if (map)
+        {
+            ::munmap(map, bytes);
+        }
+    }
+
+    std::uint64_t TransactionJournal::SegmentMap::getCount() const
+    {
+        return map ? __atomic_load_n(&static_cast<const SegmentHeader *>(map)->count, __ATOMIC_ACQUIRE) : 0;
+    }
+
+    const Transaction &TransactionJournal::SegmentMap::operator[](std::uint64_t record) const
+    {
+        const auto *records = reinterpret_cast<const Transaction *>(static_cast<const char *>(map) + sizeof(SegmentHeader));
+        return records[record];
+    }
+
+    std::uint32_t TransactionJournal::getSegmentCount() const
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        return active.map ? active.index + 1 : 0;
+    }
+
+    std::vector<std::string> TransactionJournal::listSerials(const std::string &directory)
+    {
+        std::vector<std::string> serials;
+        DIR *dir = ::opendir(directory.c_str());
+        if (!dir)
+        {
+            return serials;
+        }
+
+        // every journal has a first segment named atm-<serial>-000000.log
+        static constexpr std::string_view PREFIX = "atm-";
+        static constexpr std::string_view FIRST_SUFFIX = "-000000.log";
+        while (const dirent *entry = ::readdir(dir))
+        {
+            std::string_view name = entry->d_name;
+            if (name.size() > PREFIX.size() + FIRST_SUFFIX.size() &&
+                name.substr(0, PREFIX.size()) == PREFIX &&
+                name.substr(name.size() - FIRST_SUFFIX.size()) == FIRST_SUFFIX)
+            {
+                name.remove_prefix(PREFIX.size());
+                name.remove_suffix(FIRST_SUFFIX.size());
+                serials.emplace_back(name);
+            }
+        }
+        ::closedir(dir);
+        return serials;
+    }
+
+    JournalPosition TransactionJournal::endPosition(const std::string &directory, const std::string &serial)
+    {
+        JournalPosition end;
+        if (!segmentExists(directory, serial, 0))
+        {
+            return end;
+        }
+        while (segmentExists(directory, serial, end.segment + 1))
+        {
+            end.segment++;
+        }
+        visitSegments(directory, serial, JournalPosition{end.segment, 0},
+                      [&end](const Transaction *, size_t count, JournalPosition)
+                      { end.record = count; });
+        return end;
+    }
+
+    void TransactionJournal::visitSegments(const std::string &directory, const std::string &serial,
+                                           JournalPosition from, const SegmentVisitor &visit,
+                                           JournalPosition to)
+    {
+        for (std::uint32_t index = from.segment; index <= to.segment && segmentExists(directory, serial, index); index++)
+        {
+            int fd = ::open(segmentPath(directory, serial, index).c_str(), O_RDONLY);
+            if (fd < 0)
+            {
+                continue;
+            }
+            struct stat info;
+            if (::fstat(fd, &info) == 0 && static_cast<size_t>(info.st_size) >= sizeof(SegmentHeader))
+            {
+                size_t bytes = static_cast<size_t>(info.st_size);
+                void *map = ::mmap(nullptr, bytes, PROT_READ, MAP_SHARED, fd, 0);
+                if (map != MAP_FAILED)
+                {
+                    const auto *header = static_cast<const SegmentHeader *>(map);
+                    if (isCompatible(*header, bytes))
+                    {
+                        std::uint64_t count = __atomic_load_n(&header->count, __ATOMIC_ACQUIRE);
+                        if (index == to.segment)
+                        {
+                            count = std::min(count, to.record);
+                        }
+                        std::uint64_t first = index == from.segment ? std::min(from.record, count) : 0;
+                        const auto *records = reinterpret_cast<const Transaction *>(
+                            static_cast<const char *>(map) + sizeof(SegmentHeader));
+                        visit(records + first, static_cast<size_t>(count - first), JournalPosition{index, first});
+                    }
+                    ::munmap(map, bytes);
+                }
+            }
+            ::close(fd);
+        }
+    }
+}
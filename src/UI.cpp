@@ -2,25 +2,80 @@
 #include <iostream>
 #include <iomanip>
 #include <sstream>
+#include <limits>
+#include <unordered_map>
 
 namespace ATMSystem
 {
     UI::UI(bool bilingual) : isBilingual(bilingual), isKorean(false) {}
 
-    std::string UI::getLocalizedMessage(const std::string &key) const
+    std::optional<MessageId> UI::findMessageId(std::string_view key)
     {
-        auto it = messages.find(key);
-        if (it != messages.end())
+        // built once and shared by every UI instance
+        static const std::unordered_map<std::string_view, MessageId> index = []
+        {
+            std::unordered_map<std::string_view, MessageId> keys;
+            keys.reserve(MESSAGE_COUNT);
+            for (const auto &entry : MESSAGE_CATALOG)
+            {
+                keys.emplace(entry.key, entry.id);
+            }
+            return keys;
+        }();
+
+        auto it = index.find(key);
+        if (it != index.end())
         {
-            return isKorean ? it->second.second : it->second.first;
+            return it->second;
         }
-        return getLocalizedMessage("MESSAGE_NOT_FOUND");
+        return std::nullopt;
+    }
+
+    std::string_view UI::getLocalizedView(MessageId id) const
+    {
+        const auto &entry = MESSAGE_CATALOG[static_cast<std::size_t>(id)];
+        return isKorean ? entry.korean : entry.english;
+    }
+
+    const MessageTemplate &UI::getTemplate(MessageId id) const
+    {
+        // parsed once; English and Korean templates are interleaved per id
+        static const std::vector<MessageTemplate> templates = []
+        {
+            std::vector<MessageTemplate> parsed;
+            parsed.reserve(MESSAGE_COUNT * 2);
+            for (const auto &entry : MESSAGE_CATALOG)
+            {
+                parsed.emplace_back(entry.english);
+                parsed.emplace_back(entry.korean);
+            }
+            return parsed;
+        }();
+
+        return templates[static_cast<std::size_t>(id) * 2 + (isKorean ? 1 : 0)];
+    }
+
+    std::string UI::getLocalizedMessage(MessageId id) const
+    {
+        return std::string(getLocalizedView(id));
+    }
+
+    std::string UI::getLocalizedMessage(const std::string &key) const
+    {
+        auto id = findMessageId(key);
+        return getLocalizedMessage(id ? *id : MessageId::MESSAGE_NOT_FOUND);
     }
 
     void UI::displayMessage(const std::string &messageKey) const
+    {
+        auto id = findMessageId(messageKey);
+        displayMessage(id ? *id : MessageId::MESSAGE_NOT_FOUND);
+    }
+
+    void UI::displayMessage(MessageId id) const
     {
         std::cout << "\n"
-                  << getLocalizedMessage(messageKey) << std::endl;
+                  << getLocalizedView(id) << std::endl;
     }
 
     void UI::setLanguage(bool korean)
@@ -30,7 +85,7 @@ namespace ATMSystem
 
     void UI::displayMenu() const
     {
-        displayMessage("SELECT_SERVICE");
+        displayMessage(MessageId::SELECT_SERVICE);
     }
 
     std::string UI::getInput() const
@@ -42,12 +97,12 @@ namespace ATMSystem
 
     bool UI::processCardInsertion()
     {
-        showDisplayPanel("INSERT_CARD");
+        showDisplayPanel(MessageId::INSERT_CARD);
         std::string cardNumber = getInput();
 
         if (cardNumber.length() != 12)
         {
-            displayMessage("INVALID_CARD");
+            displayMessage(MessageId::INVALID_CARD);
             return false;
         }
         return true;
@@ -55,10 +110,16 @@ namespace ATMSystem
 
     void UI::showDisplayPanel(const std::string &messageKey) const
     {
-        std::string border = getLocalizedMessage("SYSTEM_BORDER");
+        auto id = findMessageId(messageKey);
+        showDisplayPanel(id ? *id : MessageId::MESSAGE_NOT_FOUND);
+    }
+
+    void UI::showDisplayPanel(MessageId id) const
+    {
+        std::string_view border = getLocalizedView(MessageId::SYSTEM_BORDER);
         std::cout << "\n"
                   << border << "\n";
-        std::cout << getLocalizedMessage(messageKey);
+        std::cout << getLocalizedView(id);
         std::cout << "\n"
                   << border << "\n";
     }
@@ -73,24 +134,18 @@ namespace ATMSystem
         std::map<int, int> cashInput;
         int totalBills = 0;
 
-        displayMessage("ENTER_BILLS");
+        displayMessage(MessageId::ENTER_BILLS);
 
         for (const auto &[denomination, _] : VALID_DENOMINATIONS)
         {
             int count;
             do
             {
-                std::string message = getLocalizedMessage("BILL_PROMPT");
-                size_t pos = message.find("{}");
-                if (pos != std::string::npos)
-                {
-                    message.replace(pos, 2, std::to_string(denomination));
-                }
-                std::cout << message << " ";
+                std::cout << formatMessage(MessageId::BILL_PROMPT, denomination) << " ";
 
                 if (!(std::cin >> count) || count < 0)
                 {
-                    std::cout << getLocalizedMessage("INVALID_AMOUNT") << "\n";
+                    std::cout << getLocalizedView(MessageId::INVALID_AMOUNT) << "\n";
                     std::cin.clear();
                     std::cin.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
                     continue;
@@ -98,7 +153,7 @@ namespace ATMSystem
 
                 if (totalBills + count > MAX_CASH_INSERT)
                 {
-                    std::cout << getLocalizedMessage("MAX_DEPOSIT_EXCEEDED") << "\n";
+                    std::cout << getLocalizedView(MessageId::MAX_DEPOSIT_EXCEEDED) << "\n";
                     continue;
                 }
                 break;
@@ -116,38 +171,136 @@ namespace ATMSystem
 
     void UI::showTransactionSummary(const std::vector<std::string> &summary) const
     {
-        std::cout << "\n=== " << getLocalizedMessage("TRANSACTION_SUMMARY") << " ===\n";
+        std::cout << "\n=== " << getLocalizedView(MessageId::TRANSACTION_SUMMARY) << " ===\n";
         for (const auto &line : summary)
         {
             std::cout << line << "\n";
         }
-        std::cout << getLocalizedMessage("THANK_YOU") << std::endl;
+        std::cout << getLocalizedView(MessageId::THANK_YOU) << std::endl;
     }
 
     void UI::printReceipt(const std::vector<std::string> &transactionDetails) const
     {
-        std::cout << "\n=== " << getLocalizedMessage("TRANSACTION_SUMMARY") << " ===\n";
+        std::cout << "\n=== " << getLocalizedView(MessageId::TRANSACTION_SUMMARY) << " ===\n";
         for (const auto &detail : transactionDetails)
         {
             std::cout << detail << "\n";
         }
-        std::cout << getLocalizedMessage("THANK_YOU") << std::endl;
+        std::cout << getLocalizedView(MessageId::THANK_YOU) << std::endl;
     }
 
     void UI::showCashDispenser(const std::map<int, int> &cash) const
     {
-        displayMessage("BILLS_BREAKDOWN");
+        displayMessage(MessageId::BILLS_BREAKDOWN);
+        const MessageTemplate &format = getTemplate(MessageId::BILL_FORMAT);
+        std::string line;
         for (const auto &[denomination, count] : cash)
         {
             if (count > 0)
             {
-                std::string format = getLocalizedMessage("BILL_FORMAT");
-                size_t pos = format.find("{}");
-                format.replace(pos, 2, std::to_string(count));
-                pos = format.find("{}");
-                format.replace(pos, 2, std::to_string(denomination));
-                std::cout << format << "\n";
+                line.clear();
+                format.appendTo(line, count, denomination);
+                line.push_back('\n');
+                std::cout << line;
             }
         }
     }
-}
\ No newline at end of file
+
+    bool UI::getExportOptions(ExportOptions &options) const
+    {
+        std::cout << getLocalizedView(MessageId::EXPORT_FORMAT_PROMPT);
+        std::string format = getInput();
+        if (format == "1")
+        {
+            options.format = ExportFormat::CSV;
+        }
+        else if (format == "2")
+        {
+            options.format = ExportFormat::JSON_LINES;
+        }
+        else if (format == "3")
+        {
+            options.format = ExportFormat::BINARY;
+        }
+        else
+        {
+            displayMessage(MessageId::INVALID_CHOICE);
+            return false;
+        }
+
+        std::cout << getLocalizedView(MessageId::EXPORT_PATH_PROMPT);
+        options.path = getInput();
+        if (options.path.empty())
+        {
+            return false;
+        }
+
+        // empty dates leave that end of the range open
+        std::cout << getLocalizedView(MessageId::EXPORT_FROM_PROMPT);
+        std::string from = getInput();
+        std::cout << getLocalizedView(MessageId::EXPORT_TO_PROMPT);
+        std::string to = getInput();
+        auto fromTime = TransactionExporter::parseDate(from, false);
+        auto toTime = TransactionExporter::parseDate(to, true);
+        if ((!from.empty() && !fromTime) || (!to.empty() && !toTime))
+        {
+            return false;
+        }
+        if (fromTime)
+        {
+            options.from = *fromTime;
+        }
+        if (toTime)
+        {
+            options.to = *toTime;
+        }
+        return true;
+    }
+
+    bool UI::getHistoryQuery(HistoryQuery &query) const
+    {
+        std::cout << getLocalizedView(MessageId::HISTORY_CARD_PROMPT);
+        std::string card = getInput();
+        if (!card.empty())
+        {
+            query.card = parseAccountNumber(card);
+            if (!query.card)
+            {
+                displayMessage(MessageId::INVALID_ACCOUNT);
+                return false;
+            }
+        }
+
+        std::cout << getLocalizedView(MessageId::HISTORY_TYPE_PROMPT);
+        std::string type = getInput();
+        if (type == "1" || type == "2" || type == "3" || type == "4")
+        {
+            query.type = static_cast<TransactionType>(type[0] - '1');
+        }
+        else if (!type.empty())
+        {
+            displayMessage(MessageId::INVALID_CHOICE);
+            return false;
+        }
+
+        std::cout << getLocalizedView(MessageId::EXPORT_FROM_PROMPT);
+        std::string from = getInput();
+        std::cout << getLocalizedView(MessageId::EXPORT_TO_PROMPT);
+        std::string to = getInput();
+        auto fromTime = TransactionExporter::parseDate(from, false);
+        auto toTime = TransactionExporter::parseDate(to, true);
+        if ((!from.empty() && !fromTime) || (!to.empty() && !toTime))
+        {
+            return false;
+        }
+        if (fromTime)
+        {
+            query.from = *fromTime;
+        }
+        if (toTime)
+        {
+            query.to = *toTime;
+        }
+        return true;
+    }
+}
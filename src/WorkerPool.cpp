@@ -0,0 +1,86 @@
+#include "WorkerPool.hpp"
+#include <algorithm>
+
+namespace ATMSystem
+{
+    size_t WorkerPool::defaultThreadCount()
+    {
+        return std::max(1u, std::thread::hardware_concurrency());
+    }
+
+    WorkerPool::WorkerPool(size_t threadCount, size_t maxQueued)
+    {
+        this->maxQueued = maxQueued > 0 ? maxQueued : threadCount * 2;
+        threads.reserve(threadCount);
+        for (size_t i = 0; i < threadCount; i++)
+        {
+            threads.emplace_back(&WorkerPool::run, this);
+        }
+    }
+
+    WorkerPool::~WorkerPool()
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            stopping = true;
+        }
+        workAvailable.notify_all();
+        // workers finish the queue before they exit
+        for (auto &thread : threads)
+        {
+            thread.join();
+        }
+    }
+
+    void WorkerPool::submit(std::function<void()> job)
+    {
+        if (threads.empty())
+        {
+            job();
+            return;
+        }
+
+        std::unique_lock<std::mutex> lock(mutex);
+        spaceAvailable.wait(lock, [this]()
+                            { return jobs.size() < maxQueued; });
+        jobs.push_back(std::move(job));
+        lock.unlock();
+        workAvailable.notify_one();
+    }
+
+    void WorkerPool::wait()
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        idle.wait(lock, [this]()
+                  { return jobs.empty() && running == 0; });
+    }
+
+    void WorkerPool::run()
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        while (true)
+        {
+            workAvailable.wait(lock, [this]()
+                               { return stopping || !jobs.empty(); });
+            if (jobs.empty())
+            {
+                return;
+            }
+
+            auto job = std::move(jobs.front());
+            jobs.pop_front();
+            running++;
+            lock.unlock();
+            spaceAvailable.notify_one();
+
+            job();
+
+            lock.lock();
+            running--;
+            if (jobs.empty() && running == 0)
+            {
+                idle.notify_all();
+            }
+        }
+    }
+}
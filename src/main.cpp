@@ -1,24 +1,71 @@
 #include <iostream>
 #include <memory>
 #include <iomanip>
+#include <charconv>
+#include <optional>
 #include "SystemInitializer.hpp"
 #include "UI.hpp"
 #include "ATM.hpp"
 #include "Bank.hpp"
 #include "SystemSnapshot.hpp"
+#include "RecoveryManager.hpp"
+#include "FleetExporter.hpp"
 
 using namespace ATMSystem;
 
-std::string formatCurrency(int amount)
+void appendCurrency(std::string &out, Money amount)
 {
-    std::string str = std::to_string(amount);
-    int pos = str.length() - 3;
-    while (pos > 0)
+    char digits[24];
+    auto result = std::to_chars(digits, digits + sizeof(digits), amount.toWon());
+    const char *first = digits;
+    out.append("KRW ");
+    if (*first == '-')
     {
-        str.insert(pos, ",");
-        pos -= 3;
+        out.push_back('-');
+        first++;
     }
-    return "KRW " + str;
+
+    // group digits in threes
+    size_t length = result.ptr - first;
+    for (size_t i = 0; i < length; i++)
+    {
+        if (i > 0 && (length - i) % 3 == 0)
+        {
+            out.push_back(',');
+        }
+        out.push_back(first[i]);
+    }
+}
+
+std::string formatCurrency(Money amount)
+{
+    std::string str;
+    appendCurrency(str, amount);
+    return str;
+}
+
+Money cashTotal(const std::map<int, int> &cash)
+{
+    Money total;
+    for (const auto &[denom, count] : cash)
+    {
+        total += Money(denom) * count;
+    }
+    return total;
+}
+
+// handles "/" and "/ key=value ..." from the admin prompts
+void displaySnapshot(UI &ui, const std::string &command, const std::vector<std::shared_ptr<ATM>> &atms,
+                     const std::vector<std::shared_ptr<Bank>> &banks)
+{
+    SnapshotFilter filter;
+    if (!SnapshotFilter::parse(std::string_view(command).substr(1), filter))
+    {
+        ui.displayMessage(MessageId::SNAPSHOT_FILTER_USAGE);
+        return;
+    }
+    SystemSnapshot snapshot(atms, banks);
+    snapshot.displaySnapshot(filter);
 }
 
 void displayHorizontalLine(int length = 50)
@@ -29,30 +76,28 @@ void displayHorizontalLine(int length = 50)
 
 void handleATMSelection(UI &ui, const std::vector<std::shared_ptr<ATM>> &atms, std::string &atmChoice)
 {
-    std::string prompt = ui.getLocalizedMessage("SELECT_ATM");
-    size_t pos = prompt.find("{}");
-    prompt.replace(pos, 2, std::to_string(atms.size()));
+    std::string prompt = ui.formatMessage(MessageId::SELECT_ATM, atms.size());
     std::cout << prompt;
     atmChoice = ui.getInput();
 }
 
 void displayTransferOptions(UI &ui, std::string &transferType)
 {
-    ui.displayMessage("TRANSFER_TYPE");
+    ui.displayMessage(MessageId::TRANSFER_TYPE);
     transferType = ui.getInput();
 
     if (transferType != "1" && transferType != "2")
     {
-        ui.displayMessage("INVALID_CHOICE");
+        ui.displayMessage(MessageId::INVALID_CHOICE);
     }
 }
 
 void handleTransferAmount(UI &ui, int &amount, bool &shouldContinue)
 {
-    ui.displayMessage("TRANSFER_AMOUNT");
+    ui.displayMessage(MessageId::TRANSFER_AMOUNT);
     if (!(std::cin >> amount))
     {
-        ui.displayMessage("INVALID_AMOUNT");
+        ui.displayMessage(MessageId::INVALID_AMOUNT);
         std::cin.clear();
         std::cin.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
         shouldContinue = false;
@@ -62,47 +107,41 @@ void handleTransferAmount(UI &ui, int &amount, bool &shouldContinue)
     shouldContinue = true;
 }
 
-void displayTransferResult(UI &ui, int transferredAmount, int fee, const std::string &destAccountNum, double newBalance)
+void displayTransferResult(UI &ui, Money transferredAmount, Money fee, const std::string &destAccountNum, Money newBalance)
 {
-    ui.displayMessage("TRANSFER_SUCCESS");
-    std::cout << ui.getLocalizedMessage("AMOUNT") << " " << formatCurrency(transferredAmount) << "\n";
-    std::cout << ui.getLocalizedMessage("FEE_LABEL") << " " << formatCurrency(fee) << "\n";
-    std::cout << ui.getLocalizedMessage("NEW_BALANCE_LABEL") << " " << formatCurrency(newBalance) << "\n";
+    ui.displayMessage(MessageId::TRANSFER_SUCCESS);
+    std::cout << ui.getLocalizedView(MessageId::AMOUNT) << " " << formatCurrency(transferredAmount) << "\n";
+    std::cout << ui.getLocalizedView(MessageId::FEE_LABEL) << " " << formatCurrency(fee) << "\n";
+    std::cout << ui.getLocalizedView(MessageId::NEW_BALANCE_LABEL) << " " << formatCurrency(newBalance) << "\n";
 }
 
 void displayCashBreakdown(UI &ui, const std::map<int, int> &bills)
 {
-    ui.displayMessage("BILLS_BREAKDOWN");
+    ui.displayMessage(MessageId::BILLS_BREAKDOWN);
     for (const auto &[denom, count] : bills)
     {
         if (count > 0)
         {
-            std::cout << count << " × " << formatCurrency(denom) << "\n";
+            std::cout << count << " × " << formatCurrency(Money(denom)) << "\n";
         }
     }
 }
 
 bool processDepositFee(UI &ui, const std::shared_ptr<ATM> &atm, bool isPrimaryBank)
 {
-    int fee = isPrimaryBank ? TransactionFees::DEPOSIT_PRIMARY : TransactionFees::DEPOSIT_NON_PRIMARY;
+    Money fee = isPrimaryBank ? TransactionFees::DEPOSIT_PRIMARY : TransactionFees::DEPOSIT_NON_PRIMARY;
 
-    std::string message = ui.getLocalizedMessage("DEPOSIT_FEE_REQUIRED");
-    size_t pos = message.find("{}");
-    message.replace(pos, 2, formatCurrency(fee));
+    std::string message = ui.formatMessage(MessageId::DEPOSIT_FEE_REQUIRED, formatCurrency(fee));
     std::cout << message << "\n";
 
-    ui.displayMessage("ENTER_FEE_CASH");
+    ui.displayMessage(MessageId::ENTER_FEE_CASH);
 
     auto feeInput = ui.getCashInput();
-    int totalFeeInput = 0;
-    for (const auto &[denom, count] : feeInput)
-    {
-        totalFeeInput += denom * count;
-    }
+    Money totalFeeInput = cashTotal(feeInput);
 
     if (totalFeeInput < fee)
     {
-        ui.displayMessage("INSUFFICIENT_FEE");
+        ui.displayMessage(MessageId::INSUFFICIENT_FEE);
         return false;
     }
 
@@ -112,28 +151,20 @@ bool processDepositFee(UI &ui, const std::shared_ptr<ATM> &atm, bool isPrimaryBa
 
 void displayAvailableATMs(const std::vector<std::shared_ptr<ATM>> &atms, UI &ui)
 {
-    ui.displayMessage("AVAILABLE_ATMS");
+    ui.displayMessage(MessageId::AVAILABLE_ATMS);
+    const MessageTemplate &entry = ui.getTemplate(MessageId::ATM_LIST_ENTRY);
+    std::string line;
     for (size_t i = 0; i < atms.size(); i++)
     {
         const auto &atm = atms[i];
-        std::string message = ui.getLocalizedMessage("ATM_LIST_ENTRY");
-        size_t pos;
-
-        pos = message.find("{}");
-        message.replace(pos, 2, std::to_string(i + 1));
-
-        pos = message.find("{}");
-        message.replace(pos, 2, atm->getSerialNumber());
-
-        pos = message.find("{}");
-        message.replace(pos, 2, atm->getBankType() == BankType::SINGLE_BANK ? "Single" : "Multi");
-
-        pos = message.find("{}");
-        message.replace(pos, 2, atm->getPrimaryBank()->getName());
-
-        std::cout << message << "\n";
+        line.clear();
+        entry.appendTo(line, i + 1, atm->getSerialNumber(),
+                       atm->getBankType() == BankType::SINGLE_BANK ? "Single" : "Multi",
+                       atm->getPrimaryBank()->getName());
+        line.push_back('\n');
+        std::cout << line;
     }
-    ui.displayMessage("QUIT_PROMPT");
+    ui.displayMessage(MessageId::QUIT_PROMPT);
 }
 
 void displaySessionSummary(const std::shared_ptr<Session> &session,
@@ -143,23 +174,19 @@ void displaySessionSummary(const std::shared_ptr<Session> &session,
                            const std::shared_ptr<Account> &userAccount,
                            UI &ui)
 {
-    ui.displayMessage("SESSION_SUMMARY_HEADER");
+    ui.displayMessage(MessageId::SESSION_SUMMARY_HEADER);
 
-    std::string sessionMsg = ui.getLocalizedMessage("SESSION_ID");
-    size_t pos = sessionMsg.find("{}");
-    sessionMsg.replace(pos, 2, session->getSessionId());
+    std::string sessionMsg = ui.formatMessage(MessageId::SESSION_ID, session->getSessionId());
     std::cout << sessionMsg << "\n";
 
-    std::cout << ui.getLocalizedMessage("CARD_NUMBER_LABEL") << " " << cardNumber << "\n";
-    std::cout << ui.getLocalizedMessage("BANK_LABEL") << " " << cardBank->getName() << "\n";
+    std::cout << ui.getLocalizedView(MessageId::CARD_NUMBER_LABEL) << " " << cardNumber << "\n";
+    std::cout << ui.getLocalizedView(MessageId::BANK_LABEL) << " " << cardBank->getName() << "\n";
 
     auto startTime = session->getStartTime();
     auto endTime = std::chrono::system_clock::now();
     auto duration = std::chrono::duration_cast<std::chrono::minutes>(endTime - startTime).count();
 
-    std::string durationMsg = ui.getLocalizedMessage("SESSION_DURATION");
-    pos = durationMsg.find("{}");
-    durationMsg.replace(pos, 2, std::to_string(duration));
+    std::string durationMsg = ui.formatMessage(MessageId::SESSION_DURATION, duration);
     std::cout << durationMsg << "\n\n";
 
     for (const auto &transaction : transactionLog)
@@ -168,72 +195,60 @@ void displaySessionSummary(const std::shared_ptr<Session> &session,
     }
     std::cout << "\n=================\n";
 
-    std::string balanceMsg = ui.getLocalizedMessage("FINAL_BALANCE");
-    pos = balanceMsg.find("{}");
-    balanceMsg.replace(pos, 2, formatCurrency(userAccount->getBalance()));
+    std::string balanceMsg = ui.formatMessage(MessageId::FINAL_BALANCE, formatCurrency(userAccount->getBalance()));
     std::cout << balanceMsg << "\n";
 }
 
-bool handleDepositFee(UI &ui, const std::shared_ptr<ATM> &atm, bool isPrimaryBank, int &totalFeeInput)
+// Collects the deposit fee; feeInput is the cash to keep once the deposit is made
+bool handleDepositFee(UI &ui, bool isPrimaryBank, std::map<int, int> &feeInput, Money &totalFeeInput)
 {
-    int fee = isPrimaryBank ? TransactionFees::DEPOSIT_PRIMARY : TransactionFees::DEPOSIT_NON_PRIMARY;
+    Money fee = isPrimaryBank ? TransactionFees::DEPOSIT_PRIMARY : TransactionFees::DEPOSIT_NON_PRIMARY;
 
-    std::string message = ui.getLocalizedMessage("DEPOSIT_FEE_REQUIRED");
-    size_t pos = message.find("{}");
-    message.replace(pos, 2, formatCurrency(fee));
+    std::string message = ui.formatMessage(MessageId::DEPOSIT_FEE_REQUIRED, formatCurrency(fee));
     std::cout << message << "\n";
 
-    ui.displayMessage("ENTER_FEE_CASH");
-    auto feeInput = ui.getCashInput();
-    totalFeeInput = 0;
-
-    for (const auto &[denom, count] : feeInput)
-    {
-        totalFeeInput += denom * count;
-    }
+    ui.displayMessage(MessageId::ENTER_FEE_CASH);
+    feeInput = ui.getCashInput();
+    totalFeeInput = cashTotal(feeInput);
 
     if (totalFeeInput < fee)
     {
-        ui.displayMessage("INSUFFICIENT_FEE");
+        ui.displayMessage(MessageId::INSUFFICIENT_FEE);
         return false;
     }
 
     // Only handle change once
     if (totalFeeInput > fee)
     {
-        int change = totalFeeInput - fee;
-        std::string changeMsg = ui.getLocalizedMessage("CHANGE_AMOUNT");
-        pos = changeMsg.find("{}");
-        changeMsg.replace(pos, 2, formatCurrency(change));
+        Money change = totalFeeInput - fee;
+        std::string changeMsg = ui.formatMessage(MessageId::CHANGE_AMOUNT, formatCurrency(change));
         std::cout << changeMsg << "\n";
 
-        ui.displayMessage("TAKE_CHANGE");
+        ui.displayMessage(MessageId::TAKE_CHANGE);
         std::string response = ui.getInput();
         if (response != "y" && response != "Y")
         {
-            ui.displayMessage("CANCEL_TRANSACTION");
+            ui.displayMessage(MessageId::CANCEL_TRANSACTION);
             return false;
         }
 
         // Adjust the totalFeeInput to exactly match the fee
         totalFeeInput = fee;
     }
-
-    atm->addCash(feeInput);
     return true;
 }
 
 void handleWithdrawalInput(UI &ui, int &amount, bool &shouldContinue)
 {
 
-    std::string prompt = ui.getLocalizedMessage("WITHDRAWAL_AMOUNT");
+    std::string prompt = ui.getLocalizedMessage(MessageId::WITHDRAWAL_AMOUNT);
     size_t pos = prompt.find("{}");
     // prompt.replace(pos, 2, formatCurrency(MAX_WITHDRAWAL_PER_TRANSACTION));
     std::cout << prompt;
 
     if (!(std::cin >> amount))
     {
-        ui.displayMessage("INVALID_AMOUNT");
+        ui.displayMessage(MessageId::INVALID_AMOUNT);
         std::cin.clear();
         std::cin.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
         shouldContinue = false;
@@ -243,7 +258,7 @@ void handleWithdrawalInput(UI &ui, int &amount, bool &shouldContinue)
 
     if (amount <= 0)
     {
-        ui.displayMessage("INVALID_AMOUNT");
+        ui.displayMessage(MessageId::INVALID_AMOUNT);
         shouldContinue = false;
         return;
     }
@@ -251,35 +266,119 @@ void handleWithdrawalInput(UI &ui, int &amount, bool &shouldContinue)
     if (amount > MAX_WITHDRAWAL_PER_TRANSACTION)
     {
 
-        ui.displayMessage("MAX_WITHDRAWAL_EXCEEDED");
+        ui.displayMessage(MessageId::MAX_WITHDRAWAL_EXCEEDED);
         shouldContinue = false;
         return;
     }
     shouldContinue = true;
 }
 
-std::string formatTransactionLog(UI &ui, const std::string &typeKey, int amount, int fee, const std::string &destAccount = "")
+std::string formatTransactionLog(UI &ui, MessageId typeKey, Money amount, Money fee, const std::string &destAccount = "")
 {
-    std::string logEntry = ui.getLocalizedMessage(typeKey) + ": " + formatCurrency(amount) + " (" + ui.getLocalizedMessage("FEE_LABEL") + " " + formatCurrency(fee) + ")";
+    std::string logEntry;
+    logEntry.reserve(96);
+    logEntry.append(ui.getLocalizedView(typeKey));
+    logEntry.append(": ");
+    appendCurrency(logEntry, amount);
+    logEntry.append(" (");
+    logEntry.append(ui.getLocalizedView(MessageId::FEE_LABEL));
+    logEntry.push_back(' ');
+    appendCurrency(logEntry, fee);
+    logEntry.push_back(')');
     if (!destAccount.empty())
     {
-        logEntry += " " + ui.getLocalizedMessage("TO") + " " + destAccount;
+        logEntry.push_back(' ');
+        logEntry.append(ui.getLocalizedView(MessageId::TO));
+        logEntry.push_back(' ');
+        logEntry.append(destAccount);
     }
     return logEntry;
 }
 
-int main()
+int main(int argc, char *argv[])
 {
     try
     {
-        // initialize system
+        bool recoverMode = false;
+        std::string provisionFile;
+        std::string imageFile;
+        std::optional<std::uint64_t> numberSeed;
+        DispensePolicy dispensePolicy = DispensePolicy::MINIMIZE_BILLS;
+        for (int i = 1; i < argc; i++)
+        {
+            std::string arg = argv[i];
+            if (arg == "--recover")
+            {
+                recoverMode = true;
+            }
+            else if (arg == "--provision" && i + 1 < argc)
+            {
+                provisionFile = argv[++i];
+            }
+            else if (arg == "--image" && i + 1 < argc)
+            {
+                imageFile = argv[++i];
+            }
+            else if (arg == "--seed" && i + 1 < argc)
+            {
+                // reproducible account and serial numbers for scripted runs
+                numberSeed = std::stoull(argv[++i]);
+            }
+            else if (arg == "--preserve-scarce")
+            {
+                // dispense from the fullest cassettes instead of the fewest bills
+                dispensePolicy = DispensePolicy::PRESERVE_SCARCE;
+            }
+        }
+
+        // initialize system from a saved image, a provisioning file or prompts
         UI ui(false);
-        SystemInitializer initializer(ui);
-        initializer.initializeSystem();
+        SystemInitializer initializer(ui, numberSeed.value_or(NumberAllocator::randomKey()));
+        bool fromImage = !imageFile.empty() && initializer.restoreFromImage(imageFile);
+        if (!fromImage)
+        {
+            if (provisionFile.empty())
+            {
+                initializer.initializeSystem();
+            }
+            else if (!initializer.provisionFromFile(provisionFile))
+            {
+                return 1;
+            }
+        }
 
         // Get available ATMs
         const auto &atms = initializer.getATMs();
+        for (const auto &atm : atms)
+        {
+            atm->setDispensePolicy(dispensePolicy);
+        }
         const auto &banks = initializer.getBanks();
+        const auto &accountDirectory = *initializer.getAccountDirectory();
+
+        // rebuild state from the journals, then checkpoint the recovered state
+        RecoveryManager recovery(JOURNAL_DIRECTORY, banks, atms);
+        if (recoverMode)
+        {
+            auto result = recovery.recover();
+            std::cout << ui.formatMessage(MessageId::RECOVERY_COMPLETE, result.restoredBalances, result.replayedRecords) << "\n";
+            for (TransactionId id : result.invalidRecords)
+            {
+                std::cout << ui.formatMessage(MessageId::RECOVERY_INVALID_RECORD, formatTransactionId(id)) << "\n";
+            }
+            if (!recovery.writeCheckpoint())
+            {
+                ui.displayMessage(MessageId::CHECKPOINT_FAILED);
+            }
+        }
+        // an image is saved right after a checkpoint, so it has applied
+        // exactly the records the checkpoint covers; any other start must
+        // not checkpoint over journaled records it never replayed
+        else if (recovery.hasUnappliedRecords(fromImage))
+        {
+            ui.displayMessage(MessageId::JOURNAL_NOT_RECOVERED);
+            return 1;
+        }
 
         bool programRunning = true;
 
@@ -294,17 +393,39 @@ int main()
             {
                 handleATMSelection(ui, atms, atmChoice);
 
-                if (atmChoice == "/")
+                if (!atmChoice.empty() && atmChoice[0] == '/')
+                {
+                    displaySnapshot(ui, atmChoice, atms, banks);
+                    continue;
+                }
+
+                if (atmChoice == "x" || atmChoice == "X")
                 {
-                    SystemSnapshot snapshot(atms, banks);
-                    snapshot.displaySnapshot();
+                    ExportOptions options;
+                    std::uint64_t rows = 0;
+                    if (ui.getExportOptions(options) && FleetExporter(atms).exportHistory(options, rows))
+                    {
+                        std::cout << ui.formatMessage(MessageId::FLEET_EXPORT_COMPLETE, rows, atms.size(), options.path) << "\n";
+                    }
+                    else
+                    {
+                        ui.displayMessage(MessageId::ERROR_SYSTEM);
+                    }
                     continue;
                 }
 
                 if (atmChoice == "q" || atmChoice == "Q")
                 {
                     programRunning = false;
-                    ui.displayMessage("GOODBYE");
+                    if (!recovery.writeCheckpoint())
+                    {
+                        ui.displayMessage(MessageId::CHECKPOINT_FAILED);
+                    }
+                    if (!imageFile.empty() && !initializer.saveImage(imageFile))
+                    {
+                        std::cout << ui.formatMessage(MessageId::IMAGE_SAVE_FAILED, imageFile) << "\n";
+                    }
+                    ui.displayMessage(MessageId::GOODBYE);
                     return 0;
                 }
 
@@ -313,7 +434,7 @@ int main()
                     int choice = std::stoi(atmChoice);
                     if (choice < 1 || choice > static_cast<int>(atms.size()))
                     {
-                        ui.displayMessage("INVALID_CHOICE");
+                        ui.displayMessage(MessageId::INVALID_CHOICE);
                         continue;
                     }
                     atmChoice = std::to_string(choice);
@@ -321,7 +442,7 @@ int main()
                 }
                 catch (...)
                 {
-                    ui.displayMessage("INVALID_CHOICE");
+                    ui.displayMessage(MessageId::INVALID_CHOICE);
                 }
             } while (true);
 
@@ -330,7 +451,7 @@ int main()
 
             if (selectedATM->getLanguageSupport() == LanguageSupport::BILINGUAL)
             {
-                ui.displayMessage("SELECT_LANGUAGE");
+                ui.displayMessage(MessageId::SELECT_LANGUAGE);
                 std::string langChoice;
                 bool validChoice = false;
 
@@ -346,12 +467,12 @@ int main()
                     }
                     else
                     {
-                        ui.displayMessage("INVALID_CHOICE");
+                        ui.displayMessage(MessageId::INVALID_CHOICE);
                     }
                 } while (!validChoice);
             }
 
-            ui.displayMessage("WELCOME");
+            ui.displayMessage(MessageId::WELCOME);
 
             // Card input + validation
             std::string cardNumber;
@@ -361,37 +482,32 @@ int main()
 
             do
             {
-                ui.showDisplayPanel("INSERT_CARD");
+                ui.showDisplayPanel(MessageId::INSERT_CARD);
                 cardNumber = ui.getInput();
                 if (cardNumber.length() != 12)
                 {
-                    ui.displayMessage("INVALID_CARD");
+                    ui.displayMessage(MessageId::INVALID_CARD);
                     continue;
                 }
 
                 if (selectedATM->isAdminCard(cardNumber))
                 {
-                    ui.displayMessage("ADMIN_DETECTED");
+                    ui.displayMessage(MessageId::ADMIN_DETECTED);
                     selectedATM->startSession(cardNumber, nullptr); // admin session
                     selectedATM->displayAdminMenu(ui);
                     break;
                 }
 
                 // find bank and account for card
-                for (const auto &bank : banks)
+                if (const auto *entry = accountDirectory.find(cardNumber))
                 {
-                    auto account = bank->getAccount(cardNumber);
-                    if (account)
-                    {
-                        cardBank = bank;
-                        userAccount = account;
-                        break;
-                    }
+                    cardBank = entry->account->getBank();
+                    userAccount = entry->account;
                 }
 
                 if (!userAccount)
                 {
-                    ui.displayMessage("INVALID_CARD");
+                    ui.displayMessage(MessageId::INVALID_CARD);
                     continue;
                 }
 
@@ -404,9 +520,7 @@ int main()
                     }
                     else
                     {
-                        std::string message = ui.getLocalizedMessage("SINGLE_BANK_ONLY");
-                        size_t pos = message.find("{}");
-                        message.replace(pos, 2, selectedATM->getPrimaryBank()->getName());
+                        std::string message = ui.formatMessage(MessageId::SINGLE_BANK_ONLY, selectedATM->getPrimaryBank()->getName());
                         std::cout << message << "\n";
                     }
                 }
@@ -426,12 +540,12 @@ int main()
             bool validPin = false;
             do
             {
-                ui.displayMessage("ENTER_PIN");
+                ui.displayMessage(MessageId::ENTER_PIN);
                 std::string pin = ui.getInput();
 
                 if (pin.length() != 4)
                 {
-                    ui.displayMessage("INVALID_PIN_FORMAT");
+                    ui.displayMessage(MessageId::INVALID_PIN_FORMAT);
                     pinAttempts++;
                 }
                 else
@@ -441,7 +555,7 @@ int main()
 
                 if (pinAttempts >= ATMSystem::ATM::MAX_PIN_ATTEMPTS)
                 {
-                    ui.displayMessage("CARD_RETAINED");
+                    ui.displayMessage(MessageId::CARD_RETAINED);
                     return 1;
                 }
             } while (!validPin && pinAttempts < ATMSystem::ATM::MAX_PIN_ATTEMPTS);
@@ -464,17 +578,15 @@ int main()
                 ui.displayMenu();
                 std::string choice = ui.getInput();
 
-                if (choice == "/")
+                if (!choice.empty() && choice[0] == '/')
                 {
-                    SystemSnapshot snapshot(atms, banks);
-                    snapshot.displaySnapshot();
+                    displaySnapshot(ui, choice, atms, banks);
                     continue;
                 }
 
-                if (choice.empty() || (choice[0] != '1' && choice[0] != '2' &&
-                                       choice[0] != '3' && choice[0] != '4'))
+                if (choice.empty() || choice[0] < '1' || choice[0] > '5')
                 {
-                    ui.displayMessage("INVALID_CHOICE");
+                    ui.displayMessage(MessageId::INVALID_CHOICE);
                     continue;
                 }
 
@@ -482,63 +594,58 @@ int main()
                 {
                 case '1': // Deposit
                 {
-                    ui.displayMessage("SELECT_DEPOSIT_TYPE");
+                    ui.displayMessage(MessageId::SELECT_DEPOSIT_TYPE);
                     std::string depositType = ui.getInput();
 
                     if (depositType != "1" && depositType != "2")
                     {
-                        ui.displayMessage("INVALID_CHOICE");
+                        ui.displayMessage(MessageId::INVALID_CHOICE);
                         continue;
                     }
 
                     if (depositType == "1")
                     { // Cash deposit
-                        ui.displayMessage("ENTER_CASH_DEPOSIT");
+                        ui.displayMessage(MessageId::ENTER_CASH_DEPOSIT);
                         auto cashInput = ui.getCashInput();
-                        int depositAmount = 0;
-                        for (const auto &[denom, count] : cashInput)
+                        Money depositAmount = cashTotal(cashInput);
+
+                        if (!depositAmount.isPositive())
                         {
-                            depositAmount += denom * count;
+                            ui.displayMessage(MessageId::INVALID_AMOUNT);
+                            continue;
                         }
 
-                        if (depositAmount <= 0)
+                        Money depositedAmount;
+                        Money fee;
+                        Money totalFeeInput;
+
+                        // the fee is settled before the deposit is applied and journaled
+                        std::map<int, int> feeInput;
+                        if (!handleDepositFee(ui, cardBank == selectedATM->getPrimaryBank(), feeInput, totalFeeInput))
                         {
-                            ui.displayMessage("INVALID_AMOUNT");
                             continue;
                         }
 
-                        int depositedAmount;
-                        int fee;
-                        int totalFeeInput = 0;
-
-                        // Calculate fee
                         if (selectedATM->deposit(cardNumber, depositAmount, true, depositedAmount, fee))
                         {
-                            if (!handleDepositFee(ui, selectedATM, cardBank == selectedATM->getPrimaryBank(), totalFeeInput))
-                            {
-                                userAccount->withdraw(depositAmount);
-                                continue;
-                            }
-
+                            selectedATM->addCash(feeInput);
                             selectedATM->addCash(cashInput);
-                            ui.displayMessage("DEPOSIT_SUCCESS");
-                            std::cout << ui.getLocalizedMessage("AMOUNT_DEPOSITED") << " " << formatCurrency(depositAmount) << "\n";
-                            std::cout << ui.getLocalizedMessage("FEE_LABEL") << " " << formatCurrency(fee) << "\n";
-                            std::cout << ui.getLocalizedMessage("NEW_BALANCE_LABEL") << " " << formatCurrency(userAccount->getBalance()) << "\n";
+                            ui.displayMessage(MessageId::DEPOSIT_SUCCESS);
+                            std::cout << ui.getLocalizedView(MessageId::AMOUNT_DEPOSITED) << " " << formatCurrency(depositAmount) << "\n";
+                            std::cout << ui.getLocalizedView(MessageId::FEE_LABEL) << " " << formatCurrency(fee) << "\n";
+                            std::cout << ui.getLocalizedView(MessageId::NEW_BALANCE_LABEL) << " " << formatCurrency(userAccount->getBalance()) << "\n";
 
-                            transactionLog.push_back(formatTransactionLog(ui, "CASH_DEPOSIT_TYPE", depositAmount, fee));
+                            transactionLog.push_back(formatTransactionLog(ui, MessageId::CASH_DEPOSIT_TYPE, depositAmount, fee));
                         }
                     }
                     else
                     { // Check deposit
                         int checkAmount;
-                        std::string checkPrompt = ui.getLocalizedMessage("CHECK_PROMPT");
-                        size_t pos = checkPrompt.find("{}");
-                        checkPrompt.replace(pos, 2, formatCurrency(MIN_CHECK_AMOUNT));
+                        std::string checkPrompt = ui.formatMessage(MessageId::CHECK_PROMPT, formatCurrency(Money(MIN_CHECK_AMOUNT)));
                         std::cout << checkPrompt;
                         if (!(std::cin >> checkAmount))
                         {
-                            ui.displayMessage("INVALID_CHECK_INPUT");
+                            ui.displayMessage(MessageId::INVALID_CHECK_INPUT);
                             std::cin.clear();
                             std::cin.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
                             continue;
@@ -547,61 +654,51 @@ int main()
 
                         if (checkAmount < MIN_CHECK_AMOUNT)
                         {
-                            std::string message = ui.getLocalizedMessage("INVALID_CHECK_AMOUNT");
-                            size_t pos = message.find("{}");
-                            message.replace(pos, 2, formatCurrency(MIN_CHECK_AMOUNT));
+                            std::string message = ui.formatMessage(MessageId::INVALID_CHECK_AMOUNT, formatCurrency(Money(MIN_CHECK_AMOUNT)));
                             std::cout << message << "\n";
                             continue;
                         }
 
-                        int depositedAmount;
-                        int fee;
+                        Money depositedAmount;
+                        Money fee;
 
                         // calculate fee
-                        if (selectedATM->deposit(cardNumber, checkAmount, false, depositedAmount, fee))
+                        if (selectedATM->deposit(cardNumber, Money(checkAmount), false, depositedAmount, fee))
                         {
-                            std::string feeMsg = ui.getLocalizedMessage("TRANSACTION_FEE");
-                            pos = feeMsg.find("{}");
-                            feeMsg.replace(pos, 2, formatCurrency(fee));
+                            std::string feeMsg = ui.formatMessage(MessageId::TRANSACTION_FEE, formatCurrency(fee));
                             std::cout << feeMsg << "\n";
-                            ui.displayMessage("ENTER_FEE_CASH");
+                            ui.displayMessage(MessageId::ENTER_FEE_CASH);
                             auto feeInput = ui.getCashInput();
-                            int totalFeeInput = 0;
-                            for (const auto &[denom, count] : feeInput)
-                            {
-                                totalFeeInput += denom * count;
-                            }
+                            Money totalFeeInput = cashTotal(feeInput);
 
                             if (totalFeeInput < fee)
                             {
-                                ui.displayMessage("INSUFFICIENT_FEE");
+                                ui.displayMessage(MessageId::INSUFFICIENT_FEE);
                                 continue;
                             }
 
                             if (totalFeeInput > fee)
                             {
-                                int change = totalFeeInput - fee;
-                                std::string changeMsg = ui.getLocalizedMessage("CHANGE_AMOUNT");
-                                size_t pos = changeMsg.find("{}");
-                                changeMsg.replace(pos, 2, formatCurrency(change));
+                                Money change = totalFeeInput - fee;
+                                std::string changeMsg = ui.formatMessage(MessageId::CHANGE_AMOUNT, formatCurrency(change));
                                 std::cout << changeMsg << "\n";
-                                ui.displayMessage("TAKE_CHANGE");
+                                ui.displayMessage(MessageId::TAKE_CHANGE);
                                 std::string response;
                                 std::getline(std::cin, response);
                                 if (response != "y" && response != "Y")
                                 {
-                                    ui.displayMessage("CANCEL_TRANSACTION");
+                                    ui.displayMessage(MessageId::CANCEL_TRANSACTION);
                                     continue;
                                 }
                             }
 
                             selectedATM->addCash(feeInput);
-                            ui.displayMessage("CHECK_DEPOSIT_SUCCESS");
-                            std::cout << ui.getLocalizedMessage("AMOUNT_DEPOSITED") << " " << formatCurrency(checkAmount) << "\n";
-                            std::cout << ui.getLocalizedMessage("FEE_LABEL") << " " << formatCurrency(fee) << "\n";
-                            std::cout << ui.getLocalizedMessage("NEW_BALANCE_LABEL") << " " << formatCurrency(userAccount->getBalance()) << "\n";
+                            ui.displayMessage(MessageId::CHECK_DEPOSIT_SUCCESS);
+                            std::cout << ui.getLocalizedView(MessageId::AMOUNT_DEPOSITED) << " " << formatCurrency(Money(checkAmount)) << "\n";
+                            std::cout << ui.getLocalizedView(MessageId::FEE_LABEL) << " " << formatCurrency(fee) << "\n";
+                            std::cout << ui.getLocalizedView(MessageId::NEW_BALANCE_LABEL) << " " << formatCurrency(userAccount->getBalance()) << "\n";
 
-                            transactionLog.push_back(formatTransactionLog(ui, "CHECK_DEPOSIT_TYPE", checkAmount, fee));
+                            transactionLog.push_back(formatTransactionLog(ui, MessageId::CHECK_DEPOSIT_TYPE, Money(checkAmount), fee));
                         }
                     }
                     break;
@@ -611,9 +708,7 @@ int main()
                 {
                     if (!selectedATM->getCurrentSession()->canWithdraw())
                     {
-                        std::string message = ui.getLocalizedMessage("WITHDRAWAL_MAX_REACHED");
-                        size_t pos = message.find("{}");
-                        message.replace(pos, 2, std::to_string(MAX_WITHDRAWALS_PER_SESSION));
+                        std::string message = ui.formatMessage(MessageId::WITHDRAWAL_MAX_REACHED, MAX_WITHDRAWALS_PER_SESSION);
                         std::cout << message << "\n";
                         continue;
                     }
@@ -624,10 +719,10 @@ int main()
                     if (!shouldContinue)
                         continue;
 
-                    int withdrawnAmount;
-                    int fee;
+                    Money withdrawnAmount;
+                    Money fee;
                     std::map<int, int> bills;
-                    if (!selectedATM->withdraw(cardNumber, amount, withdrawnAmount, fee, bills))
+                    if (!selectedATM->withdraw(cardNumber, Money(amount), withdrawnAmount, fee, bills))
                     {
 
                         // insufficient cash
@@ -639,12 +734,12 @@ int main()
                         continue;
                     }
 
-                    ui.displayMessage("WITHDRAWAL_SUCCESS");
+                    ui.displayMessage(MessageId::WITHDRAWAL_SUCCESS);
                     displayCashBreakdown(ui, bills);
-                    std::cout << ui.getLocalizedMessage("FEE_LABEL") << " " << formatCurrency(fee) << "\n";
-                    std::cout << ui.getLocalizedMessage("NEW_BALANCE_LABEL") << " " << formatCurrency(userAccount->getBalance()) << "\n";
+                    std::cout << ui.getLocalizedView(MessageId::FEE_LABEL) << " " << formatCurrency(fee) << "\n";
+                    std::cout << ui.getLocalizedView(MessageId::NEW_BALANCE_LABEL) << " " << formatCurrency(userAccount->getBalance()) << "\n";
 
-                    transactionLog.push_back(formatTransactionLog(ui, "WITHDRAWAL_TYPE", withdrawnAmount, fee));
+                    transactionLog.push_back(formatTransactionLog(ui, MessageId::WITHDRAWAL_TYPE, withdrawnAmount, fee));
                     break;
                 }
 
@@ -655,59 +750,46 @@ int main()
 
                     if (transferType != "1" && transferType != "2")
                     {
-                        ui.displayMessage("INVALID_CHOICE");
+                        ui.displayMessage(MessageId::INVALID_CHOICE);
                         continue;
                     }
 
-                    ui.displayMessage("TRANSFER_ACCOUNT");
+                    ui.displayMessage(MessageId::TRANSFER_ACCOUNT);
                     std::string destAccountNum = ui.getInput();
 
                     if (transferType == "1")
                     { // Cash transfer
-                        int transferAmount;
                         auto cashInput = ui.getCashInput();
+                        Money transferAmount = cashTotal(cashInput);
 
-                        for (const auto &[denom, count] : cashInput)
-                        {
-                            transferAmount += denom * count;
-                        }
-
-                        int transferredAmount;
-                        int fee;
+                        Money transferredAmount;
+                        Money fee;
 
                         fee = TransactionFees::TRANSFER_CASH;
-                        std::string feeMsg = ui.getLocalizedMessage("TRANSACTION_FEE");
-                        size_t pos = feeMsg.find("{}");
-                        feeMsg.replace(pos, 2, formatCurrency(fee));
+                        std::string feeMsg = ui.formatMessage(MessageId::TRANSACTION_FEE, formatCurrency(fee));
                         std::cout << feeMsg << "\n";
-                        ui.displayMessage("ENTER_FEE_CASH");
+                        ui.displayMessage(MessageId::ENTER_FEE_CASH);
                         auto feeInput = ui.getCashInput();
-                        int totalFeeInput = 0;
-                        for (const auto &[denom, count] : feeInput)
-                        {
-                            totalFeeInput += denom * count;
-                        }
+                        Money totalFeeInput = cashTotal(feeInput);
 
                         if (totalFeeInput < fee)
                         {
-                            ui.displayMessage("INSUFFICIENT_FEE");
+                            ui.displayMessage(MessageId::INSUFFICIENT_FEE);
                             continue;
                         }
 
                         // change if too much fee was provided
                         if (totalFeeInput > fee)
                         {
-                            int change = totalFeeInput - fee;
-                            std::string changeMsg = ui.getLocalizedMessage("CHANGE_AMOUNT");
-                            size_t pos = changeMsg.find("{}");
-                            changeMsg.replace(pos, 2, formatCurrency(change));
+                            Money change = totalFeeInput - fee;
+                            std::string changeMsg = ui.formatMessage(MessageId::CHANGE_AMOUNT, formatCurrency(change));
                             std::cout << changeMsg << "\n";
-                            ui.displayMessage("TAKE_CHANGE");
+                            ui.displayMessage(MessageId::TAKE_CHANGE);
                             std::string response;
                             std::getline(std::cin, response);
                             if (response != "y" && response != "Y")
                             {
-                                ui.displayMessage("CANCEL_TRANSACTION");
+                                ui.displayMessage(MessageId::CANCEL_TRANSACTION);
                                 continue;
                             }
                         }
@@ -717,42 +799,46 @@ int main()
                             // Add to ATM's inventory
                             selectedATM->addCash(cashInput);
                             selectedATM->addCash(feeInput);
-                            ui.displayMessage("CASH_TRANSFER_SUCCESS");
-                            std::cout << ui.getLocalizedMessage("AMOUNT_TRANSFERRED") << " " << formatCurrency(transferredAmount) << "\n";
-                            std::cout << ui.getLocalizedMessage("FEE_LABEL") << " " << formatCurrency(fee) << "\n";
+                            ui.displayMessage(MessageId::CASH_TRANSFER_SUCCESS);
+                            std::cout << ui.getLocalizedView(MessageId::AMOUNT_TRANSFERRED) << " " << formatCurrency(transferredAmount) << "\n";
+                            std::cout << ui.getLocalizedView(MessageId::FEE_LABEL) << " " << formatCurrency(fee) << "\n";
 
-                            transactionLog.push_back(formatTransactionLog(ui, "CASH_TRANSFER_TYPE", transferredAmount, fee, destAccountNum));
+                            transactionLog.push_back(formatTransactionLog(ui, MessageId::CASH_TRANSFER_TYPE, transferredAmount, fee, destAccountNum));
                         }
                     }
                     else
                     { // Account transfer
                         int amount;
-                        ui.displayMessage("TRANSFER_AMOUNT");
+                        ui.displayMessage(MessageId::TRANSFER_AMOUNT);
                         if (!(std::cin >> amount))
                         {
-                            ui.displayMessage("INVALID_AMOUNT");
+                            ui.displayMessage(MessageId::INVALID_AMOUNT);
                             std::cin.clear();
                             std::cin.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
                             continue;
                         }
                         std::cin.ignore();
 
-                        int transferredAmount;
-                        int fee;
-                        if (selectedATM->transfer(cardNumber, destAccountNum, amount, false, transferredAmount, fee))
+                        Money transferredAmount;
+                        Money fee;
+                        if (selectedATM->transfer(cardNumber, destAccountNum, Money(amount), false, transferredAmount, fee))
                         {
-                            ui.displayMessage("ACCOUNT_TRANSFER_SUCCESS");
-                            std::cout << ui.getLocalizedMessage("AMOUNT_TRANSFERRED") << " " << formatCurrency(transferredAmount) << "\n";
-                            std::cout << ui.getLocalizedMessage("FEE_LABEL") << " " << formatCurrency(fee) << "\n";
-                            std::cout << ui.getLocalizedMessage("NEW_BALANCE_LABEL") << " " << formatCurrency(userAccount->getBalance()) << "\n";
+                            ui.displayMessage(MessageId::ACCOUNT_TRANSFER_SUCCESS);
+                            std::cout << ui.getLocalizedView(MessageId::AMOUNT_TRANSFERRED) << " " << formatCurrency(transferredAmount) << "\n";
+                            std::cout << ui.getLocalizedView(MessageId::FEE_LABEL) << " " << formatCurrency(fee) << "\n";
+                            std::cout << ui.getLocalizedView(MessageId::NEW_BALANCE_LABEL) << " " << formatCurrency(userAccount->getBalance()) << "\n";
 
-                            transactionLog.push_back(formatTransactionLog(ui, "ACCOUNT_TRANSFER_TYPE", transferredAmount, fee, destAccountNum));
+                            transactionLog.push_back(formatTransactionLog(ui, MessageId::ACCOUNT_TRANSFER_TYPE, transferredAmount, fee, destAccountNum));
                         }
                     }
                     break;
                 }
 
-                case '4': // Exit
+                case '4': // Recent transactions
+                    selectedATM->printRecentTransactions(*userAccount);
+                    break;
+
+                case '5': // Exit
                     // transaction summary
                     if (!transactionLog.empty())
                     {
@@ -762,6 +848,10 @@ int main()
                                               ui);
                     }
                     selectedATM->endCurrentSession();
+                    if (!recovery.maybeCheckpoint())
+                    {
+                        ui.displayMessage(MessageId::CHECKPOINT_FAILED);
+                    }
                     displayHorizontalLine(60);
                     displayHorizontalLine(60);
                     std::cout << "\n\n\n";
@@ -769,7 +859,7 @@ int main()
                     break;
 
                 default:
-                    ui.displayMessage("INVALID_CHOICE");
+                    ui.displayMessage(MessageId::INVALID_CHOICE);
                 }
             }
         }
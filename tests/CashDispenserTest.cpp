@@ -0,0 +1,133 @@
+#include "TestSupport.hpp"
+#include "CashDispenser.hpp"
+#include <random>
+
+using namespace ATMSystem;
+
+namespace
+{
+    // fewest bills that make amount exactly, by exhaustive search; -1 if none
+    int fewestBills(std::int64_t amount, const CashCassettes::Counts &counts)
+    {
+        int best = -1;
+        for (int a = 0; a <= counts[0]; a++)
+        {
+            for (int b = 0; b <= counts[1]; b++)
+            {
+                for (int c = 0; c <= counts[2]; c++)
+                {
+                    for (int d = 0; d <= counts[3]; d++)
+                    {
+                        std::int64_t total = std::int64_t(a) * CASH_DENOMINATIONS[0] + std::int64_t(b) * CASH_DENOMINATIONS[1] +
+                                             std::int64_t(c) * CASH_DENOMINATIONS[2] + std::int64_t(d) * CASH_DENOMINATIONS[3];
+                        if (total == amount && (best < 0 || a + b + c + d < best))
+                        {
+                            best = a + b + c + d;
+                        }
+                    }
+                }
+            }
+        }
+        return best;
+    }
+
+    // the plan is within the cassettes and adds up to amount; returns its bill count
+    int checkPlan(const std::map<int, int> &plan, std::int64_t amount, const CashCassettes::Counts &counts)
+    {
+        std::int64_t total = 0;
+        int bills = 0;
+        for (const auto &[denomination, count] : plan)
+        {
+            auto slot = CashCassettes::slotOf(denomination);
+            CHECK(slot && count > 0 && count <= counts[*slot]);
+            total += std::int64_t(denomination) * count;
+            bills += count;
+        }
+        CHECK(total == amount);
+        return bills;
+    }
+
+    void testMatchesExhaustiveSearch()
+    {
+        CashDispenser dispenser;
+        std::mt19937 random(3);
+        for (int round = 0; round < 2000; round++)
+        {
+            CashCassettes::Counts counts;
+            for (auto &count : counts)
+            {
+                count = static_cast<int>(random() % 6);
+            }
+            std::int64_t amount = (random() % 120 + 1) * 1000;
+            int best = fewestBills(amount, counts);
+
+            for (auto policy : {DispensePolicy::MINIMIZE_BILLS, DispensePolicy::PRESERVE_SCARCE})
+            {
+                auto plan = dispenser.plan(Money(amount), counts, policy);
+                if (best < 0)
+                {
+                    CHECK(plan.empty());
+                    continue;
+                }
+                int bills = checkPlan(plan, amount, counts);
+                if (policy == DispensePolicy::MINIMIZE_BILLS)
+                {
+                    CHECK(bills == best);
+                }
+            }
+        }
+    }
+
+    void testExactChangeAndImpossibleAmounts()
+    {
+        CashDispenser dispenser;
+        // no 1000s at all; the plan must still use the bills that exist
+        CashCassettes::Counts counts{0, 4, 6, 1};
+        auto plan = dispenser.plan(Money(60000), counts, DispensePolicy::MINIMIZE_BILLS);
+        CHECK(checkPlan(plan, 60000, counts) == 2);
+        CHECK(plan[50000] == 1 && plan[10000] == 1);
+
+        CashCassettes::Counts noSmallBills{0, 0, 0, 3};
+        CHECK(dispenser.plan(Money(60000), noSmallBills, DispensePolicy::MINIMIZE_BILLS).empty());
+        CHECK(dispenser.plan(Money(1500), counts, DispensePolicy::MINIMIZE_BILLS).empty());
+        CHECK(dispenser.plan(Money(0), counts, DispensePolicy::MINIMIZE_BILLS).empty());
+    }
+
+    void testPreserveScarceSparesLowCassettes()
+    {
+        CashDispenser dispenser;
+        CashCassettes::Counts counts{100, 100, 100, 1};
+        auto plan = dispenser.plan(Money(60000), counts, DispensePolicy::PRESERVE_SCARCE);
+        checkPlan(plan, 60000, counts);
+        CHECK(plan.count(50000) == 0);
+    }
+
+    void testAmountsAboveTheTable()
+    {
+        CashDispenser dispenser;
+        CashCassettes::Counts counts{5, 5, 5, 20};
+        std::int64_t amount = CashDispenser::TABLE_LIMIT_WON + 230000;
+        auto plan = dispenser.plan(Money(amount), counts, DispensePolicy::MINIMIZE_BILLS);
+        CHECK(checkPlan(plan, amount, counts) == fewestBills(amount, counts));
+    }
+
+    void testTableFollowsCassetteChanges()
+    {
+        CashDispenser dispenser;
+        CashCassettes::Counts full{10, 10, 10, 10};
+        CashCassettes::Counts drained{10, 10, 10, 0};
+        CHECK(dispenser.plan(Money(100000), full, DispensePolicy::MINIMIZE_BILLS)[50000] == 2);
+        auto plan = dispenser.plan(Money(100000), drained, DispensePolicy::MINIMIZE_BILLS);
+        CHECK(plan.count(50000) == 0 && checkPlan(plan, 100000, drained) == 10);
+    }
+}
+
+int main()
+{
+    testMatchesExhaustiveSearch();
+    testExactChangeAndImpossibleAmounts();
+    testPreserveScarceSparesLowCassettes();
+    testAmountsAboveTheTable();
+    testTableFollowsCassetteChanges();
+    return ATMSystem::Test::failures;
+}
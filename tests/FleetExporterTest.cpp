@@ -0,0 +1,125 @@
+#include "TestSupport.hpp"
+#include "FleetExporter.hpp"
+#include <cstdio>
+#include <algorithm>
+
+using namespace ATMSystem;
+using ATMSystem::Test::TempDirectory;
+using ATMSystem::Test::WorkingDirectory;
+
+namespace
+{
+    // records in (timestamp, id) order; ids rise with construction time
+    std::vector<Transaction> makeRecords(size_t count, TransactionId firstId)
+    {
+        std::vector<Transaction> records;
+        for (size_t i = 0; i < count; i++)
+        {
+            records.emplace_back(firstId + i, 100000000000ULL, TransactionType::DEPOSIT, Money(1000));
+        }
+        return records;
+    }
+
+    void writeJournal(const std::string &serial, const std::vector<Transaction> &records)
+    {
+        TransactionJournal journal(JOURNAL_DIRECTORY, serial);
+        CHECK(journal.appendBatch(records.data(), records.size()));
+        CHECK(journal.sync());
+    }
+
+    // exports every ATM's journal in binary form; rows holds the records
+    bool exportFleet(const std::vector<std::string> &serials, const std::string &path, std::vector<Transaction> &rows)
+    {
+        auto bank = std::make_shared<Bank>("Alpha", std::make_shared<AccountDirectory>());
+        std::vector<std::shared_ptr<ATM>> atms;
+        for (const auto &serial : serials)
+        {
+            atms.push_back(std::make_shared<ATM>(serial, BankType::SINGLE_BANK, LanguageSupport::UNILINGUAL, bank));
+        }
+
+        ExportOptions options;
+        options.format = ExportFormat::BINARY;
+        options.path = path;
+        std::uint64_t count = 0;
+        bool exported = FleetExporter(atms).exportHistory(options, count);
+
+        rows.clear();
+        if (std::FILE *file = std::fopen(path.c_str(), "rb"))
+        {
+            char header[16];
+            Transaction transaction;
+            if (std::fread(header, sizeof(header), 1, file) == 1)
+            {
+                while (std::fread(&transaction, sizeof(transaction), 1, file) == 1)
+                {
+                    rows.push_back(transaction);
+                }
+            }
+            std::fclose(file);
+        }
+        CHECK(rows.size() == count);
+        return exported;
+    }
+
+    bool inOrder(const std::vector<Transaction> &rows)
+    {
+        for (size_t i = 1; i < rows.size(); i++)
+        {
+            if (rows[i].getTimestamp() < rows[i - 1].getTimestamp() ||
+                (rows[i].getTimestamp() == rows[i - 1].getTimestamp() &&
+                 rows[i].getTransactionId() < rows[i - 1].getTransactionId()))
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    void testSortsWithinTheWindow()
+    {
+        TempDirectory directory;
+        WorkingDirectory inside(directory.getPath());
+
+        // two ATMs whose records interleave in time; the first committed
+        // neighbouring records in swapped order
+        auto records = makeRecords(2000, 1);
+        std::vector<Transaction> first;
+        std::vector<Transaction> second;
+        for (size_t i = 0; i < records.size(); i++)
+        {
+            (i % 3 ? first : second).push_back(records[i]);
+        }
+        for (size_t i = 0; i + 1 < first.size(); i += 2)
+        {
+            std::swap(first[i], first[i + 1]);
+        }
+        writeJournal("000001", first);
+        writeJournal("000002", second);
+
+        std::vector<Transaction> rows;
+        CHECK(exportFleet({"000001", "000002"}, directory.file("fleet.bin"), rows));
+        CHECK(rows.size() == records.size());
+        CHECK(inOrder(rows));
+    }
+
+    void testFailsBeyondTheWindow()
+    {
+        TempDirectory directory;
+        WorkingDirectory inside(directory.getPath());
+
+        // the oldest record arrives after more records than the window holds
+        auto records = makeRecords(FleetExporter::REORDER_WINDOW + 10, 1);
+        std::rotate(records.begin(), records.begin() + 1, records.end());
+        writeJournal("000001", records);
+
+        std::vector<Transaction> rows;
+        CHECK(!exportFleet({"000001"}, directory.file("fleet.bin"), rows));
+    }
+}
+
+int main()
+{
+    testSortsWithinTheWindow();
+    testFailsBeyondTheWindow();
+    return ATMSystem::Test::failures;
+}
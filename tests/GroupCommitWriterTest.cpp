@@ -0,0 +1,173 @@
+#include "TestSupport.hpp"
+#include "GroupCommitWriter.hpp"
+#include <thread>
+#include <atomic>
+#include <algorithm>
+
+using namespace ATMSystem;
+using ATMSystem::Test::DescriptorExhaustion;
+using ATMSystem::Test::SyncFailure;
+using ATMSystem::Test::TempDirectory;
+
+namespace
+{
+    Transaction makeRecord(TransactionId id)
+    {
+        return Transaction(id, 100000000000ULL, TransactionType::DEPOSIT, Money(1000));
+    }
+
+    size_t countRecords(const TransactionJournal &journal)
+    {
+        size_t count = 0;
+        journal.forEach([&](const Transaction &)
+                        { count++; });
+        return count;
+    }
+
+    // ids in the journal, as its ATM and as a later recovery read them
+    std::vector<TransactionId> journaledIds(const TransactionJournal &journal, bool fromFiles)
+    {
+        std::vector<TransactionId> ids;
+        auto collect = [&](const Transaction &transaction)
+        {
+            ids.push_back(transaction.getTransactionId());
+        };
+        if (fromFiles)
+        {
+            TransactionJournal::scan(journal.getDirectory(), journal.getSerial(), JournalPosition{}, collect);
+        }
+        else
+        {
+            journal.forEach(collect);
+        }
+        std::sort(ids.begin(), ids.end());
+        return ids;
+    }
+
+    // Submits ids together so the writer can batch them, and returns the
+    // ids whose commit was reported durable
+    std::vector<TransactionId> commitTogether(GroupCommitWriter &writer, std::vector<TransactionId> ids)
+    {
+        std::vector<std::uint64_t> tickets;
+        for (TransactionId id : ids)
+        {
+            tickets.push_back(writer.submit(makeRecord(id)));
+        }
+        std::vector<TransactionId> committed;
+        for (size_t i = 0; i < ids.size(); i++)
+        {
+            if (writer.waitDurable(tickets[i]))
+            {
+                committed.push_back(ids[i]);
+            }
+        }
+        return committed;
+    }
+
+    void testFailedBatchDoesNotFailLaterOnes()
+    {
+        TempDirectory directory;
+        TransactionJournal journal(directory.getPath(), "000001", 2);
+        GroupCommitWriter writer(journal, GroupCommitConfig{1, std::chrono::microseconds(0)});
+
+        CHECK(writer.commit(makeRecord(1)));
+        CHECK(writer.commit(makeRecord(2)));
+        {
+            // the segment is full, and the next one cannot be opened
+            DescriptorExhaustion exhausted;
+            CHECK(!writer.commit(makeRecord(3)));
+        }
+        CHECK(writer.commit(makeRecord(4)));
+        CHECK(writer.commit(makeRecord(5)));
+        CHECK(countRecords(journal) == 4);
+    }
+
+    void testBatchAcrossSegmentsFailsWhole()
+    {
+        TempDirectory directory;
+        TransactionJournal journal(directory.getPath(), "000001", 2);
+        GroupCommitWriter writer(journal);
+
+        CHECK(writer.commit(makeRecord(1)));
+        std::vector<TransactionId> committed;
+        {
+            // one slot is left, and the segment after it cannot be opened
+            DescriptorExhaustion exhausted;
+            committed = commitTogether(writer, {2, 3, 4});
+        }
+        // exactly the records reported durable are in the journal
+        committed.insert(committed.begin(), 1);
+        CHECK(journaledIds(journal, false) == committed);
+        CHECK(journaledIds(journal, true) == committed);
+
+        CHECK(writer.commit(makeRecord(5)));
+        committed.push_back(5);
+        CHECK(journaledIds(journal, true) == committed);
+    }
+
+    void testFailedSyncLeavesNoRecords()
+    {
+        TempDirectory directory;
+        TransactionJournal journal(directory.getPath(), "000001", 2);
+        GroupCommitWriter writer(journal);
+
+        CHECK(writer.commit(makeRecord(1)));
+        {
+            SyncFailure failing(directory.getPath());
+            CHECK(commitTogether(writer, {2, 3, 4}).empty());
+        }
+        std::vector<TransactionId> expected{1};
+        CHECK(journaledIds(journal, false) == expected);
+        CHECK(journaledIds(journal, true) == expected);
+
+        CHECK(writer.commit(makeRecord(5)));
+        expected.push_back(5);
+        CHECK(journaledIds(journal, false) == expected);
+        CHECK(journaledIds(journal, true) == expected);
+    }
+
+    void testConcurrentCommitsAllSucceed()
+    {
+        constexpr int THREADS = 4;
+        constexpr int PER_THREAD = 200;
+
+        TempDirectory directory;
+        TransactionJournal journal(directory.getPath(), "000001", 64);
+        GroupCommitWriter writer(journal);
+
+        std::atomic<int> succeeded{0};
+        std::vector<std::thread> threads;
+        for (int t = 0; t < THREADS; t++)
+        {
+            threads.emplace_back([&, t]()
+                                 {
+                                     for (int i = 0; i < PER_THREAD; i++)
+                                     {
+                                         if (writer.commit(makeRecord(static_cast<TransactionId>(t * PER_THREAD + i + 1))))
+                                         {
+                                             succeeded++;
+                                         }
+                                     }
+                                 });
+        }
+        for (auto &thread : threads)
+        {
+            thread.join();
+        }
+
+        CHECK(succeeded == THREADS * PER_THREAD);
+        CHECK(countRecords(journal) == static_cast<size_t>(THREADS * PER_THREAD));
+        auto stats = writer.getStats();
+        CHECK(stats.commits == static_cast<std::uint64_t>(THREADS * PER_THREAD));
+        CHECK(stats.batches >= 1 && stats.batches <= stats.commits);
+    }
+}
+
+int main()
+{
+    testFailedBatchDoesNotFailLaterOnes();
+    testBatchAcrossSegmentsFailsWhole();
+    testFailedSyncLeavesNoRecords();
+    testConcurrentCommitsAllSucceed();
+    return ATMSystem::Test::failures;
+}
@@ -0,0 +1,105 @@
+#include "TestSupport.hpp"
+#include "NumberAllocator.hpp"
+#include <thread>
+#include <vector>
+
+using namespace ATMSystem;
+
+namespace
+{
+    void testEverySixDigitNumberOnce()
+    {
+        NumberAllocator allocator(6, 42);
+        CHECK(allocator.getCapacity() == 1000000);
+
+        std::vector<char> seen(allocator.getCapacity(), 0);
+        bool distinct = true;
+        for (std::uint64_t i = 0; i < allocator.getCapacity(); i++)
+        {
+            auto number = allocator.allocate();
+            if (!number || *number >= allocator.getCapacity() || seen[*number]++)
+            {
+                distinct = false;
+                break;
+            }
+        }
+        CHECK(distinct);
+        CHECK(!allocator.allocate());
+    }
+
+    void testSameKeySameSequence()
+    {
+        NumberAllocator first(12, 7);
+        NumberAllocator second(12, 7);
+        NumberAllocator other(12, 8);
+        bool same = true;
+        bool differs = false;
+        for (int i = 0; i < 100; i++)
+        {
+            auto a = first.allocate();
+            auto b = second.allocate();
+            same = same && a && b && *a == *b;
+            differs = differs || *a != *other.allocate();
+        }
+        CHECK(same);
+        CHECK(differs);
+        CHECK(first.format(42) == "000000000042");
+        CHECK(first.allocateString()->size() == 12);
+    }
+
+    void testRangesClaimOnlyWhatFits()
+    {
+        NumberAllocator allocator(2, 7);
+        CHECK(!allocator.allocateRange(101));
+        auto first = allocator.allocateRange(60);
+        CHECK(first && *first == 0);
+        CHECK(!allocator.allocateRange(41));
+        auto rest = allocator.allocateRange(40);
+        CHECK(rest && *rest == 60);
+        CHECK(!allocator.allocate());
+    }
+
+    void testConcurrentAllocationsAreDistinct()
+    {
+        constexpr int THREADS = 4;
+        constexpr int PER_THREAD = 25000;
+
+        NumberAllocator allocator(6, 3);
+        std::vector<std::vector<std::uint64_t>> results(THREADS);
+        std::vector<std::thread> threads;
+        for (int t = 0; t < THREADS; t++)
+        {
+            threads.emplace_back([&, t]()
+                                 {
+                                     for (int i = 0; i < PER_THREAD; i++)
+                                     {
+                                         results[t].push_back(*allocator.allocate());
+                                     }
+                                 });
+        }
+        for (auto &thread : threads)
+        {
+            thread.join();
+        }
+
+        std::vector<char> seen(allocator.getCapacity(), 0);
+        bool distinct = true;
+        for (const auto &numbers : results)
+        {
+            for (std::uint64_t number : numbers)
+            {
+                distinct = distinct && !seen[number]++;
+            }
+        }
+        CHECK(distinct);
+    }
+}
+
+int main()
+{
+    testEverySixDigitNumberOnce();
+    testSameKeySameSequence();
+    testRangesClaimOnlyWhatFits();
+    testConcurrentAllocationsAreDistinct();
+    return ATMSystem::Test::failures;
+}
@@ -0,0 +1,192 @@
+#include "TestSupport.hpp"
+#include "RecoveryManager.hpp"
+#include <limits>
+#include <thread>
+
+using namespace ATMSystem;
+using ATMSystem::Test::TempDirectory;
+
+namespace
+{
+    constexpr AccountKey ALICE = 111111111111ULL;
+    constexpr AccountKey BOB = 222222222222ULL;
+
+    struct Network
+    {
+        std::shared_ptr<AccountDirectory> directory = std::make_shared<AccountDirectory>();
+        std::vector<std::shared_ptr<Bank>> banks;
+        std::vector<std::shared_ptr<ATM>> atms;
+
+        // banks are created in the order given, each with one account
+        explicit Network(bool bobFirst = false)
+        {
+            auto alpha = std::make_shared<Bank>("Alpha", directory);
+            auto beta = std::make_shared<Bank>("Beta", directory);
+            alpha->createAccount("alice", "111111111111", "1234");
+            beta->createAccount("bob", "222222222222", "5678");
+            banks = bobFirst ? std::vector<std::shared_ptr<Bank>>{beta, alpha}
+                             : std::vector<std::shared_ptr<Bank>>{alpha, beta};
+        }
+
+        Money balanceOf(AccountKey key) const
+        {
+            const auto *entry = directory->find(key);
+            return entry ? entry->account->getBalance() : Money(-1);
+        }
+    };
+
+    void writeJournal(const std::string &directory, const std::vector<Transaction> &records)
+    {
+        TransactionJournal journal(directory, "000001", 2);
+        journal.appendBatch(records.data(), records.size());
+        journal.sync();
+    }
+
+    void testReplayAppliesEachSideOnce()
+    {
+        TempDirectory directory;
+        writeJournal(directory.getPath(), {
+                                              Transaction(1, ALICE, TransactionType::DEPOSIT, Money(5000)),
+                                              Transaction(2, ALICE, TransactionType::WITHDRAWAL, Money(1000), Money(500)),
+                                              Transaction(3, ALICE, TransactionType::TRANSFER_ACCOUNT, Money(2000), Money(100),
+                                                          TransactionChannel::ACCOUNT, BOB),
+                                              Transaction(4, ALICE, TransactionType::TRANSFER_CASH, Money(3000), Money(1000),
+                                                          TransactionChannel::CASH, BOB),
+                                          });
+
+        Network network;
+        RecoveryManager recovery(directory.getPath(), network.banks, network.atms);
+        auto result = recovery.recover();
+        CHECK(result.replayedRecords == 4);
+        CHECK(result.invalidRecords.empty());
+        CHECK(network.balanceOf(ALICE) == Money(5000 - 1500 - 2100));
+        CHECK(network.balanceOf(BOB) == Money(2000 + 3000));
+    }
+
+    void testOverflowingRecordIsReported()
+    {
+        TempDirectory directory;
+        writeJournal(directory.getPath(), {
+                                              Transaction(1, ALICE, TransactionType::DEPOSIT, Money(500)),
+                                              Transaction(2, ALICE, TransactionType::DEPOSIT,
+                                                          Money(std::numeric_limits<std::int64_t>::max())),
+                                              Transaction(3, BOB, TransactionType::DEPOSIT, Money(700)),
+                                          });
+
+        Network network;
+        RecoveryManager recovery(directory.getPath(), network.banks, network.atms);
+        auto result = recovery.recover();
+        CHECK(result.invalidRecords.size() == 1 && result.invalidRecords.front() == 2);
+        CHECK(network.balanceOf(ALICE) == Money(500));
+        CHECK(network.balanceOf(BOB) == Money(700));
+    }
+
+    void testCheckpointFollowsBankNames()
+    {
+        TempDirectory directory;
+        writeJournal(directory.getPath(), {
+                                              Transaction(1, ALICE, TransactionType::DEPOSIT, Money(4000)),
+                                              Transaction(2, BOB, TransactionType::DEPOSIT, Money(9000)),
+                                          });
+        {
+            Network network;
+            RecoveryManager recovery(directory.getPath(), network.banks, network.atms);
+            recovery.recover();
+            CHECK(recovery.writeCheckpoint());
+        }
+
+        // the same banks in the other order still get their own balances
+        Network reordered(true);
+        RecoveryManager recovery(directory.getPath(), reordered.banks, reordered.atms);
+        auto result = recovery.recover();
+        CHECK(result.restoredBalances == 2);
+        CHECK(result.replayedRecords == 0);
+        CHECK(reordered.balanceOf(ALICE) == Money(4000));
+        CHECK(reordered.balanceOf(BOB) == Money(9000));
+    }
+
+    void testMismatchedCheckpointIsIgnored()
+    {
+        TempDirectory directory;
+        writeJournal(directory.getPath(), {Transaction(1, ALICE, TransactionType::DEPOSIT, Money(4000))});
+        {
+            Network network;
+            RecoveryManager recovery(directory.getPath(), network.banks, network.atms);
+            recovery.recover();
+            CHECK(recovery.writeCheckpoint());
+        }
+
+        // a renamed bank drops the checkpoint; the journal is replayed whole
+        auto directoryIndex = std::make_shared<AccountDirectory>();
+        auto alpha = std::make_shared<Bank>("Alpha", directoryIndex);
+        auto gamma = std::make_shared<Bank>("Gamma", directoryIndex);
+        alpha->createAccount("alice", "111111111111", "1234");
+        std::vector<std::shared_ptr<Bank>> banks{alpha, gamma};
+        std::vector<std::shared_ptr<ATM>> atms;
+        RecoveryManager recovery(directory.getPath(), banks, atms);
+        auto result = recovery.recover();
+        CHECK(result.restoredBalances == 0);
+        CHECK(result.replayedRecords == 1);
+        CHECK(alpha->getAccount(ALICE)->getBalance() == Money(4000));
+    }
+
+    void testIdsContinuePastTheHighestSequence()
+    {
+        TempDirectory directory;
+        // a later second carrying a lower sequence, as another thread's block would
+        TransactionId highSequence = TransactionIdGenerator::makeId(100, 5000);
+        TransactionId laterSecond = TransactionIdGenerator::makeId(200, 7);
+        writeJournal(directory.getPath(), {
+                                              Transaction(highSequence, ALICE, TransactionType::DEPOSIT, Money(100)),
+                                              Transaction(laterSecond, ALICE, TransactionType::DEPOSIT, Money(100)),
+                                          });
+
+        Network network;
+        RecoveryManager recovery(directory.getPath(), network.banks, network.atms);
+        recovery.recover();
+
+        // a fresh thread claims a new block
+        TransactionId issued = 0;
+        std::thread([&]()
+                    { issued = TransactionIdGenerator::next(); })
+            .join();
+        CHECK(TransactionIdGenerator::sequenceOf(issued) > 5000);
+    }
+
+    void testUnappliedRecordsAreDetected()
+    {
+        TempDirectory directory;
+        {
+            Network network;
+            RecoveryManager recovery(directory.getPath(), network.banks, network.atms);
+            CHECK(!recovery.hasUnappliedRecords(false));
+        }
+
+        writeJournal(directory.getPath(), {Transaction(1, ALICE, TransactionType::DEPOSIT, Money(4000))});
+        Network network;
+        RecoveryManager recovery(directory.getPath(), network.banks, network.atms);
+        CHECK(recovery.hasUnappliedRecords(false));
+        CHECK(recovery.hasUnappliedRecords(true));
+
+        // a checkpoint covers the records for a state restored along with it,
+        // but never for a freshly built one
+        recovery.recover();
+        CHECK(recovery.writeCheckpoint());
+        CHECK(!recovery.hasUnappliedRecords(true));
+        CHECK(recovery.hasUnappliedRecords(false));
+
+        writeJournal(directory.getPath(), {Transaction(2, BOB, TransactionType::DEPOSIT, Money(9000))});
+        CHECK(recovery.hasUnappliedRecords(true));
+    }
+}
+
+int main()
+{
+    testReplayAppliesEachSideOnce();
+    testOverflowingRecordIsReported();
+    testCheckpointFollowsBankNames();
+    testMismatchedCheckpointIsIgnored();
+    testIdsContinuePastTheHighestSequence();
+    testUnappliedRecordsAreDetected();
+    return ATMSystem::Test::failures;
+}
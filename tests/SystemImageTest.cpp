@@ -0,0 +1,95 @@
+#include "TestSupport.hpp"
+#include "SystemImage.hpp"
+#include "Bank.hpp"
+#include "ATM.hpp"
+#include "TransactionHistoryStore.hpp"
+#include <cstdio>
+
+using namespace ATMSystem;
+using ATMSystem::Test::TempDirectory;
+using ATMSystem::Test::WorkingDirectory;
+
+namespace
+{
+    void testSaveOpenRoundTrip()
+    {
+        TempDirectory directory;
+        WorkingDirectory inside(directory.getPath());
+        std::map<int, int> cash{{1000, 3}, {5000, 4}, {10000, 5}, {50000, 6}};
+        {
+            auto accountDirectory = std::make_shared<AccountDirectory>();
+            auto alpha = std::make_shared<Bank>("Alpha", accountDirectory);
+            auto beta = std::make_shared<Bank>("Beta", accountDirectory);
+            CHECK(alpha->createAccount("alice", "111111111111", "1234"));
+            CHECK(alpha->createAccount("carol", "333333333333", "4321"));
+            CHECK(beta->createAccount("bob", "222222222222", "5678"));
+            CHECK(alpha->getAccount(111111111111ULL)->deposit(Money(70000)));
+
+            auto atm = std::make_shared<ATM>("000101", BankType::MULTI_BANK, LanguageSupport::BILINGUAL, alpha);
+            atm->addConnectedBank(beta);
+            CHECK(atm->addCash(cash));
+
+            std::vector<std::shared_ptr<Bank>> banks{alpha, beta};
+            std::vector<std::shared_ptr<ATM>> atms{atm};
+            CHECK(SystemImage::save(directory.file("system.img"), banks, atms));
+        }
+
+        auto image = SystemImage::open(directory.file("system.img"));
+        CHECK(image != nullptr);
+        if (!image)
+        {
+            return;
+        }
+        CHECK(image->getBankCount() == 2);
+        CHECK(image->getAccountCount() == 3);
+
+        auto accountDirectory = std::make_shared<AccountDirectory>();
+        std::vector<std::shared_ptr<Bank>> banks;
+        std::vector<std::shared_ptr<ATM>> atms;
+        image->restore(accountDirectory, std::make_shared<TransactionHistoryStore>(), banks, atms);
+        CHECK(banks.size() == 2 && atms.size() == 1);
+        if (banks.size() != 2 || atms.size() != 1)
+        {
+            return;
+        }
+
+        CHECK(banks[0]->getName() == "Alpha" && banks[1]->getName() == "Beta");
+        auto alice = banks[0]->getAccount(111111111111ULL);
+        CHECK(alice && alice->getUserName() == "alice" && alice->getPin() == "1234");
+        CHECK(alice && alice->getBalance() == Money(70000));
+        const auto *bob = accountDirectory->find(222222222222ULL);
+        CHECK(bob && bob->bank == banks[1].get() && bob->account->getPin() == "5678");
+
+        CHECK(atms[0]->getSerialNumber() == "000101");
+        CHECK(atms[0]->getBankType() == BankType::MULTI_BANK);
+        CHECK(atms[0]->getPrimaryBank() == banks[0]);
+        CHECK(atms[0]->getConnectedBanks().size() == 1);
+        CHECK(atms[0]->getCashInventory() == cash);
+
+        // numbers still unloaded in any bank's image slice stay taken
+        CHECK(!banks[1]->createAccount("mallory", "333333333333", "1111"));
+        CHECK(!banks[0]->createAccount("mallory", "222222222222", "1111"));
+        CHECK(banks[1]->createAccount("dave", "444444444444", "1111"));
+    }
+
+    void testRejectsForeignFiles()
+    {
+        TempDirectory directory;
+        CHECK(SystemImage::open(directory.file("missing.img")) == nullptr);
+
+        std::FILE *file = std::fopen(directory.file("garbage.img").c_str(), "wb");
+        if (file)
+        {
+            std::fputs("not an image, just some text that is long enough", file);
+            std::fclose(file);
+        }
+        CHECK(SystemImage::open(directory.file("garbage.img")) == nullptr);
+    }
+}
+
+int main()
+{
+    testSaveOpenRoundTrip();
+    testRejectsForeignFiles();
+    return ATMSystem::Test::failures;
+}
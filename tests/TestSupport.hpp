@@ -0,0 +1,173 @@
+#ifndef TEST_SUPPORT_HPP
+#define TEST_SUPPORT_HPP
+
+#include <iostream>
+#include <string>
+#include <filesystem>
+#include <vector>
+#include <algorithm>
+#include <cstdlib>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/resource.h>
+
+// Minimal checks for the test executables: a failed CHECK reports its
+// location and the test keeps going; main returns the failure count.
+namespace ATMSystem::Test
+{
+    inline int failures = 0;
+
+    inline void fail(const char *file, int line, const char *expression)
+    {
+        std::cerr << file << ":" << line << ": CHECK(" << expression << ") failed\n";
+        failures++;
+    }
+
+    // Fresh directory under the system temp directory, removed on scope exit
+    class TempDirectory
+    {
+    private:
+        std::string path;
+
+    public:
+        TempDirectory()
+        {
+            std::string pattern = (std::filesystem::temp_directory_path() / "atm-test-XXXXXX").string();
+            if (::mkdtemp(pattern.data()))
+            {
+                path = pattern;
+            }
+        }
+
+        ~TempDirectory()
+        {
+            std::error_code ignored;
+            std::filesystem::remove_all(path, ignored);
+        }
+
+        TempDirectory(const TempDirectory &) = delete;
+        TempDirectory &operator=(const TempDirectory &) = delete;
+
+        const std::string &getPath() const { return path; }
+        std::string file(const std::string &name) const { return path + "/" + name; }
+    };
+
+    // Makes path the working directory while alive; ATMs open their
+    // journals relative to it
+    class WorkingDirectory
+    {
+    private:
+        std::filesystem::path previous;
+
+    public:
+        explicit WorkingDirectory(const std::string &path) : previous(std::filesystem::current_path())
+        {
+            std::filesystem::current_path(path);
+        }
+        ~WorkingDirectory() { std::filesystem::current_path(previous); }
+
+        WorkingDirectory(const WorkingDirectory &) = delete;
+        WorkingDirectory &operator=(const WorkingDirectory &) = delete;
+    };
+
+    // Takes every free file descriptor while alive, so open() fails with
+    // EMFILE; used to make journal segment rotation fail on demand
+    class DescriptorExhaustion
+    {
+    private:
+        std::vector<int> descriptors;
+        rlimit saved{};
+
+    public:
+        DescriptorExhaustion()
+        {
+            ::getrlimit(RLIMIT_NOFILE, &saved);
+            rlimit lowered = saved;
+            lowered.rlim_cur = std::min<rlim_t>(saved.rlim_cur, 256);
+            ::setrlimit(RLIMIT_NOFILE, &lowered);
+            int fd;
+            while ((fd = ::open("/dev/null", O_RDONLY)) >= 0)
+            {
+                descriptors.push_back(fd);
+            }
+        }
+
+        ~DescriptorExhaustion()
+        {
+            for (int fd : descriptors)
+            {
+                ::close(fd);
+            }
+            ::setrlimit(RLIMIT_NOFILE, &saved);
+        }
+
+        DescriptorExhaustion(const DescriptorExhaustion &) = delete;
+        DescriptorExhaustion &operator=(const DescriptorExhaustion &) = delete;
+    };
+
+    // Points every descriptor open on a file in directory at /dev/null while
+    // alive, so fdatasync on them fails with EINVAL; mappings made through
+    // them stay valid. Used to make journal syncs fail on demand.
+    class SyncFailure
+    {
+    private:
+        std::vector<std::pair<int, int>> swapped; // descriptor, saved duplicate
+
+        static std::string targetOf(int fd)
+        {
+            std::error_code error;
+            auto target = std::filesystem::read_symlink("/proc/self/fd/" + std::to_string(fd), error);
+            return error ? std::string() : target.string();
+        }
+
+    public:
+        explicit SyncFailure(const std::string &directory)
+        {
+            std::string prefix = std::filesystem::canonical(directory).string() + "/";
+            std::vector<int> matching;
+            for (const auto &entry : std::filesystem::directory_iterator("/proc/self/fd"))
+            {
+                int fd = std::stoi(entry.path().filename().string());
+                if (targetOf(fd).compare(0, prefix.size(), prefix) == 0)
+                {
+                    matching.push_back(fd);
+                }
+            }
+
+            int null = ::open("/dev/null", O_RDONLY);
+            for (int fd : matching)
+            {
+                swapped.emplace_back(fd, ::dup(fd));
+                ::dup2(null, fd);
+            }
+            ::close(null);
+        }
+
+        ~SyncFailure()
+        {
+            // a descriptor the code under test closed meanwhile stays closed
+            for (const auto &[fd, saved] : swapped)
+            {
+                if (targetOf(fd) == "/dev/null")
+                {
+                    ::dup2(saved, fd);
+                }
+                ::close(saved);
+            }
+        }
+
+        SyncFailure(const SyncFailure &) = delete;
+        SyncFailure &operator=(const SyncFailure &) = delete;
+    };
+}
+
+#define CHECK(expression)                                                  \
+    do                                                                     \
+    {                                                                      \
+        if (!(expression))                                                 \
+        {                                                                  \
+            ::ATMSystem::Test::fail(__FILE__, __LINE__, #expression);      \
+        }                                                                  \
+    } while (false)
+
+#endif
@@ -0,0 +1,162 @@
+#include "TestSupport.hpp"
+#include "TransactionHistoryStore.hpp"
+#include "GroupCommitWriter.hpp"
+#include <algorithm>
+#include <atomic>
+#include <random>
+#include <thread>
+
+using namespace ATMSystem;
+using ATMSystem::Test::TempDirectory;
+
+namespace
+{
+    // records built in timestamp order, with a short pause now and then so
+    // the history spans distinct timestamps
+    std::vector<Transaction> makeRecords(size_t count, std::mt19937 &random)
+    {
+        std::vector<Transaction> records;
+        for (size_t i = 0; i < count; i++)
+        {
+            records.emplace_back(i + 1, random() % 20, static_cast<TransactionType>(random() % 4), Money(1000));
+            if (i % 500 == 0)
+            {
+                std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            }
+        }
+        return records;
+    }
+
+    // every query result matches a brute-force filter and comes out in
+    // timestamp order
+    void checkQueries(const TransactionHistoryStore &store, const std::vector<Transaction> &records, std::mt19937 &random)
+    {
+        for (int q = 0; q < 200; q++)
+        {
+            HistoryQuery query;
+            if (q % 2)
+            {
+                query.card = random() % 20;
+            }
+            if (q % 3)
+            {
+                query.type = static_cast<TransactionType>(random() % 4);
+            }
+            if (q % 5)
+            {
+                auto a = records[random() % records.size()].getTimestamp();
+                auto b = records[random() % records.size()].getTimestamp();
+                query.from = std::min(a, b);
+                query.to = std::max(a, b);
+            }
+
+            std::vector<TransactionId> expected;
+            for (const auto &transaction : records)
+            {
+                if ((!query.card || transaction.getCardNumber() == *query.card) &&
+                    (!query.type || transaction.getType() == *query.type) &&
+                    transaction.getTimestamp() >= query.from && transaction.getTimestamp() < query.to)
+                {
+                    expected.push_back(transaction.getTransactionId());
+                }
+            }
+
+            std::vector<TransactionId> found;
+            bool ordered = true;
+            auto previous = std::chrono::system_clock::time_point::min();
+            auto view = store.query(query);
+            for (const auto &transaction : view)
+            {
+                found.push_back(transaction.getTransactionId());
+                ordered = ordered && transaction.getTimestamp() >= previous;
+                previous = transaction.getTimestamp();
+            }
+            CHECK(ordered);
+            CHECK(view.size() == expected.size());
+            std::sort(expected.begin(), expected.end());
+            std::sort(found.begin(), found.end());
+            CHECK(found == expected);
+        }
+    }
+
+    void testOutOfOrderArrivals()
+    {
+        std::mt19937 random(1);
+        TempDirectory directory;
+        auto records = makeRecords(5000, random);
+
+        // concurrent ATMs commit a little out of timestamp order
+        auto arrivals = records;
+        for (size_t i = 0; i + 8 <= arrivals.size(); i += 8)
+        {
+            std::shuffle(arrivals.begin() + i, arrivals.begin() + i + 8, random);
+        }
+
+        TransactionHistoryStore store;
+        {
+            TransactionJournal journal(directory.getPath(), "000001", 256);
+            for (const auto &transaction : arrivals)
+            {
+                JournalPosition position;
+                CHECK(journal.appendBatch(&transaction, 1, &position));
+                CHECK(store.add(transaction, journal, position));
+            }
+            CHECK(store.size() == records.size());
+            checkQueries(store, records, random);
+        }
+
+        // a store rebuilt from the journals answers the same way
+        TransactionHistoryStore reloaded;
+        reloaded.loadJournals(directory.getPath());
+        CHECK(reloaded.size() == records.size());
+        checkQueries(reloaded, records, random);
+    }
+
+    void testConcurrentSessions()
+    {
+        constexpr size_t SESSIONS = 4;
+
+        std::mt19937 random(2);
+        TempDirectory directory;
+        auto records = makeRecords(4000, random);
+
+        // each record is indexed where the writer put it, whichever batch
+        // and session it came with
+        TransactionHistoryStore store;
+        TransactionJournal journal(directory.getPath(), "000001", 256);
+        {
+            GroupCommitWriter writer(journal);
+            std::atomic<size_t> failed{0};
+            std::vector<std::thread> sessions;
+            for (size_t s = 0; s < SESSIONS; s++)
+            {
+                sessions.emplace_back([&, s]()
+                                      {
+                                          for (size_t i = s; i < records.size(); i += SESSIONS)
+                                          {
+                                              JournalPosition position;
+                                              if (!writer.commit(records[i], &position) ||
+                                                  !store.add(records[i], journal, position))
+                                              {
+                                                  failed++;
+                                              }
+                                          }
+                                      });
+            }
+            for (auto &session : sessions)
+            {
+                session.join();
+            }
+            CHECK(failed == 0);
+        }
+        CHECK(store.size() == records.size());
+        checkQueries(store, records, random);
+    }
+}
+
+int main()
+{
+    testOutOfOrderArrivals();
+    testConcurrentSessions();
+    return ATMSystem::Test::failures;
+}
@@ -0,0 +1,207 @@
+#include "TestSupport.hpp"
+#include "TransactionJournal.hpp"
+#include <cstring>
+#include <vector>
+
+using namespace ATMSystem;
+using ATMSystem::Test::DescriptorExhaustion;
+using ATMSystem::Test::SyncFailure;
+using ATMSystem::Test::TempDirectory;
+
+namespace
+{
+    const std::string SERIAL = "000001";
+
+    std::vector<Transaction> makeRecords(size_t count)
+    {
+        std::vector<Transaction> records;
+        for (size_t i = 0; i < count; i++)
+        {
+            auto type = static_cast<TransactionType>(i % 4);
+            records.emplace_back(i + 1, 100000000000ULL + i % 7, type, Money(1000 * (i + 1)), Money(i % 3 * 500));
+        }
+        return records;
+    }
+
+    bool sameRecord(const Transaction &a, const Transaction &b)
+    {
+        return std::memcmp(&a, &b, sizeof(Transaction)) == 0;
+    }
+
+    std::vector<Transaction> readAll(const std::string &directory, JournalPosition from = {})
+    {
+        std::vector<Transaction> records;
+        TransactionJournal::scan(directory, SERIAL, from, [&](const Transaction &transaction)
+                                 { records.push_back(transaction); });
+        return records;
+    }
+
+    void testRoundTripAcrossSegments()
+    {
+        TempDirectory directory;
+        auto records = makeRecords(10);
+        {
+            TransactionJournal journal(directory.getPath(), SERIAL, 4);
+            CHECK(journal.isOpen());
+            CHECK(journal.appendBatch(records.data(), 7));
+            for (size_t i = 7; i < records.size(); i++)
+            {
+                CHECK(journal.append(records[i]));
+            }
+            CHECK(journal.sync());
+            CHECK(journal.getSegmentCount() == 3);
+
+            std::vector<Transaction> seen;
+            journal.forEach([&](const Transaction &transaction)
+                            { seen.push_back(transaction); });
+            CHECK(seen.size() == records.size());
+        }
+
+        auto reread = readAll(directory.getPath());
+        CHECK(reread.size() == records.size());
+        for (size_t i = 0; i < reread.size() && i < records.size(); i++)
+        {
+            CHECK(sameRecord(reread[i], records[i]));
+        }
+
+        // a reopened journal continues after the last record
+        {
+            TransactionJournal journal(directory.getPath(), SERIAL, 4);
+            CHECK(journal.append(records[0]));
+        }
+        CHECK(readAll(directory.getPath()).size() == records.size() + 1);
+    }
+
+    void testScanFromPosition()
+    {
+        TempDirectory directory;
+        auto records = makeRecords(9);
+        {
+            TransactionJournal journal(directory.getPath(), SERIAL, 4);
+            CHECK(journal.appendBatch(records.data(), records.size()));
+        }
+
+        JournalPosition end = TransactionJournal::endPosition(directory.getPath(), SERIAL);
+        CHECK(end.segment == 2 && end.record == 1);
+
+        auto tail = readAll(directory.getPath(), JournalPosition{1, 2});
+        CHECK(tail.size() == 3);
+        if (tail.size() == 3)
+        {
+            CHECK(sameRecord(tail.front(), records[6]));
+            CHECK(sameRecord(tail.back(), records[8]));
+        }
+        CHECK(readAll(directory.getPath(), end).empty());
+    }
+
+    void testCashSurvivesReopen()
+    {
+        TempDirectory directory;
+        std::map<int, int> cash{{1000, 5}, {5000, 4}, {10000, 3}, {50000, 2}};
+        auto records = makeRecords(5);
+        {
+            TransactionJournal journal(directory.getPath(), SERIAL, 4);
+            journal.recordCash(cash);
+            // the counts carry over into the segment a rotation opens
+            CHECK(journal.appendBatch(records.data(), records.size()));
+            CHECK(journal.sync());
+        }
+        TransactionJournal reopened(directory.getPath(), SERIAL, 4);
+        CHECK(reopened.getRecoveredCash() == cash);
+    }
+
+    void testRotationRetriesAfterFailure()
+    {
+        TempDirectory directory;
+        auto records = makeRecords(6);
+        TransactionJournal journal(directory.getPath(), SERIAL, 4);
+        CHECK(journal.appendBatch(records.data(), 4));
+        {
+            DescriptorExhaustion exhausted;
+            CHECK(!journal.append(records[4]));
+        }
+        CHECK(journal.isOpen());
+        CHECK(journal.append(records[4]));
+        CHECK(journal.append(records[5]));
+
+        auto reread = readAll(directory.getPath());
+        CHECK(reread.size() == records.size());
+        for (size_t i = 0; i < reread.size() && i < records.size(); i++)
+        {
+            CHECK(sameRecord(reread[i], records[i]));
+        }
+    }
+
+    void testBatchIsAllOrNothing()
+    {
+        TempDirectory directory;
+        auto records = makeRecords(9);
+        TransactionJournal journal(directory.getPath(), SERIAL, 4);
+        CHECK(journal.appendBatch(records.data(), 3));
+        CHECK(journal.sync());
+        {
+            // the batch needs two more segments and the first cannot be opened
+            DescriptorExhaustion exhausted;
+            CHECK(!journal.appendBatch(records.data() + 3, 6));
+        }
+        CHECK(readAll(directory.getPath()).size() == 3);
+        CHECK(journal.getSegmentCount() == 1);
+
+        CHECK(journal.appendBatch(records.data() + 3, 6));
+        CHECK(journal.sync());
+        auto reread = readAll(directory.getPath());
+        CHECK(reread.size() == records.size());
+        for (size_t i = 0; i < reread.size() && i < records.size(); i++)
+        {
+            CHECK(sameRecord(reread[i], records[i]));
+        }
+    }
+
+    void testFailedSyncTakesRecordsBack()
+    {
+        TempDirectory directory;
+        std::map<int, int> cash{{1000, 5}, {5000, 4}};
+        auto records = makeRecords(8);
+        TransactionJournal journal(directory.getPath(), SERIAL, 4);
+        CHECK(journal.appendBatch(records.data(), 3));
+        CHECK(journal.sync());
+
+        // this batch spills into a second segment before the sync fails
+        CHECK(journal.appendBatch(records.data() + 3, 3));
+        journal.recordCash(cash);
+        {
+            SyncFailure failing(directory.getPath());
+            CHECK(!journal.sync());
+        }
+
+        size_t seen = 0;
+        journal.forEach([&](const Transaction &)
+                        { seen++; });
+        CHECK(seen == 3);
+        CHECK(readAll(directory.getPath()).size() == 3);
+        CHECK(journal.getSegmentCount() == 1);
+        CHECK(TransactionJournal::endPosition(directory.getPath(), SERIAL).segment == 0);
+
+        CHECK(journal.appendBatch(records.data() + 6, 2));
+        CHECK(journal.sync());
+        auto reread = readAll(directory.getPath());
+        CHECK(reread.size() == 5);
+        if (reread.size() == 5)
+        {
+            CHECK(sameRecord(reread[3], records[6]));
+            CHECK(sameRecord(reread[4], records[7]));
+        }
+        CHECK(TransactionJournal(directory.getPath(), SERIAL, 4).getRecoveredCash() == cash);
+    }
+}
+
+int main()
+{
+    testRoundTripAcrossSegments();
+    testScanFromPosition();
+    testCashSurvivesReopen();
+    testRotationRetriesAfterFailure();
+    testBatchIsAllOrNothing();
+    testFailedSyncTakesRecordsBack();
+    return ATMSystem::Test::failures;
+}